@@ -0,0 +1,107 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+//runs a scenario file without a window or GPU, as fast as the machine allows, and writes the results as csv.
+//meant for regression runs on servers:
+//  RESBatch <scenario> [--output results.csv] [--duration <time>] [--threads <count>]
+//           [--restore <checkpoint>] [--checkpoint <checkpoint>] [--telemetry <path>]
+//a long run can be split into legs that each restore the checkpoint the last one wrote, and what-if runs can
+//all restore one warm checkpoint. --telemetry records every sub step, RESTelemetry turns the file into csv
+//(the options override the scenario's statements of the same name)
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "core/thread_pool.h"
+#include "simulation/scenario.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: RESBatch <scenario> [--output results.csv] [--duration <time>] [--threads <count>] "
+                     "[--restore <checkpoint>] [--checkpoint <checkpoint>] [--telemetry <path>]" << std::endl;
+        return 2;
+    }
+    std::string scenarioPath = argv[1];
+    std::string outputPath = "results.csv";
+    std::string restorePath, checkpointPath, telemetryPath;
+    double duration = -1.0;
+    int threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--output") == 0) {
+            outputPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--duration") == 0) {
+            duration = std::atof(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0) {
+            threadCount = std::max(std::atoi(argv[i + 1]), 1);
+        }
+        else if (std::strcmp(argv[i], "--restore") == 0) {
+            restorePath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--checkpoint") == 0) {
+            checkpointPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--telemetry") == 0) {
+            telemetryPath = argv[i + 1];
+        }
+        else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+
+    Scenario scenario;
+    std::string error;
+    if (!LoadScenario(scenarioPath, scenario, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (duration >= 0.0) {
+        scenario.duration = duration;
+    }
+    if (!restorePath.empty()) {
+        scenario.restorePath = restorePath;
+    }
+    if (!checkpointPath.empty()) {
+        scenario.checkpointPath = checkpointPath;
+    }
+    if (!telemetryPath.empty()) {
+        scenario.telemetryPath = telemetryPath;
+    }
+
+    std::ofstream output(outputPath);
+    if (!output.is_open()) {
+        std::cerr << "unable to write " << outputPath << std::endl;
+        return 1;
+    }
+
+    //a single thread runs without a pool, like the benchmark
+    ThreadPool threadPool(threadCount);
+    ScenarioResult result = RunScenario(scenario, threadCount > 1 ? &threadPool : nullptr, &output);
+    if (!result.error.empty()) {
+        std::cerr << result.error << std::endl;
+        return 1;
+    }
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s: %.4g s simulated in %.4g s (%.1fx real time), %d ticks, %zu pipes (%.0f%% awake, %.0f%% lumped)",
+                  scenarioPath.c_str(), result.simulatedTime, result.wallTime,
+                  result.simulatedTime / std::max(result.wallTime, 1e-9), result.ticks, scenario.layout.pipes.size(),
+                  100.0 * result.activePipeFraction, 100.0 * result.lumpedPipeFraction);
+    std::cout << line << std::endl;
+    if (!scenario.telemetryPath.empty()) {
+        std::snprintf(line, sizeof(line), "telemetry: %llu frames to %s, %llu dropped", result.telemetryFrames,
+                      scenario.telemetryPath.c_str(), result.droppedTelemetryFrames);
+        std::cout << line << std::endl;
+    }
+    return 0;
+}
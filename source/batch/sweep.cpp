@@ -0,0 +1,83 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+//runs the cases of a parameter sweep (see simulation/sweep.h) on every core and streams a summary line per case:
+//  RESSweep <sweep> [--output sweep.csv] [--threads <count>] [--cases <count>] [--seed <integer>]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "core/thread_pool.h"
+#include "simulation/sweep.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: RESSweep <sweep> [--output sweep.csv] [--threads <count>] [--cases <count>] [--seed <integer>]" << std::endl;
+        return 2;
+    }
+    std::string sweepPath = argv[1];
+    std::string outputPath = "sweep.csv";
+    int threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+    int caseCount = -1;
+    long long seed = -1;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--output") == 0) {
+            outputPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0) {
+            threadCount = std::max(std::atoi(argv[i + 1]), 1);
+        }
+        else if (std::strcmp(argv[i], "--cases") == 0) {
+            caseCount = std::atoi(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::atoll(argv[i + 1]);
+        }
+        else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+
+    Sweep sweep;
+    std::string error;
+    if (!LoadSweep(sweepPath, sweep, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (caseCount > 0) {
+        sweep.caseCount = caseCount;
+    }
+    if (seed >= 0) {
+        sweep.seed = (unsigned long long)seed;
+    }
+
+    std::ofstream output(outputPath);
+    if (!output.is_open()) {
+        std::cerr << "unable to write " << outputPath << std::endl;
+        return 1;
+    }
+
+    ThreadPool threadPool(threadCount);
+    auto start = std::chrono::steady_clock::now();
+    if (!RunSweep(sweep, threadCount > 1 ? &threadPool : nullptr, output, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s: %d cases of %zu parameters in %.4g s on %d threads",
+                  sweepPath.c_str(), sweep.caseCount, sweep.parameters.size(), wallTime, threadCount);
+    std::cout << line << std::endl;
+    return 0;
+}
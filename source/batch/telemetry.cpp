@@ -0,0 +1,97 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+//turns a telemetry file (see simulation/telemetry.h) into csv, all channels or the ones named:
+//  RESTelemetry <telemetry> [--output telemetry.csv] [--channels <name>,<name>,...] [--every <frames>]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "simulation/telemetry.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: RESTelemetry <telemetry> [--output telemetry.csv] [--channels <name>,<name>,...] [--every <frames>]" << std::endl;
+        return 2;
+    }
+    std::string telemetryPath = argv[1];
+    std::string outputPath = "telemetry.csv";
+    std::string channelList;
+    int every = 1;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--output") == 0) {
+            outputPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--channels") == 0) {
+            channelList = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--every") == 0) {
+            every = std::max(std::atoi(argv[i + 1]), 1);
+        }
+        else {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+
+    TelemetryData data;
+    std::string error;
+    if (!LoadTelemetry(telemetryPath, data, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::vector<int> columns;
+    if (channelList.empty()) {
+        for (int c = 0; c < (int)data.channels.size(); c++) {
+            columns.push_back(c);
+        }
+    }
+    std::istringstream names(channelList);
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        auto found = std::find(data.channels.begin(), data.channels.end(), name);
+        if (found == data.channels.end()) {
+            std::cerr << "no channel " << name << " in " << telemetryPath << std::endl;
+            return 1;
+        }
+        columns.push_back((int)(found - data.channels.begin()));
+    }
+
+    std::ofstream output(outputPath);
+    if (!output.is_open()) {
+        std::cerr << "unable to write " << outputPath << std::endl;
+        return 1;
+    }
+    output.precision(9);
+    output << "time";
+    for (int c : columns) {
+        output << "," << data.channels[c];
+    }
+    output << "\n";
+    for (size_t f = 0; f < data.times.size(); f += every) {
+        output << data.times[f];
+        for (int c : columns) {
+            output << "," << data.values[c][f];
+        }
+        output << "\n";
+    }
+
+    std::ifstream file(telemetryPath, std::ios::binary | std::ios::ate);
+    double rawSize = (double)data.times.size() * (sizeof(double) + data.channels.size() * sizeof(float));
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s: %zu frames of %zu channels, %.3g s to %.3g s, %.1fx smaller than raw",
+                  telemetryPath.c_str(), data.times.size(), data.channels.size(), data.times.empty() ? 0.0 : data.times.front(),
+                  data.times.empty() ? 0.0 : data.times.back(), rawSize / std::max((double)file.tellg(), 1.0));
+    std::cout << line << std::endl;
+    return 0;
+}
@@ -0,0 +1,607 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+//headless throughput and accuracy benchmark of the gas solver. every problem is run to its end time at each
+//resolution, scheme and thread count, and the results are written as JSON (one result per line) so a later run
+//can be checked against a stored baseline:
+//
+//  RESBenchmark [--resolutions 200,800,3200] [--threads 1,8] [--block-size 1024] [--reference 6400]
+//               [--output results.json] [--baseline baseline.json] [--tolerance 0.01]
+//
+//the schemes cover every stepping path of the solver, plain, temporally blocked and implicit. many short pipes
+//are also stepped as one GasEnsemble and as separate simulations, their resolution is the total. the block size is
+//the smallest block a thread is handed, resolutions below it run on one thread whatever the thread count.
+//a baseline check fails (exit code 1) when the error of a matching run grows by more than the tolerance
+//(relative) or when a run allocates at all after its first step. timings are only reported, they are too
+//noisy to gate on
+//
+//  RESBenchmark --convergence [--resolutions 50,100,200]
+//
+//only prints the convergence report of every reconstruction against the exact sod solution (validation.h)
+//
+//  RESBenchmark --network [--scenario resources/scenarios/pump_fed_engine.txt]
+//
+//only runs the network checks (validation.h) and fails when one does not hold. the steady state and the quasi
+//steady blowdown are checked against transient runs of the scenario (relative to the working directory, like
+//the other resources), and so is a run whose state was carried into a recompiled simulation
+//
+//  RESBenchmark --adaptive [--resolutions 50,100,200]
+//
+//only runs the adaptive sod check (validation.h) on those base resolutions and fails when it does not hold, the
+//error has to fall with every refinement level and the mass may not drift across the refinement boundaries
+//
+//  RESBenchmark --ensemble [--threads 1,8]
+//
+//only runs the ensemble check (validation.h), alone and on a pool of the largest thread count, and fails when a
+//lane does not match its separate simulation bit for bit
+//
+//  RESBenchmark --check-allocations [--threads 1,8]
+//
+//only steps every scheme on a short sod run, alone and on a pool of the largest thread count, and fails when
+//any step after the first allocates
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/thread_pool.h"
+#include "simulation/exact_riemann.h"
+#include "simulation/validation.h"
+
+//every heap allocation of the process goes through here, so allocations per step can be counted
+static std::atomic<long long> s_allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+//open ends, so the waves of the test problems leave the domain instead of reflecting back into it
+using BenchmarkSimulation = BasicGasSimulation<float, HLLFlux, TransmissiveBoundary>;
+
+struct Problem {
+    const char* name;
+    RiemannState left;
+    RiemannState right;
+    double endTime;
+    bool exact;     //riemann problem on [0, 1] with the discontinuity at 0.5, otherwise shu-osher on [-5, 5]
+};
+
+struct Scheme {
+    const char* name;
+    Reconstruction reconstruction;
+    TimeIntegration timeIntegration;
+    bool tabulatedGas;      //the same gamma 1.4 gas through an equation of state table, what a real gas costs
+    float CFL;
+    int blockedSteps;       //fixed steps taken this many at a time through StepBlocked, 0 for plain CFL stepping
+};
+
+static GasPropertyTable<float> s_gasTable;
+
+struct BenchmarkResult {
+    std::string problem;
+    std::string scheme;
+    int resolution = 0;
+    int threads = 0;
+    int steps = 0;
+    double seconds = 0.0;
+    double cellsPerSecond = 0.0;
+    double nsPerCellUpdate = 0.0;
+    double allocationsPerStep = 0.0;
+    double l1Error = 0.0;
+};
+
+static void SetInitialState(BenchmarkSimulation& simulation, const Problem& problem) {
+    int n = simulation.GetResolution();
+    if (problem.exact) {
+        for (int i = 0; i < n; i++) {
+            const RiemannState& state = i < n / 2 ? problem.left : problem.right;
+            simulation.SetState(i, (float)state.density, (float)state.velocity, (float)state.pressure);
+        }
+        return;
+    }
+
+    //shu-osher, a mach 3 shock running into a density sine wave
+    for (int i = 0; i < n; i++) {
+        simulation.sizes[i] = 10.0f / (float)n;
+        double x = -5.0 + 10.0 * (i + 0.5) / n;
+        if (x < -4.0) {
+            simulation.SetState(i, 3.857143f, 2.629369f, 10.33333f);
+        }
+        else {
+            simulation.SetState(i, (float)(1.0 + 0.2 * std::sin(5.0 * x)), 0.0f, 1.0f);
+        }
+    }
+}
+
+static void Configure(BenchmarkSimulation& simulation, const Scheme& scheme, ThreadPool* threadPool, int minimumBlockSize) {
+    simulation.SetReconstruction(scheme.reconstruction);
+    simulation.timeIntegration = scheme.timeIntegration;
+    simulation.CFL = scheme.CFL;
+    simulation.SetThreadPool(threadPool);
+    simulation.minimumBlockSize = minimumBlockSize;
+    simulation.equationOfState = scheme.tabulatedGas ? &s_gasTable : nullptr;
+}
+
+//returns the heap allocations made by every call but the first, which sizes the scratch of the scheme
+static long long RunToEndTime(BenchmarkSimulation& simulation, double endTime, int& steps, int blockedSteps = 0) {
+    //blocked runs need a fixed step up front. the test problems never get much faster than they start out,
+    //half the first CFL step leaves room for the shocks they form
+    float dt = blockedSteps > 0 ? 0.5f * simulation.ComputeTimeStep() : 0.0f;
+
+    steps = 0;
+    long long allocations = 0;
+    bool first = true;
+    while (simulation.time < (float)endTime) {
+        long long before = s_allocationCount.load();
+        float remaining = (float)endTime - simulation.time;
+        if (blockedSteps > 0) {
+            int count = std::min(blockedSteps, std::max((int)std::ceil(remaining / dt), 1));
+            simulation.StepBlocked(std::min(dt, remaining / (float)count), count);
+            steps += count;
+        }
+        else {
+            simulation.maxTimeStep = remaining;
+            simulation.Step();
+            steps++;
+        }
+        if (!first) {
+            allocations += s_allocationCount.load() - before;
+        }
+        first = false;
+    }
+    return allocations;
+}
+
+//the shu-osher problem has no closed form solution, it is compared to a fine run of the most accurate scheme
+static double ComputeL1ReferenceError(const BenchmarkSimulation& simulation, const BenchmarkSimulation& reference) {
+    int n = simulation.GetResolution();
+    int referenceResolution = reference.GetResolution();
+    double error = 0.0;
+    for (int i = 1; i < n - 1; i++) {
+        double center = (i + 0.5) / n;
+        int referenceIndex = std::min((int)(center * referenceResolution), referenceResolution - 1);
+        error += std::abs((double)simulation.density[i] - (double)reference.density[referenceIndex]) * simulation.sizes[i];
+    }
+    return error;
+}
+
+static BenchmarkResult RunBenchmark(const Problem& problem, const Scheme& scheme, int resolution, ThreadPool* threadPool,
+                                    int minimumBlockSize, const BenchmarkSimulation* reference) {
+    BenchmarkSimulation simulation(resolution);
+    Configure(simulation, scheme, threadPool, minimumBlockSize);
+    SetInitialState(simulation, problem);
+
+    BenchmarkResult result;
+    result.problem = problem.name;
+    result.scheme = scheme.name;
+    result.resolution = resolution;
+    result.threads = threadPool != nullptr ? threadPool->GetThreadCount() : 1;
+
+    auto start = std::chrono::steady_clock::now();
+    long long allocations = RunToEndTime(simulation, problem.endTime, result.steps, scheme.blockedSteps);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double cellUpdates = (double)resolution * result.steps;
+    result.cellsPerSecond = cellUpdates / result.seconds;
+    result.nsPerCellUpdate = result.seconds * 1e9 / cellUpdates;
+    result.allocationsPerStep = (double)allocations / std::max(result.steps - 1, 1);
+
+    if (problem.exact) {
+        ExactRiemannSolver exact(problem.left, problem.right, simulation.gamma);
+        result.l1Error = ComputeL1DensityError(simulation, exact);
+    }
+    else {
+        result.l1Error = ComputeL1ReferenceError(simulation, *reference);
+    }
+    return result;
+}
+
+//a sod tube in each of many short pipes, stepped as one ensemble or as separate simulations (a pipe per task on
+//the pool), the case the ensemble is for. both take the same CFL steps, so the error of the first pipe has to be
+//the same for both
+static BenchmarkResult RunPipesBenchmark(bool ensemble, int pipeCount, int pipeResolution, ThreadPool* threadPool, double endTime = 0.2) {
+    using Ensemble = BasicGasEnsemble<float, HLLFlux, TransmissiveBoundary>;
+    Ensemble pipes(ensemble ? pipeCount : 0, pipeResolution);
+    std::vector<BenchmarkSimulation> simulations;
+    if (ensemble) {
+        pipes.SetThreadPool(threadPool);
+        for (int k = 0; k < pipeCount; k++) {
+            for (int i = 0; i < pipeResolution; i++) {
+                bool left = i < pipeResolution / 2;
+                pipes.SetState(k, i, left ? 1.0f : 0.125f, 0.0f, left ? 1.0f : 0.1f);
+            }
+        }
+    }
+    else {
+        simulations.reserve(pipeCount);
+        for (int k = 0; k < pipeCount; k++) {
+            simulations.emplace_back(pipeResolution);
+        }
+    }
+
+    BenchmarkResult result;
+    result.problem = "pipes";
+    result.scheme = ensemble ? "ensemble" : "separate";
+    result.resolution = pipeCount * pipeResolution;
+    result.threads = threadPool != nullptr ? threadPool->GetThreadCount() : 1;
+
+    auto stepSeparate = [&](int k) { simulations[k].Step(); };
+    long long allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    while ((ensemble ? pipes.GetTime(0) : simulations[0].time) < (float)endTime) {
+        long long before = s_allocationCount.load();
+        if (ensemble) {
+            pipes.Step();
+        }
+        else if (threadPool != nullptr) {
+            threadPool->ParallelFor(pipeCount, stepSeparate);
+        }
+        else {
+            for (int k = 0; k < pipeCount; k++) {
+                stepSeparate(k);
+            }
+        }
+        if (result.steps++ > 0) {
+            allocations += s_allocationCount.load() - before;
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double cellUpdates = (double)result.resolution * result.steps;
+    result.cellsPerSecond = cellUpdates / result.seconds;
+    result.nsPerCellUpdate = result.seconds * 1e9 / cellUpdates;
+    result.allocationsPerStep = (double)allocations / std::max(result.steps - 1, 1);
+
+    ExactRiemannSolver exact({1.0, 0.0, 1.0}, {0.125, 0.0, 0.1}, 1.4);
+    if (ensemble) {
+        double size = 1.0 / pipeResolution;
+        for (int i = 1; i < pipeResolution - 1; i++) {
+            double center = (i + 0.5) * size;
+            result.l1Error += std::abs((double)pipes.GetDensity(0, i) - exact.Sample((center - 0.5) / pipes.GetTime(0)).density) * size;
+        }
+    }
+    else {
+        result.l1Error = ComputeL1DensityError(simulations[0], exact);
+    }
+    return result;
+}
+
+static void PrintResult(const BenchmarkResult& result) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-10s %-12s %7d regions %3d threads  %8.3f ns/cell  %10.4g cells/s  %5.2f allocs/step  L1 %.4e",
+                  result.problem.c_str(), result.scheme.c_str(), result.resolution, result.threads,
+                  result.nsPerCellUpdate, result.cellsPerSecond, result.allocationsPerStep, result.l1Error);
+    std::cout << line << std::endl;
+}
+
+static std::string FormatResult(const BenchmarkResult& result) {
+    char line[512];
+    std::snprintf(line, sizeof(line),
+                  "{\"problem\": \"%s\", \"scheme\": \"%s\", \"resolution\": %d, \"threads\": %d, \"steps\": %d, "
+                  "\"seconds\": %.6g, \"cellsPerSecond\": %.6g, \"nsPerCellUpdate\": %.6g, "
+                  "\"allocationsPerStep\": %.6g, \"l1Error\": %.9g}",
+                  result.problem.c_str(), result.scheme.c_str(), result.resolution, result.threads, result.steps,
+                  result.seconds, result.cellsPerSecond, result.nsPerCellUpdate, result.allocationsPerStep, result.l1Error);
+    return line;
+}
+
+static std::string FindString(const std::string& line, const char* key) {
+    std::string pattern = std::string("\"") + key + "\": \"";
+    size_t begin = line.find(pattern);
+    if (begin == std::string::npos) {
+        return "";
+    }
+    begin += pattern.size();
+    return line.substr(begin, line.find('"', begin) - begin);
+}
+
+static double FindNumber(const std::string& line, const char* key) {
+    std::string pattern = std::string("\"") + key + "\": ";
+    size_t begin = line.find(pattern);
+    if (begin == std::string::npos) {
+        return 0.0;
+    }
+    return std::strtod(line.c_str() + begin + pattern.size(), nullptr);
+}
+
+//reads back the results of an earlier run, this only understands the one-result-per-line layout written below
+static std::vector<BenchmarkResult> ReadResults(const std::string& path) {
+    std::vector<BenchmarkResult> results;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find("\"problem\"") == std::string::npos) {
+            continue;
+        }
+        BenchmarkResult result;
+        result.problem = FindString(line, "problem");
+        result.scheme = FindString(line, "scheme");
+        result.resolution = (int)FindNumber(line, "resolution");
+        result.threads = (int)FindNumber(line, "threads");
+        result.steps = (int)FindNumber(line, "steps");
+        result.seconds = FindNumber(line, "seconds");
+        result.cellsPerSecond = FindNumber(line, "cellsPerSecond");
+        result.nsPerCellUpdate = FindNumber(line, "nsPerCellUpdate");
+        result.allocationsPerStep = FindNumber(line, "allocationsPerStep");
+        result.l1Error = FindNumber(line, "l1Error");
+        results.push_back(result);
+    }
+    return results;
+}
+
+static bool CompareToBaseline(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline, double tolerance) {
+    bool passed = true;
+    std::cout << std::endl << "against baseline" << std::endl;
+    for (const BenchmarkResult& result : results) {
+        for (const BenchmarkResult& previous : baseline) {
+            if (previous.problem != result.problem || previous.scheme != result.scheme ||
+                previous.resolution != result.resolution || previous.threads != result.threads) {
+                continue;
+            }
+
+            bool errorRegressed = result.l1Error > previous.l1Error * (1.0 + tolerance) + 1e-12;
+            //stepping never allocates, whatever the baseline recorded
+            bool allocationsRegressed = result.allocationsPerStep != 0.0;
+            passed = passed && !errorRegressed && !allocationsRegressed;
+
+            char line[256];
+            std::snprintf(line, sizeof(line), "  %-10s %-12s %7d regions %3d threads  speedup %6.2fx  error %+.2e%s%s",
+                          result.problem.c_str(), result.scheme.c_str(), result.resolution, result.threads,
+                          previous.nsPerCellUpdate / result.nsPerCellUpdate, result.l1Error - previous.l1Error,
+                          errorRegressed ? "  ERROR REGRESSED" : "", allocationsRegressed ? "  ALLOCATES" : "");
+            std::cout << line << std::endl;
+        }
+    }
+    return passed;
+}
+
+//every scheme at a single block and at one block per thread, the stepping must not touch the heap at all once
+//the first step has sized its scratch
+static bool CheckAllocations(const Problem& problem, const Scheme* schemes, int schemeCount, ThreadPool& threadPool) {
+    bool passed = true;
+    for (int s = 0; s < schemeCount; s++) {
+        for (ThreadPool* pool : {(ThreadPool*)nullptr, &threadPool}) {
+            BenchmarkSimulation simulation(4096);
+            Configure(simulation, schemes[s], pool, 256);
+            SetInitialState(simulation, problem);
+
+            int steps;
+            long long allocations = RunToEndTime(simulation, 0.02, steps, schemes[s].blockedSteps);
+            passed = passed && allocations == 0;
+
+            char line[256];
+            std::snprintf(line, sizeof(line), "%-12s %3d threads  %4d steps  %lld allocations%s", schemes[s].name,
+                          pool != nullptr ? pool->GetThreadCount() : 1, steps, allocations, allocations != 0 ? "  ALLOCATES" : "");
+            std::cout << line << std::endl;
+        }
+    }
+    return passed;
+}
+
+static std::vector<int> ParseList(const char* text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string value;
+    while (std::getline(stream, value, ',')) {
+        values.push_back(std::atoi(value.c_str()));
+    }
+    return values;
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> resolutions = {200, 800, 3200, 12800};
+    std::vector<int> threadCounts = {1, (int)std::max(1u, std::thread::hardware_concurrency())};
+    int referenceResolution = 6400;
+    //far below the editor's default, so the thread count axis splits the benchmark resolutions into blocks
+    int minimumBlockSize = 1024;
+    std::string outputPath = "benchmark.json";
+    std::string baselinePath;
+    std::string scenarioPath = "resources/scenarios/pump_fed_engine.txt";
+    double tolerance = 0.01;
+
+    bool resolutionsGiven = false;
+    bool convergence = false;
+    bool network = false;
+    bool adaptive = false;
+    bool ensemble = false;
+    bool checkAllocations = false;
+
+    for (int i = 1; i < argc; i++) {
+        //switches first, every other option takes a value
+        if (std::strcmp(argv[i], "--convergence") == 0) {
+            convergence = true;
+            continue;
+        }
+        if (std::strcmp(argv[i], "--network") == 0) {
+            network = true;
+            continue;
+        }
+        if (std::strcmp(argv[i], "--adaptive") == 0) {
+            adaptive = true;
+            continue;
+        }
+        if (std::strcmp(argv[i], "--ensemble") == 0) {
+            ensemble = true;
+            continue;
+        }
+        if (std::strcmp(argv[i], "--check-allocations") == 0) {
+            checkAllocations = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "missing value of " << argv[i] << std::endl;
+            return 2;
+        }
+        const char* option = argv[i++];
+        if (std::strcmp(option, "--resolutions") == 0) {
+            resolutions = ParseList(argv[i]);
+            resolutionsGiven = true;
+        }
+        else if (std::strcmp(option, "--threads") == 0) {
+            threadCounts = ParseList(argv[i]);
+        }
+        else if (std::strcmp(option, "--block-size") == 0) {
+            minimumBlockSize = std::max(std::atoi(argv[i]), 1);
+        }
+        else if (std::strcmp(option, "--reference") == 0) {
+            referenceResolution = std::atoi(argv[i]);
+        }
+        else if (std::strcmp(option, "--output") == 0) {
+            outputPath = argv[i];
+        }
+        else if (std::strcmp(option, "--baseline") == 0) {
+            baselinePath = argv[i];
+        }
+        else if (std::strcmp(option, "--tolerance") == 0) {
+            tolerance = std::atof(argv[i]);
+        }
+        else if (std::strcmp(option, "--scenario") == 0) {
+            scenarioPath = argv[i];
+        }
+        else {
+            std::cerr << "unknown option " << option << std::endl;
+            return 2;
+        }
+    }
+
+    if (convergence) {
+        if (resolutionsGiven) {
+            PrintSodConvergenceReport(std::cout, resolutions);
+        }
+        else {
+            PrintSodConvergenceReport(std::cout);
+        }
+        return 0;
+    }
+
+    if (network) {
+        bool passed = CheckPlenumFlow(std::cout);
+        passed = CheckPumpOutlet(std::cout) && passed;
+        passed = CheckSteadyAgainstTransient(std::cout, scenarioPath) && passed;
+        passed = CheckBlowdownAgainstTransient(std::cout, scenarioPath) && passed;
+        passed = CheckCarriedState(std::cout, scenarioPath) && passed;
+        return passed ? 0 : 1;
+    }
+
+    if (adaptive) {
+        bool passed = resolutionsGiven ? CheckAdaptiveSod(std::cout, resolutions) : CheckAdaptiveSod(std::cout);
+        return passed ? 0 : 1;
+    }
+
+    if (ensemble) {
+        ThreadPool threadPool(std::max(threadCounts.back(), 2));
+        bool passed = CheckEnsembleAgainstSimulations(std::cout);
+        passed = CheckEnsembleAgainstSimulations(std::cout, 13, 40, 200, &threadPool) && passed;
+        return passed ? 0 : 1;
+    }
+
+    //Toro's test problems 1 (sod), 2 (123) and the lax shock tube
+    Problem problems[] = {
+        {"sod", {1.0, 0.0, 1.0}, {0.125, 0.0, 0.1}, 0.2, true},
+        {"lax", {0.445, 0.698, 3.528}, {0.5, 0.0, 0.571}, 0.14, true},
+        {"123", {1.0, -2.0, 0.4}, {1.0, 2.0, 0.4}, 0.15, true},
+        {"shu-osher", {}, {}, 1.8, false},
+    };
+    Scheme schemes[] = {
+        {"first-order", PIECEWISE_CONSTANT, FORWARD_EULER, false, 0.9f, 0},
+        {"muscl-rk2", MUSCL_VAN_LEER, SSP_RK2, false, 0.9f, 0},
+        {"tabulated", MUSCL_VAN_LEER, SSP_RK2, true, 0.9f, 0},
+        {"blocked", MUSCL_VAN_LEER, SSP_RK2, false, 0.9f, 8},
+        {"implicit", PIECEWISE_CONSTANT, BACKWARD_EULER, false, 5.0f, 0},
+    };
+    s_gasTable.Build(GasModel());
+
+    if (checkAllocations) {
+        ThreadPool threadPool(std::max(threadCounts.back(), 2));
+        return CheckAllocations(problems[0], schemes, (int)std::size(schemes), threadPool) ? 0 : 1;
+    }
+
+    BenchmarkSimulation reference(referenceResolution);
+    reference.SetReconstruction(MUSCL_MC);
+    reference.timeIntegration = SSP_RK2;
+    SetInitialState(reference, problems[3]);
+    int referenceSteps;
+    RunToEndTime(reference, problems[3].endTime, referenceSteps);
+
+    std::vector<BenchmarkResult> results;
+    for (int threadCount : threadCounts) {
+        //a single thread runs without a pool, like the editor does
+        ThreadPool threadPool(std::max(threadCount, 1));
+        ThreadPool* pool = threadCount > 1 ? &threadPool : nullptr;
+
+        for (const Problem& problem : problems) {
+            for (const Scheme& scheme : schemes) {
+                for (int resolution : resolutions) {
+                    BenchmarkResult result = RunBenchmark(problem, scheme, resolution, pool, minimumBlockSize, &reference);
+                    PrintResult(result);
+                    results.push_back(result);
+                }
+            }
+        }
+
+        for (bool ensemble : {false, true}) {
+            BenchmarkResult result = RunPipesBenchmark(ensemble, 4096, 32, pool);
+            PrintResult(result);
+            results.push_back(result);
+        }
+    }
+
+    std::ofstream output(outputPath);
+    output << "{" << std::endl;
+    output << "  \"shuOsherReferenceResolution\": " << referenceResolution << "," << std::endl;
+    output << "  \"minimumBlockSize\": " << minimumBlockSize << "," << std::endl;
+    output << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        output << "    " << FormatResult(results[i]) << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    output << "  ]" << std::endl;
+    output << "}" << std::endl;
+    std::cout << "results written to " << outputPath << std::endl;
+
+    if (!baselinePath.empty()) {
+        std::vector<BenchmarkResult> baseline = ReadResults(baselinePath);
+        if (baseline.empty()) {
+            std::cerr << "no results in baseline " << baselinePath << std::endl;
+            return 1;
+        }
+        return CompareToBaseline(results, baseline, tolerance) ? 0 : 1;
+    }
+    return 0;
+}
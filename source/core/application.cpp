@@ -76,9 +76,9 @@ void Application::Run() {
 
         MoveCamera();
 
-        //drawing
+        //drawing. the simulation steps on its own thread, this hands it the edits and picks up its latest state
         m_graphicsPipeline->UpdateGeometry(m_scene);
-        m_simulationPipeline->StepSimulation(m_scene);
+        m_simulationPipeline->SynchronizeScene(m_scene);
         m_graphicsPipeline->RenderScene(m_scene);
         m_graphicsPipeline->DrawUI(m_scene);
 
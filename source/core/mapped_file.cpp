@@ -0,0 +1,155 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool MappedFile::OpenRead(const std::string& path) {
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (unsigned char*)data;
+    m_size = (size_t)size.QuadPart;
+    m_writable = false;
+    return true;
+}
+
+bool MappedFile::Create(const std::string& path, size_t size) {
+    Close();
+    if (size == 0) {
+        return false;
+    }
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    //mapping past the end of the file grows it to the mapping's size
+    unsigned long long size64 = size;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(size64 >> 32), (DWORD)size64, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+    if (data == nullptr) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (unsigned char*)data;
+    m_size = size;
+    m_writable = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) {
+        if (m_writable) {
+            FlushViewOfFile(m_data, 0);
+            FlushFileBuffers(m_file);
+        }
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_file = nullptr;
+    m_mapping = nullptr;
+}
+
+#else
+
+bool MappedFile::OpenRead(const std::string& path) {
+    Close();
+    int file = open(path.c_str(), O_RDONLY);
+    if (file == -1) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+    if (data == MAP_FAILED) {
+        close(file);
+        return false;
+    }
+    m_file = file;
+    m_data = (unsigned char*)data;
+    m_size = (size_t)status.st_size;
+    m_writable = false;
+    return true;
+}
+
+bool MappedFile::Create(const std::string& path, size_t size) {
+    Close();
+    if (size == 0) {
+        return false;
+    }
+    int file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file == -1) {
+        return false;
+    }
+    if (ftruncate(file, (off_t)size) != 0) {
+        close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (data == MAP_FAILED) {
+        close(file);
+        return false;
+    }
+    m_file = file;
+    m_data = (unsigned char*)data;
+    m_size = size;
+    m_writable = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) {
+        if (m_writable) {
+            msync(m_data, m_size, MS_SYNC);
+        }
+        munmap(m_data, m_size);
+        close(m_file);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_file = -1;
+}
+
+#endif
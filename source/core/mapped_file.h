@@ -0,0 +1,46 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+#endif //MAPPED_FILE_H
+
+//a whole file mapped into memory, so large binary files are read and written with plain memory copies and the
+//operating system pages them in and out. read only, or created at a fixed size for writing
+class MappedFile {
+    unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_writable = false;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool OpenRead(const std::string& path);
+
+    //replaces whatever is at the path with a file of the size, zero filled. empty files cannot be mapped
+    bool Create(const std::string& path, size_t size);
+
+    //writes a writable mapping back to disk before unmapping it
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    size_t GetSize() const { return m_size; }
+    const unsigned char* GetData() const { return m_data; }
+    unsigned char* GetWritableData() { return m_writable ? m_data : nullptr; }
+};
@@ -0,0 +1,50 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+#endif //SPSC_QUEUE_H
+
+//bounded queue from one producer thread to one consumer thread, without locks. each index is only written by
+//its own side, so a push or pop is one acquire load of the other side's index and one release store of its
+//own. the indices run freely and wrap around the power of two capacity
+template<typename T, unsigned int Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "the capacity of an SpscQueue must be a power of two");
+
+    T m_items[Capacity];
+
+    //on their own cache lines, so the two threads do not keep stealing each other's line
+    alignas(64) std::atomic<unsigned int> m_head = 0;  //next item to pop, written by the consumer
+    alignas(64) std::atomic<unsigned int> m_tail = 0;  //next free slot, written by the producer
+
+public:
+    //producer side. false when the queue is full, the item is then left untouched
+    bool TryPush(T&& item) {
+        unsigned int tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_items[tail & (Capacity - 1)] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //consumer side. false when the queue is empty
+    bool TryPop(T& item) {
+        unsigned int head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(m_items[head & (Capacity - 1)]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
@@ -0,0 +1,98 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "thread_pool.h"
+
+//the pool the thread is running tasks of and its index in that pool
+static thread_local const ThreadPool* s_threadPool = nullptr;
+static thread_local int s_threadIndex = 0;
+
+ThreadPool::ThreadPool(int threadCount) {
+    for (int i = 1; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+int ThreadPool::GetCurrentThreadIndex() const {
+    return s_threadPool == this ? s_threadIndex : 0;
+}
+
+void ThreadPool::RunTasks() {
+    for (int i = m_nextTask.fetch_add(1); i < m_taskCount; i = m_nextTask.fetch_add(1)) {
+        m_invoke(m_context, i);
+    }
+}
+
+void ThreadPool::WorkerLoop(int index) {
+    s_threadPool = this;
+    s_threadIndex = index;
+    unsigned long long seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) {
+                return;
+            }
+            seenGeneration = m_generation;
+            m_activeWorkers++;
+        }
+
+        RunTasks();
+
+        std::lock_guard lock(m_mutex);
+        if (--m_activeWorkers == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::Dispatch(int count, void (*invoke)(const void* context, int index), const void* context) {
+    //the caller is thread 0 of this pool until the job is done, even when it is a worker of another pool
+    const ThreadPool* callerPool = s_threadPool;
+    int callerIndex = s_threadIndex;
+    s_threadPool = this;
+    s_threadIndex = 0;
+
+    //not worth waking anyone for a single task
+    if (m_workers.empty() || count <= 1) {
+        for (int i = 0; i < count; i++) {
+            invoke(context, i);
+        }
+        s_threadPool = callerPool;
+        s_threadIndex = callerIndex;
+        return;
+    }
+
+    {
+        //a worker that woke too late for the previous job may still be on its way out
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [&] { return m_activeWorkers == 0; });
+        m_invoke = invoke;
+        m_context = context;
+        m_taskCount = count;
+        m_nextTask = 0;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    RunTasks();
+
+    //wait for stragglers, workers that woke late find no tasks left and leave straight away
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [&] { return m_activeWorkers == 0 && m_nextTask >= m_taskCount; });
+    s_threadPool = callerPool;
+    s_threadIndex = callerIndex;
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
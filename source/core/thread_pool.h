@@ -0,0 +1,56 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#endif //THREAD_POOL_H
+
+//persistent workers for data parallel loops. the calling thread takes part in every job, so a pool of
+//n threads keeps n - 1 workers parked on a condition variable between jobs
+class ThreadPool {
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    //current job, type erased by hand so dispatching never allocates
+    void (*m_invoke)(const void* context, int index) = nullptr;
+    const void* m_context = nullptr;
+    int m_taskCount = 0;
+    std::atomic<int> m_nextTask = 0;
+    int m_activeWorkers = 0;
+    unsigned long long m_generation = 0;
+    bool m_stopping = false;
+
+    void WorkerLoop(int index);
+    void RunTasks();
+    void Dispatch(int count, void (*invoke)(const void* context, int index), const void* context);
+
+public:
+    ThreadPool(int threadCount = std::thread::hardware_concurrency());
+
+    int GetThreadCount() const { return (int)m_workers.size() + 1; }
+
+    //0 on the thread that calls ParallelFor, 1 to GetThreadCount() - 1 on the workers. lets tasks pick per
+    //thread scratch space without locking. the index is relative to this pool, a worker of another pool that
+    //calls this one's ParallelFor is 0 for the length of the call
+    int GetCurrentThreadIndex() const;
+
+    //runs task(i) for every i in [0, count) and returns once all of them have finished
+    template<typename Task>
+    void ParallelFor(int count, const Task& task) {
+        Dispatch(count, [](const void* context, int index) { (*static_cast<const Task*>(context))(index); }, &task);
+    }
+
+    ~ThreadPool();
+};
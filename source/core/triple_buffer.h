@@ -0,0 +1,44 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+#endif //TRIPLE_BUFFER_H
+
+//hands the latest state from one writer thread to one reader thread without locks. the writer fills the back
+//buffer and swaps it with the middle one, the reader swaps its front buffer with the middle one when that
+//holds something newer. neither side ever waits on the other, the reader simply keeps the last state it took
+//when the writer is slow, and states the reader had no time for are overwritten
+template<typename T>
+class TripleBuffer {
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4;     //set on the middle index when the writer published it after the reader's last take
+
+    T m_buffers[3];
+    std::atomic<int> m_middle = 1;
+    int m_back = 0;     //writer only
+    int m_front = 2;    //reader only
+
+public:
+    //writer side
+    T& GetWriteBuffer() { return m_buffers[m_back]; }
+    void Publish() {
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    //reader side, takes the latest published buffer. false when nothing was published since the last take
+    bool Acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& GetReadBuffer() const { return m_buffers[m_front]; }
+};
@@ -101,6 +101,8 @@ struct Control {
     int bevelNumber = 0;
     int connectedSimulationObjectType = 0;
     float controlPointPressure = 0.0f;
+    //connection point of the model an end of the path is snapped to, -1 when it is on none
+    int connectionPointIndex = -1;
 
     Control(glm::vec3 position) : position(position) {};
     int GetNumBeveledVertices();
@@ -200,9 +200,9 @@ void GraphicsPipeline::ClearSelection(Scene* scene) {
 }
 
 void GraphicsPipeline::DrawGasSimulation(GasSimulation gasSimulation, Camera camera) {
-    for (int i = 0; i < gasSimulation.regions.size(); i++) {
-        float velocityMag = gasSimulation.regions[i].velocity;
-        glm::vec3 color = glm::vec3(0.0f, gasSimulation.regions[i].energy, 0.0f); // simple direct map
+    for (int i = 0; i < gasSimulation.GetResolution(); i++) {
+        float velocityMag = gasSimulation.velocity[i];
+        glm::vec3 color = glm::vec3(0.0f, gasSimulation.energy[i], 0.0f); // simple direct map
         DrawDebugSphere3D(glm::vec3(i / 10.0f, 0, 0), 0.3f, color, camera);
     }
 }
@@ -479,6 +479,7 @@ void GraphicsPipeline::UpdateGeometry(Scene* scene) {
 
     if (m_currentSelectedControlIndex != -1) {
         if (Input::mouseButtonStates[GLFW_MOUSE_BUTTON_1] == GLFW_PRESS) {
+            scene->pipes[m_currentSelectedPipeIndex]->path.controls[m_currentSelectedControlIndex].connectionPointIndex = -1;
             if (Input::keyStates[GLFW_KEY_LEFT_SHIFT] != GLFW_RELEASE || Input::keyStates[GLFW_KEY_LEFT_CONTROL] != GLFW_RELEASE) {
                 scene->pipes[m_currentSelectedPipeIndex]->path.controls[m_currentSelectedControlIndex].position = m_origin + (delta * m_axis);
             }
@@ -490,6 +491,7 @@ void GraphicsPipeline::UpdateGeometry(Scene* scene) {
             if (connectionPointIndex != -1 && (m_currentSelectedControlIndex == 0 || m_currentSelectedControlIndex == scene->pipes[m_currentSelectedPipeIndex]->path.controls.size()-1)) {
                 if (connectionPointIndex != -1) {
                     scene->pipes[m_currentSelectedPipeIndex]->path.controls[m_currentSelectedControlIndex].position = connectionPoint;
+                    scene->pipes[m_currentSelectedPipeIndex]->path.controls[m_currentSelectedControlIndex].connectionPointIndex = connectionPointIndex;
                     connectedSimulationObjectModel->connectedControls.push_back(&scene->pipes[m_currentSelectedPipeIndex]->path.controls[m_currentSelectedControlIndex]);
                 }
                 else {
@@ -0,0 +1,283 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "adaptive_gas_simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+template<typename Real, typename Flux, typename Boundary>
+BasicAdaptiveGasSimulation<Real, Flux, Boundary>::BasicAdaptiveGasSimulation(int baseResolution, int maxLevel) : maxLevel(maxLevel)
+{
+    m_baseSize = Real(1) / Real(baseResolution);
+    long long width = 1ll << maxLevel;
+
+    for (int i = 0; i < baseResolution; i++) {
+        sizes.push_back(m_baseSize);
+        levels.push_back(0);
+        m_origins.push_back(i * width);
+        density.push_back(0);
+        momentum.push_back(0);
+        energy.push_back(0);
+        velocity.push_back(0);
+        pressure.push_back(0);
+
+        if (i < baseResolution / 2) {
+            SetState(i, Real(1.0), Real(0.0), Real(1.0));
+        }
+        else {
+            SetState(i, Real(0.125), Real(0.0), Real(0.1));
+        }
+    }
+
+    //one refinement pass per level so the initial discontinuity starts at the finest level
+    for (int level = 0; level < maxLevel; level++) {
+        Refine();
+    }
+    UpdatePrimatives();
+}
+
+template<typename Real, typename Flux, typename Boundary>
+int BasicAdaptiveGasSimulation<Real, Flux, Boundary>::GetFinestLevel() const {
+    return *std::max_element(levels.begin(), levels.end());
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicAdaptiveGasSimulation<Real, Flux, Boundary>::GetTotalMass() const {
+    Real mass = 0;
+    for (int i = 1; i < GetResolution() - 1; i++) {
+        mass += density[i] * sizes[i];
+    }
+    return mass;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::SetState(int regionIndex, Real density, Real velocity, Real pressure) {
+    this->density[regionIndex] = density;
+    this->velocity[regionIndex] = velocity;
+    this->pressure[regionIndex] = pressure;
+    this->momentum[regionIndex] = density * velocity;
+    this->energy[regionIndex] = pressure / (gamma - Real(1)) + Real(0.5) * density * velocity * velocity;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::UpdatePrimatives() {
+    for (int i = 0; i < GetResolution(); i++) {
+        Real rho = density[i];
+        Real u = momentum[i] / rho;
+
+        velocity[i] = u;
+        pressure[i] = (gamma - Real(1)) * (energy[i] - Real(0.5) * rho * u * u);
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::ComputeFlags(Real threshold) {
+    int n = GetResolution();
+    m_flags.assign(n, 0);
+
+    for (int i = 1; i < n - 1; i++) {
+        Real rhoJump = std::abs(density[i + 1] - density[i - 1]) / std::min(density[i + 1], density[i - 1]);
+        Real pJump = std::abs(pressure[i + 1] - pressure[i - 1]) / std::min(pressure[i + 1], pressure[i - 1]);
+        if (std::max(rhoJump, pJump) > threshold) {
+            m_flags[i] = 1;
+        }
+    }
+
+    //grow the flagged area so features stay inside refined regions until the next regrid
+    for (int pass = 0; pass < bufferRegions; pass++) {
+        for (int i = 1; i < n - 1; i++) {
+            if (m_flags[i] == 1) {
+                m_flags[i - 1] = std::max<char>(m_flags[i - 1], 2);
+                m_flags[i + 1] = std::max<char>(m_flags[i + 1], 2);
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            m_flags[i] = m_flags[i] != 0 ? 1 : 0;
+        }
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::BeginRebuild() {
+    m_scratchSizes.clear();
+    m_scratchLevels.clear();
+    m_scratchOrigins.clear();
+    m_scratchDensity.clear();
+    m_scratchMomentum.clear();
+    m_scratchEnergy.clear();
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::PushRegion(Real size, int level, long long origin, Real rho, Real m, Real E) {
+    m_scratchSizes.push_back(size);
+    m_scratchLevels.push_back(level);
+    m_scratchOrigins.push_back(origin);
+    m_scratchDensity.push_back(rho);
+    m_scratchMomentum.push_back(m);
+    m_scratchEnergy.push_back(E);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::EndRebuild() {
+    sizes.swap(m_scratchSizes);
+    levels.swap(m_scratchLevels);
+    m_origins.swap(m_scratchOrigins);
+    density.swap(m_scratchDensity);
+    momentum.swap(m_scratchMomentum);
+    energy.swap(m_scratchEnergy);
+
+    int n = GetResolution();
+    velocity.resize(n);
+    pressure.resize(n);
+    UpdatePrimatives();
+}
+
+template<typename Real, typename Flux, typename Boundary>
+bool BasicAdaptiveGasSimulation<Real, Flux, Boundary>::Refine() {
+    ComputeFlags(refineThreshold);
+
+    int n = GetResolution();
+    bool changed = false;
+    BeginRebuild();
+    for (int i = 0; i < n; i++) {
+        //ghost regions always stay at the base level
+        if (m_flags[i] && levels[i] < maxLevel && i != 0 && i != n - 1) {
+            //split into two children carrying the parent state, which conserves mass, momentum and energy exactly
+            Real half = sizes[i] * Real(0.5);
+            long long childWidth = 1ll << (maxLevel - levels[i] - 1);
+            PushRegion(half, levels[i] + 1, m_origins[i], density[i], momentum[i], energy[i]);
+            PushRegion(half, levels[i] + 1, m_origins[i] + childWidth, density[i], momentum[i], energy[i]);
+            changed = true;
+        }
+        else {
+            PushRegion(sizes[i], levels[i], m_origins[i], density[i], momentum[i], energy[i]);
+        }
+    }
+    EndRebuild();
+    return changed;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::Coarsen() {
+    ComputeFlags(coarsenThreshold);
+
+    int n = GetResolution();
+    BeginRebuild();
+    int i = 0;
+    while (i < n) {
+        bool merge = false;
+        if (i != 0 && i + 1 < n - 1 && levels[i] > 0 && levels[i] == levels[i + 1] && !m_flags[i] && !m_flags[i + 1]) {
+            //only a left child followed by its own sibling can merge back into the parent
+            long long parentWidth = 1ll << (maxLevel - levels[i] + 1);
+            merge = m_origins[i] % parentWidth == 0;
+        }
+
+        if (merge) {
+            //equal sizes, so the conservative average is the plain mean
+            PushRegion(sizes[i] + sizes[i + 1], levels[i] - 1, m_origins[i],
+                       Real(0.5) * (density[i] + density[i + 1]),
+                       Real(0.5) * (momentum[i] + momentum[i + 1]),
+                       Real(0.5) * (energy[i] + energy[i + 1]));
+            i += 2;
+        }
+        else {
+            PushRegion(sizes[i], levels[i], m_origins[i], density[i], momentum[i], energy[i]);
+            i++;
+        }
+    }
+    EndRebuild();
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::Regrid() {
+    Coarsen();
+    Refine();
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicAdaptiveGasSimulation<Real, Flux, Boundary>::Step() {
+    Regrid();
+
+    //regridding can split or merge the regions next to the ghosts, which have to mirror the new ones before the
+    //first flux through the ends is taken
+    int n = GetResolution();
+    boundary.Apply(density.data(), momentum.data(), energy.data(), n, PerfectGas<Real>{gamma});
+    m_inMass.assign(n, 0);
+    m_inMomentum.assign(n, 0);
+    m_inEnergy.assign(n, 0);
+    m_outMass.assign(n, 0);
+    m_outMomentum.assign(n, 0);
+    m_outEnergy.assign(n, 0);
+
+    //one global wave speed, each level then takes the largest step its region size allows
+    maxWaveSpeed = 0;
+    for (int i = 0; i < n; i++) {
+        maxWaveSpeed = std::max(maxWaveSpeed, std::abs(velocity[i]) + std::sqrt(gamma * pressure[i] / density[i]));
+    }
+    timeStep = std::min(CFL * m_baseSize / maxWaveSpeed, maxTimeStep);
+
+    int finestLevel = GetFinestLevel();
+    int substeps = 1 << finestLevel;
+    Real fineStep = timeStep / Real(substeps);
+
+    using Lane = ScalarPack<Real>;
+    for (int k = 0; k < substeps; k++) {
+        //interfaces are evaluated at the start of every step of the finer neighbour
+        for (int i = 0; i < n - 1; i++) {
+            int period = 1 << (finestLevel - std::max(levels[i], levels[i + 1]));
+            if (k % period != 0) {
+                continue;
+            }
+
+            FluxSide<Lane> l(density[i], momentum[i], energy[i], PerfectGas<Real>{gamma});
+            FluxSide<Lane> r(density[i + 1], momentum[i + 1], energy[i + 1], PerfectGas<Real>{gamma});
+            Lane F0, F1, F2;
+            Flux::Compute(l, r, PerfectGas<Real>{gamma}, F0, F1, F2);
+
+            Real dt = fineStep * Real(period);
+            m_outMass[i] += F0.v * dt;
+            m_outMomentum[i] += F1.v * dt;
+            m_outEnergy[i] += F2.v * dt;
+            m_inMass[i + 1] += F0.v * dt;
+            m_inMomentum[i + 1] += F1.v * dt;
+            m_inEnergy[i + 1] += F2.v * dt;
+        }
+
+        //regions update at the end of their own step with everything that crossed their interfaces meanwhile
+        for (int i = 1; i < n - 1; i++) {
+            int period = 1 << (finestLevel - levels[i]);
+            if ((k + 1) % period != 0) {
+                continue;
+            }
+
+            Real inverseSize = Real(1) / sizes[i];
+            density[i] -= (m_outMass[i] - m_inMass[i]) * inverseSize;
+            momentum[i] -= (m_outMomentum[i] - m_inMomentum[i]) * inverseSize;
+            energy[i] -= (m_outEnergy[i] - m_inEnergy[i]) * inverseSize;
+            m_outMass[i] = m_inMass[i] = 0;
+            m_outMomentum[i] = m_inMomentum[i] = 0;
+            m_outEnergy[i] = m_inEnergy[i] = 0;
+        }
+
+        boundary.Apply(density.data(), momentum.data(), energy.data(), n, PerfectGas<Real>{gamma});
+    }
+
+    UpdatePrimatives();
+    time += timeStep;
+}
+
+#define INSTANTIATE_ADAPTIVE_GAS_SIMULATION(Real, Flux) \
+    template class BasicAdaptiveGasSimulation<Real, Flux, ReflectiveBoundary>; \
+    template class BasicAdaptiveGasSimulation<Real, Flux, TransmissiveBoundary>; \
+    template class BasicAdaptiveGasSimulation<Real, Flux, InflowOutflowBoundary>;
+
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(float, RusanovFlux)
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(float, HLLFlux)
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(float, HLLCFlux)
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(float, RoeFlux)
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(double, RusanovFlux)
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(double, HLLFlux)
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(double, HLLCFlux)
+INSTANTIATE_ADAPTIVE_GAS_SIMULATION(double, RoeFlux)
@@ -0,0 +1,90 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef ADAPTIVE_GAS_SIMULATION_H
+#define ADAPTIVE_GAS_SIMULATION_H
+
+#include <limits>
+#include <vector>
+
+#include "boundary_conditions.h"
+#include "flux_kernels.h"
+
+#endif //ADAPTIVE_GAS_SIMULATION_H
+
+//cell based adaptive version of BasicGasSimulation. every region carries a refinement level, a region of level l
+//is 2^-l the size of a base region and is advanced with 2^-l of the base time step (sub-cycling).
+//an interface is evaluated on the time steps of the finer of its two regions and the flux is accumulated on
+//both sides, so a coarse region next to a fine one receives the time integral of every fine flux when it
+//completes its own step (conservative flux correction / refluxing). regions are split near shocks and contact
+//discontinuities and sibling pairs are merged back once the flow around them is smooth
+template<typename Real, typename Flux, typename Boundary>
+class BasicAdaptiveGasSimulation {
+    Real m_baseSize = 0;
+
+    //position of each region in units of the finest possible region, used to find sibling pairs
+    std::vector<long long> m_origins;
+
+    //flux time integrals through the left and right interface of each region since its last update
+    std::vector<Real> m_inMass, m_inMomentum, m_inEnergy;
+    std::vector<Real> m_outMass, m_outMomentum, m_outEnergy;
+
+    //regrid scratch, swapped with the live arrays so regridding stops allocating once capacity is reached
+    std::vector<char> m_flags;
+    std::vector<Real> m_scratchSizes, m_scratchDensity, m_scratchMomentum, m_scratchEnergy;
+    std::vector<int> m_scratchLevels;
+    std::vector<long long> m_scratchOrigins;
+
+    void ComputeFlags(Real threshold);
+    void BeginRebuild();
+    void PushRegion(Real size, int level, long long origin, Real rho, Real m, Real E);
+    void EndRebuild();
+    bool Refine();
+    void Coarsen();
+    void UpdatePrimatives();
+
+public:
+    using Scalar = Real;
+
+    std::vector<Real> sizes;
+    std::vector<int> levels;
+
+    std::vector<Real> density;
+    std::vector<Real> momentum;
+    std::vector<Real> energy;
+
+    std::vector<Real> velocity;
+    std::vector<Real> pressure;
+
+    Real gamma = 1.4;
+    Real CFL = 0.9;
+    Real maxWaveSpeed = 0;
+
+    Real time = 0;
+    Real timeStep = 0;  //base level step
+    Real maxTimeStep = std::numeric_limits<Real>::infinity();
+
+    Boundary boundary = {};
+
+    //refinement control. the indicator is the larger relative jump of density and pressure across a region
+    int maxLevel = 3;
+    Real refineThreshold = 0.05;
+    Real coarsenThreshold = 0.01;
+    int bufferRegions = 2;
+
+    //same sod setup as BasicGasSimulation, refined around the initial discontinuity
+    BasicAdaptiveGasSimulation(int baseResolution = 32, int maxLevel = 3);
+
+    int GetResolution() const { return (int)sizes.size(); }
+    int GetFinestLevel() const;
+    Real GetTotalMass() const;
+
+    void SetState(int regionIndex, Real density, Real velocity, Real pressure);
+    void Regrid();
+    void Step();
+};
+
+using AdaptiveGasSimulation = BasicAdaptiveGasSimulation<float, HLLFlux, ReflectiveBoundary>;
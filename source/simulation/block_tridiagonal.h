@@ -0,0 +1,104 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef BLOCK_TRIDIAGONAL_H
+#define BLOCK_TRIDIAGONAL_H
+
+#endif //BLOCK_TRIDIAGONAL_H
+
+//3x3 block of a block tridiagonal system, one row of blocks per region (mass, momentum, energy)
+template<typename Real>
+struct Block3 {
+    Real m[3][3] = {};
+
+    static Block3 Identity(Real scale) {
+        Block3 b;
+        b.m[0][0] = b.m[1][1] = b.m[2][2] = scale;
+        return b;
+    }
+
+    Block3 operator*(const Block3& o) const {
+        Block3 r;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                r.m[i][j] = m[i][0] * o.m[0][j] + m[i][1] * o.m[1][j] + m[i][2] * o.m[2][j];
+            }
+        }
+        return r;
+    }
+
+    Block3 operator-(const Block3& o) const {
+        Block3 r;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                r.m[i][j] = m[i][j] - o.m[i][j];
+            }
+        }
+        return r;
+    }
+
+    void Apply(const Real* v, Real* out) const {
+        Real x = v[0], y = v[1], z = v[2];
+        out[0] = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+        out[1] = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+        out[2] = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+    }
+
+    Block3 Inverse() const {
+        Block3 r;
+        r.m[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+        r.m[0][1] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+        r.m[0][2] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+        r.m[1][0] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+        r.m[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+        r.m[1][2] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+        r.m[2][0] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+        r.m[2][1] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+        r.m[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+        Real inverseDeterminant = Real(1) / (m[0][0] * r.m[0][0] + m[0][1] * r.m[1][0] + m[0][2] * r.m[2][0]);
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                r.m[i][j] *= inverseDeterminant;
+            }
+        }
+        return r;
+    }
+};
+
+//block Thomas algorithm. solves lower[k] x[k - 1] + diagonal[k] x[k] + upper[k] x[k + 1] = rhs[k] for k in
+//[0, count), lower[0] and upper[count - 1] are ignored. the solution replaces rhs (3 values per row), and
+//upper and diagonal are used as scratch
+template<typename Real>
+void SolveBlockTridiagonal(const Block3<Real>* lower, Block3<Real>* diagonal, Block3<Real>* upper, Real* rhs, int count) {
+    //forward elimination, upper[k] becomes D'^-1 U and rhs[k] becomes D'^-1 (r - L x')
+    for (int k = 0; k < count; k++) {
+        Real* r = rhs + 3 * k;
+        Block3<Real> pivot = diagonal[k];
+        if (k > 0) {
+            pivot = pivot - lower[k] * upper[k - 1];
+            Real correction[3];
+            lower[k].Apply(rhs + 3 * (k - 1), correction);
+            r[0] -= correction[0];
+            r[1] -= correction[1];
+            r[2] -= correction[2];
+        }
+
+        Block3<Real> inverse = pivot.Inverse();
+        inverse.Apply(r, r);
+        if (k + 1 < count) {
+            upper[k] = inverse * upper[k];
+        }
+    }
+
+    //back substitution
+    for (int k = count - 2; k >= 0; k--) {
+        Real correction[3];
+        upper[k].Apply(rhs + 3 * (k + 1), correction);
+        rhs[3 * k] -= correction[0];
+        rhs[3 * k + 1] -= correction[1];
+        rhs[3 * k + 2] -= correction[2];
+    }
+}
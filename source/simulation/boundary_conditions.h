@@ -0,0 +1,129 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef BOUNDARY_CONDITIONS_H
+#define BOUNDARY_CONDITIONS_H
+
+#include "simd.h"
+
+#endif //BOUNDARY_CONDITIONS_H
+
+//compile time boundary policies for BasicGasSimulation. the first and last regions of a simulation are ghost
+//regions, Apply fills them from the freshly updated interior (regions 1 and n - 2) with the gas of the equation
+//of state policy (equation_of_state.h) it is given. stride is the distance between consecutive regions, which
+//is more than one when simulations are interleaved (BasicGasEnsemble).
+//GhostJacobian gives the diagonal of d(ghost) / d(neighbouring region) at either end for the implicit solver
+
+//closed pipe ends, mirror the neighbouring region and flip its momentum
+struct ReflectiveBoundary {
+    template<typename Real, typename Eos>
+    void Apply(Real* density, Real* momentum, Real* energy, int n, const Eos& eos, int stride = 1) const {
+        int first = 0, second = stride, secondLast = (n - 2) * stride, last = (n - 1) * stride;
+        density[first] = density[second];
+        momentum[first] = -momentum[second];
+        energy[first] = energy[second];
+        density[last] = density[secondLast];
+        momentum[last] = -momentum[secondLast];
+        energy[last] = energy[secondLast];
+    }
+
+    template<typename Real>
+    void GhostJacobian(Real* left, Real* right) const {
+        left[0] = right[0] = Real(1);
+        left[1] = right[1] = Real(-1);
+        left[2] = right[2] = Real(1);
+    }
+};
+
+//zero gradient, lets waves leave the domain without reflecting
+struct TransmissiveBoundary {
+    template<typename Real, typename Eos>
+    void Apply(Real* density, Real* momentum, Real* energy, int n, const Eos& eos, int stride = 1) const {
+        int first = 0, second = stride, secondLast = (n - 2) * stride, last = (n - 1) * stride;
+        density[first] = density[second];
+        momentum[first] = momentum[second];
+        energy[first] = energy[second];
+        density[last] = density[secondLast];
+        momentum[last] = momentum[secondLast];
+        energy[last] = energy[secondLast];
+    }
+
+    template<typename Real>
+    void GhostJacobian(Real* left, Real* right) const {
+        left[0] = left[1] = left[2] = Real(1);
+        right[0] = right[1] = right[2] = Real(1);
+    }
+};
+
+//fixed inflow state on the left end, fixed back pressure on the right end (density and velocity extrapolated)
+struct InflowOutflowBoundary {
+    double inflowDensity = 1.0;
+    double inflowVelocity = 0.0;
+    double inflowPressure = 1.0;
+    double outflowPressure = 1.0;
+
+    template<typename Real, typename Eos>
+    void Apply(Real* density, Real* momentum, Real* energy, int n, const Eos& eos, int stride = 1) const {
+        int first = 0, secondLast = (n - 2) * stride, last = (n - 1) * stride;
+        Real rho = (Real)inflowDensity;
+        Real u = (Real)inflowVelocity;
+        density[first] = rho;
+        momentum[first] = rho * u;
+        energy[first] = eos.InternalEnergy(ScalarPack<Real>(rho), ScalarPack<Real>((Real)inflowPressure)).v + Real(0.5) * rho * u * u;
+
+        rho = density[secondLast];
+        u = momentum[secondLast] / rho;
+        density[last] = rho;
+        momentum[last] = rho * u;
+        energy[last] = eos.InternalEnergy(ScalarPack<Real>(rho), ScalarPack<Real>((Real)outflowPressure)).v + Real(0.5) * rho * u * u;
+    }
+
+    template<typename Real>
+    void GhostJacobian(Real* left, Real* right) const {
+        //the inflow ghost is fixed, the outflow ghost follows density and momentum but not energy
+        left[0] = left[1] = left[2] = Real(0);
+        right[0] = right[1] = Real(1);
+        right[2] = Real(0);
+    }
+};
+
+//ends owned by whatever couples the simulation to its surroundings (PipeNetwork). a closed end is a wall like
+//ReflectiveBoundary, an open end takes the ghost state last handed to it, given as conservatives
+struct ExternalBoundary {
+    bool closed[2] = {true, true};
+    double density[2] = {1.0, 1.0};
+    double momentum[2] = {0.0, 0.0};
+    double energy[2] = {2.5, 2.5};
+
+    template<typename Real, typename Eos>
+    void Apply(Real* density, Real* momentum, Real* energy, int n, const Eos& eos, int stride = 1) const {
+        int ghosts[2] = {0, (n - 1) * stride};
+        int neighbours[2] = {stride, (n - 2) * stride};
+        for (int end = 0; end < 2; end++) {
+            if (closed[end]) {
+                density[ghosts[end]] = density[neighbours[end]];
+                momentum[ghosts[end]] = -momentum[neighbours[end]];
+                energy[ghosts[end]] = energy[neighbours[end]];
+            }
+            else {
+                density[ghosts[end]] = (Real)this->density[end];
+                momentum[ghosts[end]] = (Real)this->momentum[end];
+                energy[ghosts[end]] = (Real)this->energy[end];
+            }
+        }
+    }
+
+    template<typename Real>
+    void GhostJacobian(Real* left, Real* right) const {
+        Real* ends[2] = {left, right};
+        for (int end = 0; end < 2; end++) {
+            Real coupling = closed[end] ? Real(1) : Real(0);
+            ends[end][0] = coupling;
+            ends[end][1] = -coupling;
+            ends[end][2] = coupling;
+        }
+    }
+};
@@ -0,0 +1,119 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "checkpoint.h"
+
+#include <cstdio>
+
+static uint64_t AlignOffset(uint64_t offset) {
+    return (offset + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT * CHECKPOINT_ALIGNMENT;
+}
+
+bool CheckpointWriter::Write(const std::string& path, std::string& error) const {
+    std::vector<CheckpointSection> table;
+    uint64_t offset = AlignOffset(sizeof(CheckpointHeader) + m_sections.size() * sizeof(CheckpointSection));
+    for (const Pending& pending : m_sections) {
+        CheckpointSection section = pending.section;
+        section.offset = offset;
+        table.push_back(section);
+        offset = AlignOffset(offset + section.count * section.elementSize);
+    }
+
+    CheckpointHeader header = {};
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.endianTag = CHECKPOINT_ENDIAN_TAG;
+    header.sectionCount = (uint32_t)table.size();
+    header.fileSize = offset;
+
+    std::string temporaryPath = path + ".tmp";
+    MappedFile file;
+    if (!file.Create(temporaryPath, (size_t)offset)) {
+        error = "unable to write " + temporaryPath;
+        return false;
+    }
+    unsigned char* data = file.GetWritableData();
+    std::memcpy(data, &header, sizeof(header));
+    if (!table.empty()) {
+        std::memcpy(data + sizeof(header), table.data(), table.size() * sizeof(CheckpointSection));
+    }
+    for (size_t i = 0; i < table.size(); i++) {
+        if (table[i].count > 0) {
+            std::memcpy(data + table[i].offset, m_sections[i].data, table[i].count * table[i].elementSize);
+        }
+    }
+    file.Close();
+
+    //rename replaces an existing file atomically on posix, so a crash leaves the old checkpoint or the new one.
+    //windows' rename does not replace, the old one has to go first
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        error = "unable to replace " + path;
+        return false;
+    }
+    return true;
+}
+
+bool CheckpointReader::Open(const std::string& path, std::string& error) {
+    m_sections = nullptr;
+    m_sectionCount = 0;
+    m_cursor = 0;
+    if (!m_file.OpenRead(path)) {
+        error = "unable to open " + path;
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (m_file.GetSize() < sizeof(header)) {
+        error = path + ": not a checkpoint";
+        return false;
+    }
+    std::memcpy(&header, m_file.GetData(), sizeof(header));
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+        error = path + ": not a checkpoint";
+        return false;
+    }
+    if (header.endianTag != CHECKPOINT_ENDIAN_TAG) {
+        error = path + ": written on a machine of the other byte order";
+        return false;
+    }
+    if (header.version != CHECKPOINT_VERSION) {
+        error = path + ": checkpoint format " + std::to_string(header.version) + ", expected " + std::to_string(CHECKPOINT_VERSION);
+        return false;
+    }
+
+    uint64_t size = m_file.GetSize();
+    uint64_t tableEnd = sizeof(header) + (uint64_t)header.sectionCount * sizeof(CheckpointSection);
+    if (header.fileSize != size || tableEnd > size) {
+        error = path + ": truncated";
+        return false;
+    }
+    const CheckpointSection* sections = (const CheckpointSection*)(m_file.GetData() + sizeof(header));
+    for (uint32_t i = 0; i < header.sectionCount; i++) {
+        const CheckpointSection& section = sections[i];
+        bool aligned = section.offset % CHECKPOINT_ALIGNMENT == 0;
+        bool inside = section.elementSize > 0 && section.offset >= tableEnd && section.offset <= size &&
+                      section.count <= (size - section.offset) / section.elementSize;
+        if (!aligned || !inside) {
+            error = path + ": section " + std::to_string(section.id) + " is corrupt";
+            return false;
+        }
+    }
+    m_sections = sections;
+    m_sectionCount = header.sectionCount;
+    return true;
+}
+
+const CheckpointSection* CheckpointReader::Find(uint32_t id, uint32_t index, uint32_t elementSize) const {
+    for (uint32_t n = 0; n < m_sectionCount; n++) {
+        uint32_t i = (m_cursor + n) % m_sectionCount;
+        if (m_sections[i].id == id && m_sections[i].index == index) {
+            m_cursor = i + 1;
+            return m_sections[i].elementSize == elementSize ? &m_sections[i] : nullptr;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,122 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../core/mapped_file.h"
+
+#endif //CHECKPOINT_H
+
+//binary checkpoint files: a header, a table of sections, then the sections. a section is a flat array of one
+//trivially copyable type at a 64 byte aligned offset, stored exactly as it is in memory, so writing and
+//restoring one is a single copy to or from the mapped file instead of per field parsing. the header carries a
+//format version and the byte order of the writer, files from another version or byte order are refused
+//rather than misread (a checkpoint is for resuming on the same kind of machine, not for archiving)
+constexpr char CHECKPOINT_MAGIC[8] = {'R', 'E', 'S', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t CHECKPOINT_VERSION = 1;
+constexpr uint32_t CHECKPOINT_ENDIAN_TAG = 0x01020304;
+constexpr uint64_t CHECKPOINT_ALIGNMENT = 64;
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;         //reads back as 0x04030201 on a machine of the other byte order
+    uint32_t sectionCount;
+    uint32_t reserved;
+    uint64_t fileSize;
+};
+
+//a section is named by what it holds and an index, e.g. the density of pipe 3
+struct CheckpointSection {
+    uint32_t id;
+    uint32_t index;
+    uint32_t elementSize;       //catches a section read back as another type, float against double state
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t offset;            //from the start of the file
+};
+
+class CheckpointWriter {
+    struct Pending {
+        CheckpointSection section;
+        const void* data;
+    };
+    std::vector<Pending> m_sections;
+
+public:
+    //the data is only referenced, it has to stay alive until Write
+    template<typename T>
+    void Add(uint32_t id, uint32_t index, const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint sections are copied as raw memory");
+        m_sections.push_back({{id, index, (uint32_t)sizeof(T), 0, (uint64_t)count, 0}, data});
+    }
+
+    template<typename T>
+    void Add(uint32_t id, uint32_t index, const std::vector<T>& values) { Add(id, index, values.data(), values.size()); }
+
+    //written to a temporary file next to the path and renamed over it, so a run stopped while writing leaves
+    //the previous checkpoint intact
+    bool Write(const std::string& path, std::string& error) const;
+};
+
+//keeps the file mapped, the section pointers stay valid as long as the reader
+class CheckpointReader {
+    MappedFile m_file;
+    const CheckpointSection* m_sections = nullptr;
+    uint32_t m_sectionCount = 0;
+    mutable uint32_t m_cursor = 0;      //sections are usually read in the order they were written
+
+    const CheckpointSection* Find(uint32_t id, uint32_t index, uint32_t elementSize) const;
+
+public:
+    //checks the header and that every section lies inside the file
+    bool Open(const std::string& path, std::string& error);
+
+    //the elements of a section in place, nullptr when it is missing or holds another type
+    template<typename T>
+    const T* Get(uint32_t id, uint32_t index, size_t& count) const {
+        const CheckpointSection* section = Find(id, index, (uint32_t)sizeof(T));
+        count = section ? (size_t)section->count : 0;
+        return section ? (const T*)(m_file.GetData() + section->offset) : nullptr;
+    }
+
+    template<typename T>
+    bool Read(uint32_t id, uint32_t index, std::vector<T>& values) const {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint sections are copied as raw memory");
+        size_t count = 0;
+        const T* data = Get<T>(id, index, count);
+        if (data == nullptr) {
+            return false;
+        }
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), data, count * sizeof(T));
+        }
+        return true;
+    }
+
+    //false unless the section holds exactly count elements
+    template<typename T>
+    bool Read(uint32_t id, uint32_t index, T* values, size_t count) const {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint sections are copied as raw memory");
+        size_t stored = 0;
+        const T* data = Get<T>(id, index, stored);
+        if (data == nullptr || stored != count) {
+            return false;
+        }
+        if (count > 0) {
+            std::memcpy(values, data, count * sizeof(T));
+        }
+        return true;
+    }
+};
@@ -0,0 +1,174 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "combustion_table.h"
+
+#include <algorithm>
+#include <cmath>
+
+enum CombustionTableSection {
+    COMBUSTION_AXES_SECTION = 1,
+    COMBUSTION_POINTS_SECTION
+};
+
+//the closed form stand in: a kerosene and oxygen like pair burning to a temperature that peaks at the
+//stoichiometric mixture ratio and is cut back by dissociation, more so at low pressure, in lighter products
+//the more fuel rich it runs, with gamma rising as the gas cools
+static const double STOICHIOMETRIC_MIXTURE_RATIO = 3.4;
+static const double INJECTION_TEMPERATURE = 300.0;
+static const double STOICHIOMETRIC_TEMPERATURE_RISE = 3900.0;
+
+static CombustionProperties ComputeProperties(double mixtureRatio, double pressure, double expansionRatio) {
+    double stoichiometric = STOICHIOMETRIC_MIXTURE_RATIO;
+    double heatRelease = mixtureRatio < stoichiometric ? mixtureRatio / (1.0 + mixtureRatio) * (1.0 + stoichiometric) / stoichiometric
+                                                       : (1.0 + stoichiometric) / (1.0 + mixtureRatio);
+    double dissociation = 0.25 / (1.0 + std::sqrt(pressure / 1e6));
+    double temperatureRise = STOICHIOMETRIC_TEMPERATURE_RISE * heatRelease * (1.0 - dissociation * heatRelease * heatRelease);
+    double temperature = INJECTION_TEMPERATURE + temperatureRise;
+    double molecularWeight = 10.0 + 20.0 * mixtureRatio / (1.0 + mixtureRatio);
+    double gamma = 1.26 - 0.12 * temperatureRise / STOICHIOMETRIC_TEMPERATURE_RISE;
+
+    //the mass flow function of the throat, c* = sqrt(R T) / flowFactor
+    double flowFactor = std::sqrt(gamma) * std::pow(2.0 / (gamma + 1.0), (gamma + 1.0) / (2.0 * (gamma - 1.0)));
+
+    //the supersonic exit mach number of the expansion ratio, by bisection on the area mach number relation
+    double low = 1.0, high = 20.0;
+    for (int i = 0; i < 60; i++) {
+        double mach = 0.5 * (low + high);
+        double area = std::pow(2.0 / (gamma + 1.0) * (1.0 + 0.5 * (gamma - 1.0) * mach * mach), (gamma + 1.0) / (2.0 * (gamma - 1.0))) / mach;
+        (area < expansionRatio ? low : high) = mach;
+    }
+    double exitMach = 0.5 * (low + high);
+    double exitPressureRatio = std::pow(1.0 + 0.5 * (gamma - 1.0) * exitMach * exitMach, -gamma / (gamma - 1.0));
+
+    //an overexpanded nozzle whose ambient term outweighs the momentum would separate, it is taken to make no
+    //thrust rather than pull
+    double momentum = flowFactor * std::sqrt(2.0 * gamma / (gamma - 1.0) * (1.0 - std::pow(exitPressureRatio, (gamma - 1.0) / gamma)));
+    double thrustCoefficient = momentum + expansionRatio * (exitPressureRatio - SEA_LEVEL_PRESSURE / pressure);
+
+    CombustionProperties properties;
+    properties.temperature = (float)temperature;
+    properties.gamma = (float)gamma;
+    properties.molecularWeight = (float)molecularWeight;
+    properties.characteristicVelocity = (float)(std::sqrt(UNIVERSAL_GAS_CONSTANT / molecularWeight * temperature) / flowFactor);
+    properties.thrustCoefficient = (float)std::max(thrustCoefficient, 0.0);
+    return properties;
+}
+
+static inline void Accumulate(CombustionProperties& sum, const CombustionProperties& point, float weight) {
+    sum.temperature += weight * point.temperature;
+    sum.gamma += weight * point.gamma;
+    sum.molecularWeight += weight * point.molecularWeight;
+    sum.characteristicVelocity += weight * point.characteristicVelocity;
+    sum.thrustCoefficient += weight * point.thrustCoefficient;
+}
+
+//Catmull-Rom weights of the four points around an interval, at the fraction t into it
+static inline void CubicWeights(float t, float weights[4]) {
+    weights[0] = 0.5f * ((-t + 2.0f) * t - 1.0f) * t;
+    weights[1] = 0.5f * ((3.0f * t - 5.0f) * t * t + 2.0f);
+    weights[2] = 0.5f * ((-3.0f * t + 4.0f) * t + 1.0f) * t;
+    weights[3] = 0.5f * (t - 1.0f) * t * t;
+}
+
+void CombustionTable::SetAxes(const CombustionTableAxes& axes) {
+    m_axes = axes;
+    m_mixtureRatioScale = (float)(axes.mixtureRatioCount - 1) / (axes.maxMixtureRatio - axes.minMixtureRatio);
+    m_logMinPressure = std::log(axes.minPressure);
+    m_logPressureScale = (float)(axes.pressureCount - 1) / (std::log(axes.maxPressure) - m_logMinPressure);
+}
+
+bool CombustionTable::Load(const std::string& path, std::string& error) {
+    m_points = nullptr;
+    m_generated.clear();
+    if (!m_file.Open(path, error)) {
+        return false;
+    }
+
+    size_t count = 0;
+    const CombustionTableAxes* axes = m_file.Get<CombustionTableAxes>(COMBUSTION_AXES_SECTION, 0, count);
+    if (axes == nullptr || count != 1) {
+        error = path + ": not a combustion table";
+        return false;
+    }
+    if (axes->mixtureRatioCount < 2 || axes->pressureCount < 2 || !(axes->minMixtureRatio < axes->maxMixtureRatio) ||
+        !(axes->minPressure > 0.0f && axes->minPressure < axes->maxPressure)) {
+        error = path + ": malformed combustion table axes";
+        return false;
+    }
+    const CombustionProperties* points = m_file.Get<CombustionProperties>(COMBUSTION_POINTS_SECTION, 0, count);
+    if (points == nullptr || count != (size_t)axes->mixtureRatioCount * axes->pressureCount) {
+        error = path + ": the combustion table's points do not fill its axes";
+        return false;
+    }
+    SetAxes(*axes);
+    m_points = points;
+    return true;
+}
+
+bool CombustionTable::Save(const std::string& path, std::string& error) const {
+    if (m_points == nullptr) {
+        error = "the combustion table is empty";
+        return false;
+    }
+    CheckpointWriter writer;
+    writer.Add(COMBUSTION_AXES_SECTION, 0, &m_axes, 1);
+    writer.Add(COMBUSTION_POINTS_SECTION, 0, m_points, (size_t)m_axes.mixtureRatioCount * m_axes.pressureCount);
+    return writer.Write(path, error);
+}
+
+void CombustionTable::Generate(const CombustionTableAxes& axes) {
+    CombustionTableAxes grid = axes;
+    grid.mixtureRatioCount = std::max(grid.mixtureRatioCount, 2);
+    grid.pressureCount = std::max(grid.pressureCount, 2);
+    SetAxes(grid);
+
+    m_generated.resize((size_t)grid.mixtureRatioCount * grid.pressureCount);
+    for (int i = 0; i < grid.mixtureRatioCount; i++) {
+        double mixtureRatio = grid.minMixtureRatio + (double)i / m_mixtureRatioScale;
+        for (int j = 0; j < grid.pressureCount; j++) {
+            double pressure = std::exp(m_logMinPressure + (double)j / m_logPressureScale);
+            m_generated[(size_t)i * grid.pressureCount + j] = ComputeProperties(mixtureRatio, pressure, grid.expansionRatio);
+        }
+    }
+    m_points = m_generated.data();
+}
+
+CombustionProperties CombustionTable::Sample(float mixtureRatio, float chamberPressure) const {
+    int columns = m_axes.pressureCount;
+    float x = (mixtureRatio - m_axes.minMixtureRatio) * m_mixtureRatioScale;
+    float y = (std::log(std::max(chamberPressure, m_axes.minPressure)) - m_logMinPressure) * m_logPressureScale;
+    x = std::min(std::max(x, 0.0f), (float)(m_axes.mixtureRatioCount - 1));
+    y = std::min(y, (float)(columns - 1));
+    int i = std::min((int)x, m_axes.mixtureRatioCount - 2);
+    int j = std::min((int)y, columns - 2);
+    float fx = x - (float)i;
+    float fy = y - (float)j;
+
+    CombustionProperties sample;
+    if (interpolation == BILINEAR_INTERPOLATION) {
+        const CombustionProperties* row = m_points + (size_t)i * columns + j;
+        Accumulate(sample, row[0], (1.0f - fx) * (1.0f - fy));
+        Accumulate(sample, row[1], (1.0f - fx) * fy);
+        Accumulate(sample, row[columns], fx * (1.0f - fy));
+        Accumulate(sample, row[columns + 1], fx * fy);
+        return sample;
+    }
+
+    //the neighbours beyond the edge repeat the edge, which flattens the slope there
+    float weightsX[4], weightsY[4];
+    CubicWeights(fx, weightsX);
+    CubicWeights(fy, weightsY);
+    int columnIndices[4];
+    for (int b = 0; b < 4; b++) {
+        columnIndices[b] = std::min(std::max(j - 1 + b, 0), columns - 1);
+    }
+    for (int a = 0; a < 4; a++) {
+        const CombustionProperties* row = m_points + (size_t)std::min(std::max(i - 1 + a, 0), m_axes.mixtureRatioCount - 1) * columns;
+        for (int b = 0; b < 4; b++) {
+            Accumulate(sample, row[columnIndices[b]], weightsX[a] * weightsY[b]);
+        }
+    }
+    return sample;
+}
@@ -0,0 +1,95 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef COMBUSTION_TABLE_H
+#define COMBUSTION_TABLE_H
+
+#include <string>
+#include <vector>
+
+#include "checkpoint.h"
+
+#endif //COMBUSTION_TABLE_H
+
+constexpr double UNIVERSAL_GAS_CONSTANT = 8314.46;      //J/(kmol K)
+
+//sea level air, what the ambient state of a network is taken to be when its unitless pressures and velocities
+//are converted to the SI units of a table
+constexpr double SEA_LEVEL_PRESSURE = 101325.0;
+constexpr double SEA_LEVEL_GAS_CONSTANT_TEMPERATURE = 287.05 * 288.15;
+
+//the combustion products of a propellant pair in the chamber, in SI units. the thrust coefficient is of a
+//nozzle of the table's expansion ratio at sea level, thrust = thrustCoefficient * chamber pressure * throat area.
+//padded to 32 bytes, so a point never straddles a cache line and the two points of a pressure interval share
+//one more often than not
+struct alignas(32) CombustionProperties {
+    float temperature = 0.0f;               //K
+    float gamma = 0.0f;
+    float molecularWeight = 0.0f;           //kg/kmol
+    float characteristicVelocity = 0.0f;    //m/s, chamber pressure * throat area / mass flow rate
+    float thrustCoefficient = 0.0f;
+    float reserved[3] = {};
+};
+
+//the grid the properties are tabulated on: mixture ratio (oxidizer to fuel mass) spaced evenly, chamber
+//pressure (Pa) spaced evenly in its logarithm, so the low pressures the properties change fastest at get as
+//many points as the high ones. both counts are at least 2
+struct CombustionTableAxes {
+    float minMixtureRatio = 1.0f;
+    float maxMixtureRatio = 8.0f;
+    float minPressure = 5e4f;
+    float maxPressure = 2e7f;
+    int mixtureRatioCount = 57;
+    int pressureCount = 49;
+    float expansionRatio = 10.0f;       //of the nozzle the thrust coefficients are for
+    float reserved = 0.0f;
+};
+
+enum CombustionInterpolation {
+    BILINEAR_INTERPOLATION,     //4 points, continuous
+    BICUBIC_INTERPOLATION       //16 points (Catmull-Rom), with continuous slopes
+};
+
+//precomputed equilibrium combustion properties as functions of mixture ratio and chamber pressure, so nothing
+//is solved while the simulation runs. a sample is a few multiplies and two or four cache lines of one flat
+//array (pressure index fastest), cheap enough for every engine at every sub step. outside the grid the
+//properties of its edge are returned.
+//
+//table files are checkpoint files (checkpoint.h) with the axes and the points as two sections. a loaded table
+//is sampled where it is mapped, it is never copied or parsed, and a file written by an equilibrium code only
+//has to be converted to that layout once. Generate fills a table from a closed form stand in for a
+//kerosene and oxygen like pair, for when no file is given
+class CombustionTable {
+    CheckpointReader m_file;
+    std::vector<CombustionProperties> m_generated;
+    const CombustionProperties* m_points = nullptr;
+    CombustionTableAxes m_axes;
+
+    //index space of the axes: index = (value - offset) * scale
+    float m_mixtureRatioScale = 0.0f;
+    float m_logMinPressure = 0.0f;
+    float m_logPressureScale = 0.0f;
+
+    void SetAxes(const CombustionTableAxes& axes);
+
+public:
+    CombustionInterpolation interpolation = BILINEAR_INTERPOLATION;
+
+    CombustionTable() = default;
+    CombustionTable(const CombustionTable&) = delete;
+    CombustionTable& operator=(const CombustionTable&) = delete;
+
+    bool Load(const std::string& path, std::string& error);
+    bool Save(const std::string& path, std::string& error) const;
+    void Generate(const CombustionTableAxes& axes = CombustionTableAxes());
+
+    bool IsEmpty() const { return m_points == nullptr; }
+    const CombustionTableAxes& GetAxes() const { return m_axes; }
+    const CombustionProperties& GetPoint(int mixtureRatio, int pressure) const { return m_points[mixtureRatio * m_axes.pressureCount + pressure]; }
+
+    //with the table's interpolation, the chamber pressure in Pa
+    CombustionProperties Sample(float mixtureRatio, float chamberPressure) const;
+};
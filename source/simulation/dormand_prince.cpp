@@ -0,0 +1,118 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "dormand_prince.h"
+
+#include <algorithm>
+#include <cmath>
+
+//the Butcher tableau, the last row of a is the fifth order solution, so its derivative is the next step's first
+//stage (first same as last)
+static const double C[7] = {0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0};
+static const double A[7][6] = {
+    {},
+    {1.0 / 5.0},
+    {3.0 / 40.0, 9.0 / 40.0},
+    {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+    {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+    {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+    {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}
+};
+
+//fifth order weights less the fourth order ones
+static const double E[7] = {71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0};
+
+bool DormandPrinceIntegrator::Integrate(std::vector<double>& state, double time, double duration,
+                                        bool (*evaluate)(const void* context, double time, const double* state, double* derivative), const void* context) {
+    int n = (int)state.size();
+    if (n == 0 || duration <= 0.0) {
+        return true;
+    }
+    for (std::vector<double>& stage : m_stages) {
+        stage.resize(n);
+    }
+    m_stageState.resize(n);
+    m_nextState.resize(n);
+
+    //the state may have been changed since the last call, so the first stage is not carried over
+    statistics.evaluations++;
+    if (!evaluate(context, time, state.data(), m_stages[0].data())) {
+        statistics.failedEvaluations++;
+        return false;
+    }
+
+    //a first step that changes the state by about the tolerance
+    if (m_stepSize <= 0.0) {
+        double scale = 0.0;
+        for (int i = 0; i < n; i++) {
+            double tolerance = absoluteTolerance + relativeTolerance * std::abs(state[i]);
+            scale = std::max(scale, std::abs(m_stages[0][i]) / tolerance);
+        }
+        m_stepSize = scale > 0.0 ? 0.01 / scale : duration;
+    }
+
+    double endTime = time + duration;
+    while (time < endTime) {
+        double stepSize = std::max(std::min(m_stepSize, maxStepSize), minStepSize);
+        bool last = time + stepSize >= endTime;
+        if (last) {
+            stepSize = endTime - time;
+        }
+
+        bool evaluated = true;
+        for (int s = 1; s < 7 && evaluated; s++) {
+            for (int i = 0; i < n; i++) {
+                double increment = 0.0;
+                for (int j = 0; j < s; j++) {
+                    increment += A[s][j] * m_stages[j][i];
+                }
+                m_stageState[i] = state[i] + stepSize * increment;
+            }
+            if (s == 6) {
+                m_nextState = m_stageState;
+            }
+            evaluated = evaluate(context, time + C[s] * stepSize, m_stageState.data(), m_stages[s].data());
+            statistics.evaluations++;
+        }
+        if (!evaluated) {
+            //no error estimate without every stage, so no step of any size is accepted on one that failed
+            statistics.failedEvaluations++;
+            statistics.rejectedSteps++;
+            if (stepSize <= minStepSize) {
+                return false;
+            }
+            m_stepSize = 0.2 * stepSize;
+            continue;
+        }
+
+        double error = 0.0;
+        for (int i = 0; i < n; i++) {
+            double difference = 0.0;
+            for (int s = 0; s < 7; s++) {
+                difference += E[s] * m_stages[s][i];
+            }
+            double tolerance = absoluteTolerance + relativeTolerance * std::max(std::abs(state[i]), std::abs(m_nextState[i]));
+            error = std::max(error, std::abs(stepSize * difference) / tolerance);
+        }
+
+        //the clipped last step does not set the size of the next one, unless it failed
+        double factor = error > 0.0 ? 0.9 * std::pow(error, -0.2) : 5.0;
+        factor = std::min(std::max(factor, 0.2), 5.0);
+        if (error <= 1.0 || stepSize <= minStepSize) {
+            state.swap(m_nextState);
+            m_stages[0].swap(m_stages[6]);
+            time = last ? endTime : time + stepSize;
+            statistics.acceptedSteps++;
+            if (!last || factor < 1.0) {
+                m_stepSize = stepSize * factor;
+            }
+        }
+        else {
+            //the first stage is still the state's, only the others are retaken
+            m_stepSize = stepSize * factor;
+            statistics.rejectedSteps++;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef DORMAND_PRINCE_H
+#define DORMAND_PRINCE_H
+
+#include <limits>
+#include <vector>
+
+#endif //DORMAND_PRINCE_H
+
+struct IntegrationStatistics {
+    int acceptedSteps = 0;
+    int rejectedSteps = 0;
+    int evaluations = 0;
+    int failedEvaluations = 0;      //of a state the derivative could not be taken at
+};
+
+//explicit embedded Runge-Kutta of order 5(4) (Dormand-Prince) with error control, for a whole system of ODEs
+//in one state vector. every step is estimated with both orders, the difference is the error, and a step whose
+//error (per component, relative to relativeTolerance |y| + absoluteTolerance) exceeds 1 is retaken shorter.
+//the next step grows with the error's fifth root, so smooth stretches are crossed in a few large steps while
+//sudden changes get small ones. a stage whose derivative cannot be evaluated fails the step like too large an
+//error does. the step size carries over from one Integrate to the next
+class DormandPrinceIntegrator {
+    double m_stepSize = 0.0;
+    std::vector<double> m_stages[7];
+    std::vector<double> m_stageState;
+    std::vector<double> m_nextState;
+
+    bool Integrate(std::vector<double>& state, double time, double duration,
+                   bool (*evaluate)(const void* context, double time, const double* state, double* derivative), const void* context);
+
+public:
+    double relativeTolerance = 1e-6;
+    double absoluteTolerance = 1e-9;
+    double maxStepSize = std::numeric_limits<double>::infinity();
+    double minStepSize = 1e-12;         //accepted whatever its error, so a discontinuity cannot stall the run
+
+    IntegrationStatistics statistics;
+
+    //advances the state from time over exactly the duration, derivative(time, state, derivative) fills the
+    //derivative of the state (all three are as long as the state) and returns false when it cannot. false when
+    //the state could not be advanced that far, it is then left at the last step that could be taken
+    template<typename Derivative>
+    bool Integrate(std::vector<double>& state, double time, double duration, const Derivative& derivative) {
+        return Integrate(state, time, duration, [](const void* context, double t, const double* y, double* dydt) {
+            return (*static_cast<const Derivative*>(context))(t, y, dydt);
+        }, &derivative);
+    }
+
+    //0 before the first step, which then starts from an estimate
+    double GetStepSize() const { return m_stepSize; }
+    void SetStepSize(double stepSize) { m_stepSize = stepSize; }
+};
@@ -4,8 +4,17 @@
 
 #include "engine_simulation.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 Tank::Tank(Gas storedGas, float volume, float storedAmount) : Model(Model::LoadModelFromOBJ("resources/meshes/tank.obj")), storedGas(storedGas), volume(volume), storedAmount(storedAmount) {
     meshes[0].material.color = storedGas.color;
@@ -13,74 +22,423 @@ Tank::Tank(Gas storedGas, float volume, float storedAmount) : Model(Model::LoadM
     connectionPoints.emplace_back(0, -1.95,0);
 }
 
-void Tank::ComputeControlPointPressure() {
-    for (int i = 0; i < connectedControls.size(); i++) {
-        Control* c = connectedControls[i];
-        c->controlPointPressure = 10.0f;
-    }
-}
-
 ElectricPump::ElectricPump() : Pump(Model::LoadModelFromOBJ("resources/meshes/pump.obj")) {
     meshes[1].material.color = glm::vec3(0.8, 0.6, 0.4);
     connectionPoints.emplace_back(0,1.25,0);
     connectionPoints.emplace_back(0,0,-1.15);
 }
 
-void ElectricPump::ComputeControlPointPressure() {
-    for (int i = 0; i < connectedControls.size(); i++) {
-        Control* c = connectedControls[i];
+Engine::Engine() : Model(Model::LoadModelFromOBJ("resources/meshes/test_engine.obj")){
 
-        if (c->position == connectionPoints[0]) {
-            c->controlPointPressure = -5.0f;
-        }
-        else if (c->position == connectionPoints[1]) {
-            c->controlPointPressure = 5.0f;
+}
+
+void SimulationPipeline::Initialize() {
+    //the simulation thread takes part in the pool's jobs, so the pool leaves a core for the editor
+    m_threadPool = std::make_unique<ThreadPool>(std::max((int)std::thread::hardware_concurrency() - 1, 1));
+    std::string error;
+    if (combustionTablePath.empty() || !m_combustionTable.Load(combustionTablePath, error)) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
         }
+        m_combustionTable.Generate();
     }
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&SimulationPipeline::SimulationLoop, this);
 }
 
-Engine::Engine() : Model(Model::LoadModelFromOBJ("resources/meshes/test_engine.obj")){
+SimulationPipeline::~SimulationPipeline() {
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
 
+//cheap to walk compared to the RTTI chain, they only read counts, addresses and the pipe geometry the layout
+//is built from
+static void CombineSignature(size_t& signature, size_t value) {
+    signature ^= std::hash<size_t>{}(value) + (size_t)0x9e3779b97f4a7c15ull + (signature << 6) + (signature >> 2);
 }
 
-void Engine::ComputeControlPointPressure() {
-    for (int i = 0; i < connectedControls.size(); i++) {
-        Control* c = connectedControls[i];
-        c->controlPointPressure = -10.0f;
-    }
+static void CombineSignature(size_t& signature, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    CombineSignature(signature, (size_t)bits);
 }
 
-void SimulationPipeline::Initialize() {
+size_t SimulationPipeline::ComputeTopologySignature(const Scene* scene) {
+    size_t signature = 0;
+    CombineSignature(signature, scene->models.size());
+    CombineSignature(signature, scene->pipes.size());
+    for (const Model* model : scene->models) {
+        CombineSignature(signature, (size_t)model);
+        CombineSignature(signature, model->connectedControls.size());
+        CombineSignature(signature, (size_t)model->connectedControls.data());
+    }
+    for (const Pipe* pipe : scene->pipes) {
+        CombineSignature(signature, (size_t)pipe->path.controls.data());
+        CombineSignature(signature, pipe->path.controls.size());
+    }
+    return signature;
+}
 
+size_t SimulationPipeline::ComputeGeometrySignature(const Scene* scene) {
+    //a dragged control point or a changed radius or bevel moves the lengths, areas, bends and junctions
+    size_t signature = 0;
+    for (const Pipe* pipe : scene->pipes) {
+        CombineSignature(signature, pipe->radius);
+        for (const Control& control : pipe->path.controls) {
+            CombineSignature(signature, control.position.x);
+            CombineSignature(signature, control.position.y);
+            CombineSignature(signature, control.position.z);
+            CombineSignature(signature, control.bevelRadius);
+            CombineSignature(signature, (size_t)control.bevelNumber);
+        }
+    }
+    return signature;
 }
 
 void SimulationPipeline::RegisterScene(Scene* scene) {
+    SendScene(scene, false);
+}
+
+void SimulationPipeline::SendScene(Scene* scene, bool geometryOnly) {
+    NetworkLayout layout;
+    layout.ambientPressure = ambientPressure;
+    layout.ambientDensity = ambientDensity;
+    layout.pipeRegionSize = pipeRegionSize;
+    layout.sleepTolerance = sleepTolerance;
+    layout.fidelity = pipeFidelity;
+    layout.frictionFactor = pipeFrictionFactor;
+
+    std::vector<float*> tankStoredAmounts;
+    std::vector<float*> engineMassFlowRates;
+    std::vector<float*> engineThrusts;
+    std::vector<float*> controlPointPressures;
+    std::vector<float*> pipePressures;
+    std::vector<float*> pipeMassFlowRates;
+    std::vector<size_t> pipeKeys;
+    std::vector<size_t> componentKeys;
+
+    std::unordered_map<const Control*, std::pair<int, PipeEnd>> pipeEnds;
+    for (int i = 0; i < (int)scene->pipes.size(); i++) {
+        Pipe* pipe = scene->pipes[i];
+        PipeLayout pipeLayout;
+        pipeLayout.length = pipe->path.controls.size() >= 2 ? pipe->path.GetLineLength() : 0.0f;
+        pipeLayout.radius = pipe->radius;
+        pipeLayout.start = pipeLayout.end = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+        if (!pipe->path.controls.empty()) {
+            pipeLayout.start = pipe->path.controls.front().position;
+            pipeLayout.end = pipe->path.controls.back().position;
+            pipeEnds[&pipe->path.controls.front()] = {i, PIPE_START};
+            pipeEnds[&pipe->path.controls.back()] = {i, PIPE_END};
+        }
+
+        //a control point without bevel vertices is drawn as a sharp corner
+        std::vector<glm::vec3> path;
+        std::vector<float> bevelRadii;
+        for (const Control& control : pipe->path.controls) {
+            path.push_back(control.position);
+            bevelRadii.push_back(control.bevelNumber > 0 ? control.bevelRadius : 0.0f);
+        }
+        AddPathBends(i, path, bevelRadii, layout.bends);
+        layout.pipes.push_back(pipeLayout);
+        pipeKeys.push_back((size_t)pipe);
+        pipePressures.push_back(&pipe->totalInternalPressure);
+        pipeMassFlowRates.push_back(&pipe->massFlowRate);
+    }
+
+    //the only place the model types are looked up
+    std::vector<bool> endConnected(2 * scene->pipes.size(), false);
+    auto connect = [&](Control* control, bool outlet) {
+        auto found = pipeEnds.find(control);
+        if (found == pipeEnds.end() || endConnected[2 * found->second.first + found->second.second]) {
+            return;
+        }
+        endConnected[2 * found->second.first + found->second.second] = true;
+        layout.ports.push_back({(int)layout.components.size() - 1, found->second.first, found->second.second, outlet});
+        controlPointPressures.push_back(&control->controlPointPressure);
+    };
+
+    for (Model* model : scene->models) {
+        ComponentLayout component;
+        if (Tank* tank = dynamic_cast<Tank*>(model)) {
+            component.type = TANK_COMPONENT;
+            component.volume = tank->volume;
+            component.storedAmount = tank->storedAmount;
+            component.outletPressure = tank->outletPressure;
+            layout.components.push_back(component);
+            componentKeys.push_back((size_t)model);
+            tankStoredAmounts.push_back(&tank->storedAmount);
+            for (Control* control : tank->connectedControls) {
+                connect(control, false);
+            }
+        }
+        else if (ElectricPump* electricPump = dynamic_cast<ElectricPump*>(model)) {
+            component.type = PUMP_COMPONENT;
+            component.inletPressure = electricPump->inletPressure;
+            component.outletPressure = electricPump->outletPressure;
+            component.maxMassFlowRate = electricPump->maxMassFlowRate;
+            layout.components.push_back(component);
+            componentKeys.push_back((size_t)model);
+            //the second connection point is the outlet. the snap records which point an end took, ends placed
+            //some other way are matched by where they are (the points are relative to the pump)
+            for (Control* control : electricPump->connectedControls) {
+                int point = control->connectionPointIndex != -1 ? control->connectionPointIndex
+                                                                : FindConnectionPoint(electricPump->connectionPoints, electricPump->position, control->position);
+                connect(control, point == 1);
+            }
+        }
+        else if (Engine* engine = dynamic_cast<Engine*>(model)) {
+            component.type = ENGINE_COMPONENT;
+            component.inletPressure = engine->inletPressure;
+            component.mixtureRatio = engine->mixtureRatio;
+            component.throatArea = engine->throatArea;
+            component.volume = engine->chamberVolume;
+            layout.components.push_back(component);
+            componentKeys.push_back((size_t)model);
+            engineMassFlowRates.push_back(&engine->massFlowRate);
+            engineThrusts.push_back(&engine->thrust);
+            for (Control* control : engine->connectedControls) {
+                connect(control, false);
+            }
+        }
+    }
+
+    //a geometry edit leaves the models and ports as they were, so the tables and with them the version stay and
+    //the snapshots keep coming in while a control point is dragged
+    geometryOnly = geometryOnly && scene == m_scene && controlPointPressures.size() == m_controlPointPressures.size();
+
+    //compiled on the simulation thread. when the queue is full the simulation is far behind, the next frame
+    //tries again
+    SimulationCommand command;
+    command.type = REPLACE_SIMULATION;
+    command.layout = std::move(layout);
+    command.pipeKeys = std::move(pipeKeys);
+    command.componentKeys = std::move(componentKeys);
+    command.version = geometryOnly ? m_version : m_version + 1;
+    if (!m_commands.TryPush(std::move(command))) {
+        if (geometryOnly) {
+            return;
+        }
+        //the running simulation no longer matches the scene and its models may be gone, so none of its snapshots
+        //are applied (the version moves on) and nothing points into the old models until the swap goes through
+        m_scene = nullptr;
+        m_version++;
+        m_tankStoredAmounts.clear();
+        m_engineMassFlowRates.clear();
+        m_engineThrusts.clear();
+        m_controlPointPressures.clear();
+        m_pipePressures.clear();
+        m_pipeMassFlowRates.clear();
+        return;
+    }
+    m_topologySignature = ComputeTopologySignature(scene);
+    m_geometrySignature = ComputeGeometrySignature(scene);
+    if (geometryOnly) {
+        return;
+    }
+    m_scene = scene;
+    m_version++;
+    m_tankStoredAmounts = std::move(tankStoredAmounts);
+    m_engineMassFlowRates = std::move(engineMassFlowRates);
+    m_engineThrusts = std::move(engineThrusts);
+    m_controlPointPressures = std::move(controlPointPressures);
+    m_pipePressures = std::move(pipePressures);
+    m_pipeMassFlowRates = std::move(pipeMassFlowRates);
+}
+
+void SimulationPipeline::SetMode(SimulationMode mode) {
+    m_requestedMode = mode;
+    m_modePending = true;
+}
+
+void SimulationPipeline::SetPipeFidelity(int pipe, PipeFidelity fidelity) {
+    m_requestedFidelities.emplace_back(pipe, fidelity);
+}
 
+void SimulationPipeline::RecordTelemetry(const std::string& path) {
+    m_requestedTelemetryPath = path;
+    m_telemetryPending = true;
 }
 
-void SimulationPipeline::StepSimulation(Scene* scene) {
-    //first allow for simulation objects to input and remove pressure from pipes
-    for ( int i = 0; i < scene->models.size(); i++) {
-        if (dynamic_cast<Tank*>(scene->models[i])){
-            Tank* tank = dynamic_cast<Tank*>(scene->models[i]);
-            tank->ComputeControlPointPressure();
+void SimulationPipeline::SynchronizeScene(Scene* scene) {
+    if (scene != m_scene || ComputeTopologySignature(scene) != m_topologySignature) {
+        RegisterScene(scene);
+    }
+    else if (ComputeGeometrySignature(scene) != m_geometrySignature) {
+        SendScene(scene, true);
+    }
+    if (m_modePending) {
+        SimulationCommand command;
+        command.type = SET_MODE;
+        command.mode = m_requestedMode;
+        m_modePending = !m_commands.TryPush(std::move(command));
+    }
+    if (m_telemetryPending) {
+        SimulationCommand command;
+        command.type = SET_TELEMETRY;
+        command.telemetryPath = m_requestedTelemetryPath;
+        m_telemetryPending = !m_commands.TryPush(std::move(command));
+    }
+    //in the order they were asked for, what does not fit in the queue goes out next frame
+    size_t sent = 0;
+    for (; sent < m_requestedFidelities.size(); sent++) {
+        SimulationCommand command;
+        command.type = SET_PIPE_FIDELITY;
+        command.pipe = m_requestedFidelities[sent].first;
+        command.fidelity = m_requestedFidelities[sent].second;
+        if (!m_commands.TryPush(std::move(command))) {
+            break;
         }
-        else if (dynamic_cast<Pump*>(scene->models[i])) {
-            Pump* pump = dynamic_cast<Pump*>(scene->models[i]);
-            if (dynamic_cast<ElectricPump*>(pump)) {
-                ElectricPump* electricPump = dynamic_cast<ElectricPump*>(pump);
-                electricPump->ComputeControlPointPressure();
+    }
+    m_requestedFidelities.erase(m_requestedFidelities.begin(), m_requestedFidelities.begin() + sent);
+
+    //a snapshot of a state that was since replaced does not match the models any more
+    if (!m_snapshots.Acquire()) {
+        return;
+    }
+    const SimulationSnapshot& snapshot = m_snapshots.GetReadBuffer();
+    if (snapshot.version != m_version) {
+        return;
+    }
+    m_activePipeCount = snapshot.activePipeCount;
+    m_lumpedPipeCount = snapshot.lumpedPipeCount;
+    for (int i = 0; i < (int)m_tankStoredAmounts.size(); i++) {
+        *m_tankStoredAmounts[i] = snapshot.tankStoredAmounts[i];
+    }
+    for (int i = 0; i < (int)m_engineMassFlowRates.size(); i++) {
+        *m_engineMassFlowRates[i] = snapshot.engineMassFlowRates[i];
+        *m_engineThrusts[i] = snapshot.engineThrusts[i];
+    }
+    for (int i = 0; i < (int)m_controlPointPressures.size(); i++) {
+        *m_controlPointPressures[i] = snapshot.controlPointPressures[i];
+    }
+    for (int i = 0; i < (int)m_pipePressures.size(); i++) {
+        *m_pipePressures[i] = snapshot.pipePressures[i];
+        *m_pipeMassFlowRates[i] = snapshot.pipeMassFlowRates[i];
+    }
+}
+
+void SimulationPipeline::SimulationLoop() {
+    using Clock = std::chrono::steady_clock;
+    Clock::duration tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(tickTime));
+    Clock::time_point nextTick = Clock::now();
+
+    while (m_running.load(std::memory_order_acquire)) {
+        ApplyCommands();
+
+        //every tick that is due, but no more than maxCatchUpTicks back to back. a simulation that cannot keep
+        //up with the wall clock runs slow instead of falling ever further behind
+        int ticks = 0;
+        for (; ticks < maxCatchUpTicks && Clock::now() >= nextTick; ticks++) {
+            if (m_simulation) {
+                m_simulation->Advance(tickTime, maxSubSteps);
             }
+            nextTick += tick;
+        }
+        if (ticks == maxCatchUpTicks) {
+            nextTick = std::max(nextTick, Clock::now());
         }
-        else if (dynamic_cast<Engine*>(scene->models[i])) {
-            Engine* engine = dynamic_cast<Engine*>(scene->models[i]);
-            engine->ComputeControlPointPressure();
+        if (ticks > 0 && m_simulation) {
+            m_simulation->WriteSnapshot(m_snapshots.GetWriteBuffer());
+            m_snapshots.Publish();
         }
+
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void SimulationPipeline::ApplyCommands() {
+    //of layouts sent back to back (a control point dragged across several frames) only the newest is compiled,
+    //the commands after one still apply to it
+    SimulationCommand command;
+    SimulationCommand replacement;
+    bool replacing = false;
+    while (m_commands.TryPop(command)) {
+        if (command.type == REPLACE_SIMULATION) {
+            replacement = std::move(command);
+            replacing = true;
+            continue;
+        }
+        if (replacing) {
+            ReplaceSimulation(replacement);
+            replacing = false;
+        }
+        if (command.type == SET_MODE) {
+            m_mode = command.mode;
+        }
+        else if (command.type == SET_TELEMETRY) {
+            m_telemetryPath = command.telemetryPath;
+            RestartTelemetry();
+        }
+        else if (command.type == SET_PIPE_FIDELITY && m_simulation) {
+            m_simulation->SetPipeFidelity(command.pipe, command.fidelity);
+        }
+        if (m_simulation) {
+            m_simulation->mode = m_mode;
+        }
+    }
+    if (replacing) {
+        ReplaceSimulation(replacement);
+        m_simulation->mode = m_mode;
+    }
+}
+
+void SimulationPipeline::ReplaceSimulation(const SimulationCommand& command) {
+    auto simulation = std::make_unique<NetworkSimulation>();
+    simulation->Compile(command.layout);
+    simulation->version = command.version;
+    simulation->SetThreadPool(m_threadPool.get());
+    simulation->SetCombustionTable(&m_combustionTable);
+
+    //the pipes and components the scene kept take the state they had
+    if (m_simulation) {
+        auto findSources = [](const std::vector<size_t>& keys, const std::vector<size_t>& previousKeys) {
+            std::unordered_map<size_t, int> previous;
+            for (int i = 0; i < (int)previousKeys.size(); i++) {
+                previous[previousKeys[i]] = i;
+            }
+            std::vector<int> sources(keys.size(), -1);
+            for (size_t i = 0; i < keys.size(); i++) {
+                auto found = previous.find(keys[i]);
+                sources[i] = found != previous.end() ? found->second : -1;
+            }
+            return sources;
+        };
+        simulation->CarryState(*m_simulation, findSources(command.pipeKeys, m_pipeKeys), findSources(command.componentKeys, m_componentKeys));
+    }
+    m_simulation = std::move(simulation);
+    m_pipeKeys = command.pipeKeys;
+    m_componentKeys = command.componentKeys;
+
+    //the file stays open as long as the channels it was opened with are still the same
+    if (m_telemetry && m_simulation->GetTelemetryChannels() == m_telemetryChannels) {
+        m_simulation->SetTelemetry(m_telemetry.get());
+        return;
+    }
+    RestartTelemetry();
+}
+
+void SimulationPipeline::RestartTelemetry() {
+    //closing writes out what the last file still buffered
+    if (m_simulation) {
+        m_simulation->SetTelemetry(nullptr);
+    }
+    m_telemetry.reset();
+    m_telemetryChannels.clear();
+    if (m_telemetryPath.empty() || !m_simulation) {
+        return;
     }
 
-    //now compute the final pressure of the pipes
-    for (int i = 0; i < scene->pipes.size(); i++) {
-        Pipe* p = scene->pipes[i];
-        p->totalInternalPressure = (p->path.controls[0].controlPointPressure + p->path.controls[1].controlPointPressure) / 2.0f;
+    m_telemetry = std::make_unique<TelemetryWriter>();
+    std::string path = m_telemetryPath + "." + std::to_string(m_simulation->version);
+    std::string error;
+    m_telemetryChannels = m_simulation->GetTelemetryChannels();
+    if (!m_telemetry->Open(path, m_telemetryChannels, error)) {
+        std::cerr << error << std::endl;
+        m_telemetry.reset();
+        m_telemetryChannels.clear();
+        return;
     }
+    m_simulation->SetTelemetry(m_telemetry.get());
 }
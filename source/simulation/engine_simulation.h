@@ -6,18 +6,31 @@
 
 #ifndef ENGINE_SIMULATION_H
 #define ENGINE_SIMULATION_H
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "network_simulation.h"
+#include "telemetry.h"
+#include "../core/spsc_queue.h"
+#include "../core/thread_pool.h"
+#include "../core/triple_buffer.h"
 #include "../graphics/graphics_objects.h"
 
 #endif //ENGINE_SIMULATION_H
 
+//model pressures are gauge pressures, relative to SimulationPipeline::ambientPressure
 struct Tank : Model {
     Gas storedGas = {};
     float volume = 0.0f;
     float storedAmount = 0.0f;;
+    float outletPressure = 10.0f;
 
     Tank(Gas storedGas, float volume, float storedAmount);
-
-    void ComputeControlPointPressure();
 };
 
 struct Pump : Model {
@@ -25,22 +38,174 @@ struct Pump : Model {
 };
 
 struct ElectricPump : Pump {
-    ElectricPump();
+    //pipes ending on connection point 0 are the inlet, on connection point 1 the outlet. the difference of
+    //the two is the pressure rise of the pump
+    float inletPressure = -5.0f;
+    float outletPressure = 5.0f;
+
+    //flow at which the rise has fallen to zero, the end of the pump curve the steady state solver uses
+    float maxMassFlowRate = 2.0f;
 
-    void ComputeControlPointPressure();
+    ElectricPump();
 };
 
 struct Engine : Model {
+    //chamber pressure the feed lines discharge into, where the chamber starts when it has a throat
+    float inletPressure = -0.5f;
+
+    //a throat makes the chamber burn what it is fed at the mixture ratio (oxidizer to fuel mass), see
+    //NetworkSimulation::SetCombustionTable. 0 holds it at inletPressure
+    float mixtureRatio = 2.6f;
+    float throatArea = 0.0f;
+    float chamberVolume = 1.0f;
+
+    //propellant consumed per unit time and the thrust it makes, written by the simulation
+    float massFlowRate = 0.0f;
+    float thrust = 0.0f;
+
     Engine();
+};
+
+enum SimulationCommandType {
+    REPLACE_SIMULATION,
+    SET_MODE,
+    SET_TELEMETRY,
+    SET_PIPE_FIDELITY
+};
 
-    void ComputeControlPointPressure();
+struct SimulationCommand {
+    SimulationCommandType type = REPLACE_SIMULATION;
+    //the layout to compile, the scene objects (by address) its pipes and components came from, which is what
+    //the state is carried across by, and the version the snapshots of the new simulation carry
+    NetworkLayout layout;
+    std::vector<size_t> pipeKeys;
+    std::vector<size_t> componentKeys;
+    unsigned long long version = 0;
+    SimulationMode mode = TRANSIENT;
+    std::string telemetryPath;
+    int pipe = -1;
+    PipeFidelity fidelity = RESOLVED_FIDELITY;
 };
 
+//the scene is turned into a NetworkLayout (the only place the model types are looked up), plus a flat table of
+//the model fields each snapshot entry is reported back to. the layout is compiled into a NetworkSimulation on
+//the simulation thread, which carries the state of the pipes and models the scene kept over to it
+//(NetworkSimulation::CarryState), so an edit does not start the whole network over from ambient.
+//
+//the simulation runs on its own thread in ticks of a fixed simulated time, each split into CFL limited sub
+//steps, and paced against the wall clock, so neither a stalled frame nor a heavy step holds up the other
+//side. the two threads share nothing but two lock-free channels:
+//  - the editor keeps changing the scene (pipes are extruded, connected and deleted), so SynchronizeScene
+//    rebuilds the layout whenever the scene's topology (object counts and the storage the connections point
+//    into) or geometry (the pipes' radii and control points) changes and sends it, like every other edit,
+//    through a single producer command queue. a geometry edit keeps the version, the simulation only compiles
+//    the newest layout it finds queued, so dragging a control point neither restarts the scene nor telemetry
+//  - after every batch of ticks the simulation publishes a snapshot into a triple buffer, which
+//    SynchronizeScene copies into the models once it belongs to the scene as currently compiled
 class SimulationPipeline {
 private:
+    //editor thread
+    Scene* m_scene = nullptr;
+    size_t m_topologySignature = 0;
+    size_t m_geometrySignature = 0;
+    unsigned long long m_version = 0;
+    SimulationMode m_requestedMode = TRANSIENT;
+    bool m_modePending = false;
+    int m_activePipeCount = 0;
+    int m_lumpedPipeCount = 0;
+    std::string m_requestedTelemetryPath;
+    bool m_telemetryPending = false;
+    std::vector<std::pair<int, PipeFidelity>> m_requestedFidelities;
+
+    //the model fields the snapshot entries are copied into
+    std::vector<float*> m_tankStoredAmounts;
+    std::vector<float*> m_engineMassFlowRates;
+    std::vector<float*> m_engineThrusts;
+    std::vector<float*> m_controlPointPressures;
+    std::vector<float*> m_pipePressures;
+    std::vector<float*> m_pipeMassFlowRates;
+
+    //shared
+    SpscQueue<SimulationCommand, 64> m_commands;
+    TripleBuffer<SimulationSnapshot> m_snapshots;
+    std::atomic<bool> m_running = false;
+
+    //simulation thread
+    std::thread m_thread;
+    std::unique_ptr<ThreadPool> m_threadPool;
+    std::unique_ptr<TelemetryWriter> m_telemetry;
+    std::vector<std::string> m_telemetryChannels;   //the open file's
+    std::string m_telemetryPath;
+    std::unique_ptr<NetworkSimulation> m_simulation;
+    std::vector<size_t> m_pipeKeys;         //of m_simulation, see SimulationCommand
+    std::vector<size_t> m_componentKeys;
+    SimulationMode m_mode = TRANSIENT;
+    CombustionTable m_combustionTable;      //filled by Initialize, only read after
+
+    static size_t ComputeTopologySignature(const Scene* scene);
+    static size_t ComputeGeometrySignature(const Scene* scene);
+
+    //geometryOnly sends the layout under the current version and leaves the model tables as they are, unless
+    //the ports changed after all
+    void SendScene(Scene* scene, bool geometryOnly);
+
+    void SimulationLoop();
+    void ApplyCommands();
+    void ReplaceSimulation(const SimulationCommand& command);
+    void RestartTelemetry();
 
 public:
+    float ambientPressure = 1.0f;
+    float ambientDensity = 1.0f;
+
+    //region length the pipes are resolved with, the simulated (and wall clock) time of a tick and the most CFL
+    //sub steps it is split into, and how many ticks the simulation may run back to back to catch up before it
+    //drops the time it is behind. set before Initialize
+    float pipeRegionSize = 0.05f;
+    float tickTime = 1.0f / 60.0f;
+    int maxSubSteps = 64;
+    int maxCatchUpTicks = 4;
+
+    //pipes whose conservatives change by less than this per sub step sleep until a node disturbs them, see
+    //PipeNetwork. 0 steps every pipe always
+    float sleepTolerance = 1e-5f;
+
+    //how the pipes are modelled when the scene is compiled: adaptive pipes run lumped and are resolved while
+    //the pressures along them differ, see PipeNetwork
+    PipeFidelity pipeFidelity = ADAPTIVE_FIDELITY;
+
+    //darcy friction factor of the pipe walls, turbulent flow in a smooth pipe. the walls, the bends of the
+    //pipe paths and the heat the walls exchange then shape the flow, 0 leaves the pipes frictionless
+    float pipeFrictionFactor = 0.02f;
+
+    //the combustion table engines with a throat burn by, the generated one when empty or unreadable. set
+    //before Initialize
+    std::string combustionTablePath;
+
+    //starts the simulation thread
     void Initialize();
+
+    //hands the scene's layout to the simulation, which compiles it and carries the state of the pipes and models
+    //it already had over. new ones start from ambient conditions
     void RegisterScene(Scene* scene);
-    void StepSimulation(Scene* scene);
+
+    //called once per frame on the editor thread: sends the layout of edited scenes (RegisterScene when the
+    //topology changed), and copies the latest snapshot into the models. never waits for the simulation
+    void SynchronizeScene(Scene* scene);
+
+    void SetMode(SimulationMode mode);
+
+    //switches one pipe (by its index in the scene, -1 for all of them) while the simulation runs. it keeps the
+    //fidelity across edits of the scene, pipes added later take pipeFidelity
+    void SetPipeFidelity(int pipe, PipeFidelity fidelity);
+
+    //resolved pipes the simulation stepped at the latest snapshot, the others were asleep or lumped
+    int GetActivePipeCount() const { return m_activePipeCount; }
+    int GetLumpedPipeCount() const { return m_lumpedPipeCount; }
+
+    //records every pipe and component at every sub step to "<path>.<scene version>", a new file whenever pipes
+    //or components are added or removed (the channels change with them). an empty path stops recording
+    void RecordTelemetry(const std::string& path);
+
+    ~SimulationPipeline();
 };
\ No newline at end of file
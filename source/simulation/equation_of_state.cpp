@@ -0,0 +1,64 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "equation_of_state.h"
+
+#include <algorithm>
+#include <cmath>
+
+//specific internal energy and cv / R of the model at a temperature, the energy integrated from 0 K
+static double ModelEnergy(const GasModel& model, double temperature, double& heatCapacity) {
+    const double* c = model.heatCapacity;
+    heatCapacity = c[0] - 1.0 + temperature * (c[1] + temperature * (c[2] + temperature * c[3]));
+    return temperature * ((c[0] - 1.0) + temperature * (c[1] / 2.0 + temperature * (c[2] / 3.0 + temperature * c[3] / 4.0)));
+}
+
+template<typename Real>
+void GasPropertyTable<Real>::Build(const GasModel& model, int size) {
+    size = std::max(size, 2);
+    double minTemperature = model.minTemperature;
+    double maxTemperature = std::max(model.maxTemperature, model.minTemperature * (1.0 + 1e-6));
+    double heatCapacity;
+    double minEnergy = ModelEnergy(model, minTemperature, heatCapacity);
+    double maxEnergy = ModelEnergy(model, maxTemperature, heatCapacity);
+
+    m_minEnergy = (Real)minEnergy;
+    m_energyScale = (Real)((size - 1) / (maxEnergy - minEnergy));
+    m_minTemperature = (Real)minTemperature;
+    m_temperatureScale = (Real)((size - 1) / (maxTemperature - minTemperature));
+    m_lastPosition = (Real)(size - 1);
+    m_covolume = (Real)model.covolume;
+
+    m_energies.resize(size + 1);
+    for (int i = 0; i < size; i++) {
+        double temperature = minTemperature + (maxTemperature - minTemperature) * i / (size - 1);
+        m_energies[i] = (Real)ModelEnergy(model, temperature, heatCapacity);
+    }
+
+    //the energy is monotonic as long as cv stays positive, newton from the last point converges in a few steps
+    m_temperatures.resize(size + 1);
+    m_exponents.resize(size + 1);
+    double temperature = minTemperature;
+    for (int i = 0; i < size; i++) {
+        double energy = minEnergy + (maxEnergy - minEnergy) * i / (size - 1);
+        for (int iteration = 0; iteration < 20; iteration++) {
+            double error = ModelEnergy(model, temperature, heatCapacity) - energy;
+            temperature = std::min(std::max(temperature - error / heatCapacity, minTemperature), maxTemperature);
+            if (std::abs(error) <= 1e-12 * std::abs(energy)) {
+                break;
+            }
+        }
+        ModelEnergy(model, temperature, heatCapacity);
+        m_temperatures[i] = (Real)temperature;
+        m_exponents[i] = (Real)((heatCapacity + 1.0) / heatCapacity);
+    }
+
+    //the position of the last point reads one past it
+    m_energies[size] = m_energies[size - 1];
+    m_temperatures[size] = m_temperatures[size - 1];
+    m_exponents[size] = m_exponents[size - 1];
+}
+
+template class GasPropertyTable<float>;
+template class GasPropertyTable<double>;
@@ -0,0 +1,157 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef EQUATION_OF_STATE_H
+#define EQUATION_OF_STATE_H
+
+#include <vector>
+
+#include "simd.h"
+
+#endif //EQUATION_OF_STATE_H
+
+//what a gas property table is built from: a thermally perfect gas, whose cp / R is a cubic in the temperature,
+//with a Noble-Abel covolume as its real gas correction, p = rho R T / (1 - covolume rho). temperatures are R T
+//(p / rho of the dilute gas) in the simulation's units, so the ambient is at 1, and energies are per unit mass
+//in the same units
+struct GasModel {
+    double heatCapacity[4] = {3.5, 0.0, 0.0, 0.0};     //cp / R = c0 + c1 T + c2 T^2 + c3 T^3, 3.5 is gamma 1.4
+    double covolume = 0.0;
+    double minTemperature = 0.02;
+    double maxTemperature = 50.0;
+};
+
+//the properties of a GasModel precomputed on uniform grids, so a lookup is a multiply, a truncation and one
+//linear interpolation (a gather per end of the interval on vector units that have one) instead of solving
+//for the temperature. the temperature and the ratio of specific heats are tabulated over the specific
+//internal energy, the energy over the temperature for the way back from a pressure. outside the grids the
+//properties of its ends are used.
+//the tables are small enough (three arrays of the size) to stay in the first level cache of every thread
+//stepping with them, which is what keeps the lookups cheap, so there is no cache of recent lookups in front
+template<typename Real>
+class GasPropertyTable {
+    std::vector<Real> m_temperatures;       //uniform in specific internal energy, one repeated entry at the end
+    std::vector<Real> m_exponents;
+    std::vector<Real> m_energies;           //uniform in temperature
+    Real m_minEnergy = 0, m_energyScale = 0;
+    Real m_minTemperature = 0, m_temperatureScale = 0;
+    Real m_lastPosition = 0;
+    Real m_covolume = 0;
+
+    template<typename P>
+    P Position(P value, Real offset, Real scale) const {
+        return Min(Max((value - P(offset)) * P(scale), P(Real(0))), P(m_lastPosition));
+    }
+
+public:
+    void Build(const GasModel& model, int size = 1024);
+
+    bool IsEmpty() const { return m_temperatures.empty(); }
+    Real GetCovolume() const { return m_covolume; }
+
+    template<typename P>
+    P Temperature(P specificEnergy) const { return InterpolateTable(m_temperatures.data(), Position(specificEnergy, m_minEnergy, m_energyScale)); }
+
+    //cp / cv
+    template<typename P>
+    P Exponent(P specificEnergy) const { return InterpolateTable(m_exponents.data(), Position(specificEnergy, m_minEnergy, m_energyScale)); }
+
+    template<typename P>
+    void Properties(P specificEnergy, P& temperature, P& exponent) const {
+        InterpolateTables(m_temperatures.data(), m_exponents.data(), Position(specificEnergy, m_minEnergy, m_energyScale), temperature, exponent);
+    }
+
+    template<typename P>
+    P SpecificEnergy(P temperature) const { return InterpolateTable(m_energies.data(), Position(temperature, m_minTemperature, m_temperatureScale)); }
+};
+
+//equation of state policies of the solvers (flux_kernels.h, reconstruction.h, boundary_conditions.h,
+//BasicGasSimulation). every method is written against the pack interface, so it runs on a single lane or a
+//whole vector of regions. energies are internal energy per unit volume, E - rho u^2 / 2
+
+//calorically perfect gas, the constant gamma the solvers have always used
+template<typename Real>
+struct PerfectGas {
+    Real gamma;
+
+    template<typename P>
+    P Pressure(P density, P internalEnergy) const { return (P(gamma) - P(Real(1))) * internalEnergy; }
+
+    template<typename P>
+    P SoundSpeed(P density, P internalEnergy, P pressure) const { return Sqrt(P(gamma) * pressure / density); }
+
+    //both of the above, for the flux kernels that always need the two
+    template<typename P>
+    void State(P density, P internalEnergy, P& pressure, P& soundSpeed) const {
+        pressure = Pressure(density, internalEnergy);
+        soundSpeed = SoundSpeed(density, internalEnergy, pressure);
+    }
+
+    template<typename P>
+    P InternalEnergy(P density, P pressure) const { return pressure / (P(gamma) - P(Real(1))); }
+
+    //R T, in the units of GasModel temperatures
+    template<typename P>
+    P Temperature(P density, P pressure) const { return pressure / density; }
+
+    //gamma of the perfect gas with the same pressure at this state, what the linearisations take
+    template<typename P>
+    P EnergyGamma(P density, P internalEnergy, P pressure) const { return P(gamma); }
+
+    //sound speed of the roe averaged state, from its specific total enthalpy and velocity (and the weights and
+    //sound speeds of the two sides, which only a general gas needs)
+    template<typename P>
+    P RoeSoundSpeed(P enthalpy, P velocity, P leftSoundSpeed, P rightSoundSpeed, P leftWeight, P rightWeight) const {
+        return Sqrt((P(gamma) - P(Real(1))) * (enthalpy - P(Real(0.5)) * velocity * velocity));
+    }
+};
+
+//a GasPropertyTable, which has to outlive the simulation using it
+template<typename Real>
+struct TabulatedGas {
+    const GasPropertyTable<Real>* table;
+
+    template<typename P>
+    P Pressure(P density, P internalEnergy) const {
+        P covolume = P(Real(1)) - P(table->GetCovolume()) * density;
+        return density * table->Temperature(internalEnergy / density) / covolume;
+    }
+
+    //c^2 = (cp / cv) (dp / drho) at constant temperature
+    template<typename P>
+    P SoundSpeed(P density, P internalEnergy, P pressure) const {
+        P covolume = P(Real(1)) - P(table->GetCovolume()) * density;
+        return Sqrt(table->Exponent(internalEnergy / density) * pressure / (density * covolume));
+    }
+
+    //one lookup for both, c = sqrt(cp / cv T) / (1 - covolume rho)
+    template<typename P>
+    void State(P density, P internalEnergy, P& pressure, P& soundSpeed) const {
+        P inverseCovolume = P(Real(1)) / (P(Real(1)) - P(table->GetCovolume()) * density);
+        P temperature, exponent;
+        table->Properties(internalEnergy / density, temperature, exponent);
+        pressure = density * temperature * inverseCovolume;
+        soundSpeed = Sqrt(exponent * temperature) * inverseCovolume;
+    }
+
+    template<typename P>
+    P InternalEnergy(P density, P pressure) const {
+        P covolume = P(Real(1)) - P(table->GetCovolume()) * density;
+        return density * table->SpecificEnergy(pressure * covolume / density);
+    }
+
+    template<typename P>
+    P Temperature(P density, P pressure) const { return pressure * (P(Real(1)) - P(table->GetCovolume()) * density) / density; }
+
+    template<typename P>
+    P EnergyGamma(P density, P internalEnergy, P pressure) const { return P(Real(1)) + pressure / internalEnergy; }
+
+    //the roe weighted mean of the two sides' sound speeds, the roe average has no closed form for a general gas
+    template<typename P>
+    P RoeSoundSpeed(P enthalpy, P velocity, P leftSoundSpeed, P rightSoundSpeed, P leftWeight, P rightWeight) const {
+        return (leftWeight * leftSoundSpeed + rightWeight * rightSoundSpeed) / (leftWeight + rightWeight);
+    }
+};
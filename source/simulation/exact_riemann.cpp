@@ -0,0 +1,112 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "exact_riemann.h"
+
+#include <algorithm>
+#include <cmath>
+
+ExactRiemannSolver::ExactRiemannSolver(RiemannState left, RiemannState right, double gamma) : m_left(left), m_right(right), m_gamma(gamma) {
+    m_leftSoundSpeed = std::sqrt(gamma * left.pressure / left.density);
+    m_rightSoundSpeed = std::sqrt(gamma * right.pressure / right.density);
+    SolveStarRegion();
+}
+
+double ExactRiemannSolver::PressureFunction(double p, const RiemannState& side, double soundSpeed, double& derivative) const {
+    double g = m_gamma;
+    if (p > side.pressure) {
+        //shock
+        double A = 2.0 / ((g + 1.0) * side.density);
+        double B = (g - 1.0) / (g + 1.0) * side.pressure;
+        double root = std::sqrt(A / (p + B));
+        derivative = root * (1.0 - (p - side.pressure) / (2.0 * (B + p)));
+        return (p - side.pressure) * root;
+    }
+
+    //rarefaction
+    double ratio = p / side.pressure;
+    derivative = std::pow(ratio, -(g + 1.0) / (2.0 * g)) / (side.density * soundSpeed);
+    return 2.0 * soundSpeed / (g - 1.0) * (std::pow(ratio, (g - 1.0) / (2.0 * g)) - 1.0);
+}
+
+void ExactRiemannSolver::SolveStarRegion() {
+    double deltaVelocity = m_right.velocity - m_left.velocity;
+
+    //primitive variable guess, then newton on f_L(p) + f_R(p) + du = 0
+    double p = 0.5 * (m_left.pressure + m_right.pressure) - 0.125 * deltaVelocity * (m_left.density + m_right.density) * (m_leftSoundSpeed + m_rightSoundSpeed);
+    p = std::max(p, 1e-8);
+
+    double fL = 0.0, fR = 0.0;
+    for (int iteration = 0; iteration < 100; iteration++) {
+        double dL, dR;
+        fL = PressureFunction(p, m_left, m_leftSoundSpeed, dL);
+        fR = PressureFunction(p, m_right, m_rightSoundSpeed, dR);
+
+        double next = std::max(p - (fL + fR + deltaVelocity) / (dL + dR), 1e-8);
+        double change = 2.0 * std::abs(next - p) / (next + p);
+        p = next;
+        if (change < 1e-12) {
+            break;
+        }
+    }
+
+    double derivative;
+    fL = PressureFunction(p, m_left, m_leftSoundSpeed, derivative);
+    fR = PressureFunction(p, m_right, m_rightSoundSpeed, derivative);
+    m_starPressure = p;
+    m_starVelocity = 0.5 * (m_left.velocity + m_right.velocity) + 0.5 * (fR - fL);
+}
+
+RiemannState ExactRiemannSolver::Sample(double s) const {
+    double g = m_gamma;
+    double pStar = m_starPressure;
+    double uStar = m_starVelocity;
+
+    //mirror the right going problem onto the left one so only one set of formulas is needed
+    bool leftSide = s <= uStar;
+    const RiemannState& side = leftSide ? m_left : m_right;
+    double c = leftSide ? m_leftSoundSpeed : m_rightSoundSpeed;
+    double sign = leftSide ? 1.0 : -1.0;
+    double u = sign * side.velocity;
+    double x = sign * s;
+    double us = sign * uStar;
+
+    RiemannState result;
+    if (pStar > side.pressure) {
+        //shock
+        double ratio = pStar / side.pressure;
+        double shockSpeed = u - c * std::sqrt((g + 1.0) / (2.0 * g) * ratio + (g - 1.0) / (2.0 * g));
+        if (x <= shockSpeed) {
+            result = side;
+        }
+        else {
+            double gm = (g - 1.0) / (g + 1.0);
+            result.density = side.density * (ratio + gm) / (gm * ratio + 1.0);
+            result.velocity = sign * us;
+            result.pressure = pStar;
+        }
+        return result;
+    }
+
+    //rarefaction
+    double cStar = c * std::pow(pStar / side.pressure, (g - 1.0) / (2.0 * g));
+    double head = u - c;
+    double tail = us - cStar;
+    if (x <= head) {
+        result = side;
+    }
+    else if (x >= tail) {
+        result.density = side.density * std::pow(pStar / side.pressure, 1.0 / g);
+        result.velocity = sign * us;
+        result.pressure = pStar;
+    }
+    else {
+        //inside the fan
+        double factor = 2.0 / (g + 1.0) + (g - 1.0) / ((g + 1.0) * c) * (u - x);
+        result.density = side.density * std::pow(factor, 2.0 / (g - 1.0));
+        result.velocity = sign * 2.0 / (g + 1.0) * (c + (g - 1.0) / 2.0 * u + x);
+        result.pressure = side.pressure * std::pow(factor, 2.0 * g / (g - 1.0));
+    }
+    return result;
+}
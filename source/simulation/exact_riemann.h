@@ -0,0 +1,40 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef EXACT_RIEMANN_H
+#define EXACT_RIEMANN_H
+
+#endif //EXACT_RIEMANN_H
+
+struct RiemannState {
+    double density = 1.0;
+    double velocity = 0.0;
+    double pressure = 1.0;
+};
+
+//exact solution of the 1D Euler riemann problem for an ideal gas (Toro, chapter 4), used as the reference
+//solution when measuring the error of the gas simulation
+class ExactRiemannSolver {
+    RiemannState m_left;
+    RiemannState m_right;
+    double m_gamma;
+    double m_leftSoundSpeed;
+    double m_rightSoundSpeed;
+    double m_starPressure = 0.0;
+    double m_starVelocity = 0.0;
+
+    double PressureFunction(double p, const RiemannState& side, double soundSpeed, double& derivative) const;
+    void SolveStarRegion();
+
+public:
+    ExactRiemannSolver(RiemannState left, RiemannState right, double gamma = 1.4);
+
+    double GetStarPressure() const { return m_starPressure; }
+    double GetStarVelocity() const { return m_starVelocity; }
+
+    //state at similarity coordinate s = (x - x0) / t
+    RiemannState Sample(double s) const;
+};
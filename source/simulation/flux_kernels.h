@@ -0,0 +1,227 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef FLUX_KERNELS_H
+#define FLUX_KERNELS_H
+
+#include "equation_of_state.h"
+#include "simd.h"
+
+#endif //FLUX_KERNELS_H
+
+//approximate riemann solvers, used as compile time flux policies by BasicGasSimulation. each Compute takes
+//the conservative states on either side of an interface, writes the interface flux and returns the largest
+//signal speed it saw so the CFL reduction can ride along with the flux sweep. they are written against the
+//pack interface in simd.h so the same code runs on a single lane or a full vector of interfaces, and take the
+//gas as an equation of state policy (equation_of_state.h)
+
+//primitive state on one side of an interface, shared by every flux below
+template<typename P>
+struct FluxSide {
+    P density;
+    P momentum;
+    P energy;
+    P velocity;
+    P pressure;
+    P soundSpeed;
+
+    template<typename Eos>
+    FluxSide(P density, P momentum, P energy, const Eos& eos) : density(density), momentum(momentum), energy(energy) {
+        velocity = momentum / density;
+        eos.State(density, energy - P(0.5) * momentum * velocity, pressure, soundSpeed);
+    }
+
+    P MassFlux() const { return momentum; }
+    P MomentumFlux() const { return momentum * velocity + pressure; }
+    P EnergyFlux() const { return velocity * (energy + pressure); }
+};
+
+//local Lax-Friedrichs, the most diffusive and cheapest option
+struct RusanovFlux {
+    template<typename P, typename Eos>
+    static P Compute(const FluxSide<P>& l, const FluxSide<P>& r, const Eos& eos, P& massFlux, P& momentumFlux, P& energyFlux) {
+        P half = 0.5;
+        P S = Max(Abs(l.velocity) + l.soundSpeed, Abs(r.velocity) + r.soundSpeed);
+
+        massFlux = half * (l.MassFlux() + r.MassFlux()) - half * S * (r.density - l.density);
+        momentumFlux = half * (l.MomentumFlux() + r.MomentumFlux()) - half * S * (r.momentum - l.momentum);
+        energyFlux = half * (l.EnergyFlux() + r.EnergyFlux()) - half * S * (r.energy - l.energy);
+        return S;
+    }
+};
+
+//two wave HLL with Davis wave speed estimates
+struct HLLFlux {
+    template<typename P, typename Eos>
+    static P Compute(const FluxSide<P>& l, const FluxSide<P>& r, const Eos& eos, P& massFlux, P& momentumFlux, P& energyFlux) {
+        P zero = 0.0;
+
+        P SL = Min(l.velocity - l.soundSpeed, r.velocity - r.soundSpeed);
+        P SR = Max(l.velocity + l.soundSpeed, r.velocity + r.soundSpeed);
+
+        //star region flux, then pick the upwind flux where both waves travel the same way
+        P inverseWidth = P(1.0) / (SR - SL);
+        P F0 = (SR * l.MassFlux() - SL * r.MassFlux() + SL * SR * (r.density - l.density)) * inverseWidth;
+        P F1 = (SR * l.MomentumFlux() - SL * r.MomentumFlux() + SL * SR * (r.momentum - l.momentum)) * inverseWidth;
+        P F2 = (SR * l.EnergyFlux() - SL * r.EnergyFlux() + SL * SR * (r.energy - l.energy)) * inverseWidth;
+
+        P leftSupersonic = GreaterEqual(SL, zero);
+        P rightSupersonic = LessEqual(SR, zero);
+        massFlux = Select(leftSupersonic, l.MassFlux(), Select(rightSupersonic, r.MassFlux(), F0));
+        momentumFlux = Select(leftSupersonic, l.MomentumFlux(), Select(rightSupersonic, r.MomentumFlux(), F1));
+        energyFlux = Select(leftSupersonic, l.EnergyFlux(), Select(rightSupersonic, r.EnergyFlux(), F2));
+
+        return Max(Abs(SL), Abs(SR));
+    }
+};
+
+//HLL with the contact wave restored (Toro), resolves contact discontinuities far better than HLL
+struct HLLCFlux {
+    template<typename P>
+    static void StarFlux(const FluxSide<P>& s, P S, P SM, P& massFlux, P& momentumFlux, P& energyFlux) {
+        P factor = s.density * (S - s.velocity) / (S - SM);
+        P starDensity = factor;
+        P starMomentum = factor * SM;
+        P starEnergy = factor * (s.energy / s.density + (SM - s.velocity) * (SM + s.pressure / (s.density * (S - s.velocity))));
+
+        massFlux = s.MassFlux() + S * (starDensity - s.density);
+        momentumFlux = s.MomentumFlux() + S * (starMomentum - s.momentum);
+        energyFlux = s.EnergyFlux() + S * (starEnergy - s.energy);
+    }
+
+    template<typename P, typename Eos>
+    static P Compute(const FluxSide<P>& l, const FluxSide<P>& r, const Eos& eos, P& massFlux, P& momentumFlux, P& energyFlux) {
+        P zero = 0.0;
+
+        P SL = Min(l.velocity - l.soundSpeed, r.velocity - r.soundSpeed);
+        P SR = Max(l.velocity + l.soundSpeed, r.velocity + r.soundSpeed);
+
+        //contact speed
+        P leftMass = l.density * (SL - l.velocity);
+        P rightMass = r.density * (SR - r.velocity);
+        P SM = (r.pressure - l.pressure + l.momentum * (SL - l.velocity) - r.momentum * (SR - r.velocity)) / (leftMass - rightMass);
+
+        P starL0, starL1, starL2, starR0, starR1, starR2;
+        StarFlux(l, SL, SM, starL0, starL1, starL2);
+        StarFlux(r, SR, SM, starR0, starR1, starR2);
+
+        P leftSupersonic = GreaterEqual(SL, zero);
+        P rightSupersonic = LessEqual(SR, zero);
+        P leftOfContact = GreaterEqual(SM, zero);
+        massFlux = Select(leftSupersonic, l.MassFlux(), Select(rightSupersonic, r.MassFlux(), Select(leftOfContact, starL0, starR0)));
+        momentumFlux = Select(leftSupersonic, l.MomentumFlux(), Select(rightSupersonic, r.MomentumFlux(), Select(leftOfContact, starL1, starR1)));
+        energyFlux = Select(leftSupersonic, l.EnergyFlux(), Select(rightSupersonic, r.EnergyFlux(), Select(leftOfContact, starL2, starR2)));
+
+        return Max(Abs(SL), Abs(SR));
+    }
+};
+
+//Roe linearisation with the Harten entropy fix on the acoustic waves
+struct RoeFlux {
+    template<typename P>
+    static P EntropyFix(P lambda, P delta) {
+        P magnitude = Abs(lambda);
+        return Select(GreaterEqual(magnitude, delta), magnitude, (lambda * lambda + delta * delta) / (P(2.0) * delta));
+    }
+
+    template<typename P, typename Eos>
+    static P Compute(const FluxSide<P>& l, const FluxSide<P>& r, const Eos& eos, P& massFlux, P& momentumFlux, P& energyFlux) {
+        P half = 0.5;
+
+        //roe averages
+        P weightL = Sqrt(l.density);
+        P weightR = Sqrt(r.density);
+        P inverseWeight = P(1.0) / (weightL + weightR);
+        P u = (weightL * l.velocity + weightR * r.velocity) * inverseWeight;
+        P HL = (l.energy + l.pressure) / l.density;
+        P HR = (r.energy + r.pressure) / r.density;
+        P H = (weightL * HL + weightR * HR) * inverseWeight;
+        P c = eos.RoeSoundSpeed(H, u, l.soundSpeed, r.soundSpeed, weightL, weightR);
+        P rho = weightL * weightR;
+
+        //wave strengths
+        P dRho = r.density - l.density;
+        P dU = r.velocity - l.velocity;
+        P dP = r.pressure - l.pressure;
+        P inverseC2 = P(1.0) / (c * c);
+        P alpha1 = half * (dP - rho * c * dU) * inverseC2;
+        P alpha2 = dRho - dP * inverseC2;
+        P alpha3 = half * (dP + rho * c * dU) * inverseC2;
+
+        P delta = P(0.1) * c;
+        P lambda1 = EntropyFix(u - c, delta) * alpha1;
+        P lambda2 = Abs(u) * alpha2;
+        P lambda3 = EntropyFix(u + c, delta) * alpha3;
+
+        massFlux = half * (l.MassFlux() + r.MassFlux() - (lambda1 + lambda2 + lambda3));
+        momentumFlux = half * (l.MomentumFlux() + r.MomentumFlux() - (lambda1 * (u - c) + lambda2 * u + lambda3 * (u + c)));
+        energyFlux = half * (l.EnergyFlux() + r.EnergyFlux() - (lambda1 * (H - u * c) + lambda2 * half * u * u + lambda3 * (H + u * c)));
+
+        return Max(Max(Abs(l.velocity) + l.soundSpeed, Abs(r.velocity) + r.soundSpeed), Abs(u) + c);
+    }
+};
+
+//computes the flux for every interface in [begin, end) from the states on its left and right (index i of the
+//left and right arrays), and returns the largest signal speed seen in the sweep. for a first order scheme the
+//right arrays are simply the region arrays shifted by one
+template<typename Flux, typename Real, typename Eos>
+Real ComputeFluxes(const Real* leftDensity, const Real* leftMomentum, const Real* leftEnergy,
+                   const Real* rightDensity, const Real* rightMomentum, const Real* rightEnergy,
+                   Real* massFlux, Real* momentumFlux, Real* energyFlux,
+                   int begin, int end, const Eos& eos) {
+    auto interface = [&](auto pack, int i) {
+        using P = decltype(pack);
+        FluxSide<P> l(P::Load(leftDensity + i), P::Load(leftMomentum + i), P::Load(leftEnergy + i), eos);
+        FluxSide<P> r(P::Load(rightDensity + i), P::Load(rightMomentum + i), P::Load(rightEnergy + i), eos);
+
+        P F0, F1, F2;
+        P speed = Flux::Compute(l, r, eos, F0, F1, F2);
+        F0.Store(massFlux + i);
+        F1.Store(momentumFlux + i);
+        F2.Store(energyFlux + i);
+        return speed;
+    };
+
+    using Pack = SimdPack<Real>;
+    using Lane = ScalarPack<Real>;
+
+    int i = begin;
+    Pack maxSpeedPack = Real(0);
+    for (; i + Pack::width <= end; i += Pack::width) {
+        maxSpeedPack = Max(maxSpeedPack, interface(Pack(), i));
+    }
+
+    //remainder that does not fill a whole pack
+    Real maxSpeed = ReduceMax(maxSpeedPack);
+    for (; i < end; i++) {
+        maxSpeed = std::max(maxSpeed, interface(Lane(), i).v);
+    }
+    return maxSpeed;
+}
+
+//species flux of every interface in [begin, end) of one species: the mass flux carries the fraction of the
+//region it leaves, so the species fluxes of a full set of fractions always add up to the mass flux
+template<typename Real>
+void ComputeSpeciesFluxes(const Real* massFlux, const Real* leftFractions, const Real* rightFractions, Real* speciesFlux,
+                          int begin, int end) {
+    auto interface = [&](auto pack, int i) {
+        using P = decltype(pack);
+        P flux = P::Load(massFlux + i);
+        P fraction = Select(GreaterEqual(flux, P(Real(0))), P::Load(leftFractions + i), P::Load(rightFractions + i));
+        (flux * fraction).Store(speciesFlux + i);
+    };
+
+    using Pack = SimdPack<Real>;
+    using Lane = ScalarPack<Real>;
+
+    int i = begin;
+    for (; i + Pack::width <= end; i += Pack::width) {
+        interface(Pack(), i);
+    }
+    for (; i < end; i++) {
+        interface(Lane(), i);
+    }
+}
@@ -0,0 +1,184 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "gas_ensemble.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "../core/thread_pool.h"
+
+template<typename Real, typename Flux, typename Boundary>
+BasicGasEnsemble<Real, Flux, Boundary>::BasicGasEnsemble(int count, int resolution) : m_count(count), m_resolution(resolution)
+{
+    m_groupCount = (count + laneWidth - 1) / laneWidth;
+    int lanes = m_groupCount * laneWidth;
+    size_t regions = (size_t)lanes * resolution;
+    size_t interfaces = (size_t)lanes * (resolution - 1);
+
+    m_density.resize(regions);
+    m_momentum.resize(regions);
+    m_energy.resize(regions);
+    m_nextDensity.resize(regions);
+    m_nextMomentum.resize(regions);
+    m_nextEnergy.resize(regions);
+    m_massFlux.resize(interfaces);
+    m_momentumFlux.resize(interfaces);
+    m_energyFlux.resize(interfaces);
+
+    m_sizes.assign(lanes, Real(1) / Real(resolution));
+    m_waveSpeeds.assign(lanes, 0);
+    m_timeSteps.assign(lanes, 0);
+    m_times.assign(lanes, 0);
+    boundaries.resize(count);
+
+    //padding lanes of the last group are stepped as well, so they need a valid state
+    for (int lane = 0; lane < lanes; lane++) {
+        for (int i = 0; i < resolution; i++) {
+            SetState(lane, i, Real(1), Real(0), Real(1));
+        }
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+int BasicGasEnsemble<Real, Flux, Boundary>::Index(int simulation, int region) const {
+    int group = simulation / laneWidth;
+    int lane = simulation % laneWidth;
+    return (group * m_resolution + region) * laneWidth + lane;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasEnsemble<Real, Flux, Boundary>::SetLength(int simulation, Real length) {
+    m_sizes[simulation] = length / Real(m_resolution);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasEnsemble<Real, Flux, Boundary>::SetState(int simulation, int regionIndex, Real density, Real velocity, Real pressure) {
+    int index = Index(simulation, regionIndex);
+    m_density[index] = density;
+    m_momentum[index] = density * velocity;
+    m_energy[index] = pressure / (gamma - Real(1)) + Real(0.5) * density * velocity * velocity;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasEnsemble<Real, Flux, Boundary>::GetDensity(int simulation, int regionIndex) const {
+    return m_density[Index(simulation, regionIndex)];
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasEnsemble<Real, Flux, Boundary>::GetVelocity(int simulation, int regionIndex) const {
+    int index = Index(simulation, regionIndex);
+    return m_momentum[index] / m_density[index];
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasEnsemble<Real, Flux, Boundary>::GetPressure(int simulation, int regionIndex) const {
+    //rounded the way BasicGasSimulation computes its primitives, so a lane reads the same as a lone simulation
+    int index = Index(simulation, regionIndex);
+    Real rho = m_density[index];
+    Real u = m_momentum[index] / rho;
+    return (gamma - Real(1)) * (m_energy[index] - Real(0.5) * rho * u * u);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasEnsemble<Real, Flux, Boundary>::ComputeFluxes(int group) {
+    size_t regionBase = (size_t)group * m_resolution * laneWidth;
+    size_t interfaceBase = (size_t)group * (m_resolution - 1) * laneWidth;
+    const Real* density = m_density.data() + regionBase;
+    const Real* momentum = m_momentum.data() + regionBase;
+    const Real* energy = m_energy.data() + regionBase;
+
+    //each kernel call handles interface i of every simulation in the group
+    Pack maxSpeed = Real(0);
+    for (int i = 0; i < m_resolution - 1; i++) {
+        int l = i * laneWidth;
+        int r = l + laneWidth;
+        FluxSide<Pack> left(Pack::Load(density + l), Pack::Load(momentum + l), Pack::Load(energy + l), PerfectGas<Real>{gamma});
+        FluxSide<Pack> right(Pack::Load(density + r), Pack::Load(momentum + r), Pack::Load(energy + r), PerfectGas<Real>{gamma});
+
+        Pack F0, F1, F2;
+        maxSpeed = Max(maxSpeed, Flux::Compute(left, right, PerfectGas<Real>{gamma}, F0, F1, F2));
+        F0.Store(m_massFlux.data() + interfaceBase + l);
+        F1.Store(m_momentumFlux.data() + interfaceBase + l);
+        F2.Store(m_energyFlux.data() + interfaceBase + l);
+    }
+    maxSpeed.Store(m_waveSpeeds.data() + group * laneWidth);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasEnsemble<Real, Flux, Boundary>::UpdateRegions(int group) {
+    size_t regionBase = (size_t)group * m_resolution * laneWidth;
+    size_t interfaceBase = (size_t)group * (m_resolution - 1) * laneWidth;
+    const Real* massFlux = m_massFlux.data() + interfaceBase;
+    const Real* momentumFlux = m_momentumFlux.data() + interfaceBase;
+    const Real* energyFlux = m_energyFlux.data() + interfaceBase;
+
+    Pack ratio = Pack::Load(m_timeSteps.data() + group * laneWidth) / Pack::Load(m_sizes.data() + group * laneWidth);
+    for (int i = 1; i < m_resolution - 1; i++) {
+        size_t c = regionBase + (size_t)i * laneWidth;
+        int f = i * laneWidth;
+        int b = f - laneWidth;
+        (Pack::Load(m_density.data() + c) - ratio * (Pack::Load(massFlux + f) - Pack::Load(massFlux + b))).Store(m_nextDensity.data() + c);
+        (Pack::Load(m_momentum.data() + c) - ratio * (Pack::Load(momentumFlux + f) - Pack::Load(momentumFlux + b))).Store(m_nextMomentum.data() + c);
+        (Pack::Load(m_energy.data() + c) - ratio * (Pack::Load(energyFlux + f) - Pack::Load(energyFlux + b))).Store(m_nextEnergy.data() + c);
+    }
+
+    //walls, one lane at a time with the interleaved stride
+    for (int lane = 0; lane < laneWidth; lane++) {
+        int simulation = group * laneWidth + lane;
+        if (simulation >= m_count) {
+            ReflectiveBoundary().Apply(m_nextDensity.data() + regionBase + lane, m_nextMomentum.data() + regionBase + lane, m_nextEnergy.data() + regionBase + lane, m_resolution, PerfectGas<Real>{gamma}, laneWidth);
+            continue;
+        }
+        boundaries[simulation].Apply(m_nextDensity.data() + regionBase + lane, m_nextMomentum.data() + regionBase + lane, m_nextEnergy.data() + regionBase + lane, m_resolution, PerfectGas<Real>{gamma}, laneWidth);
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasEnsemble<Real, Flux, Boundary>::Step() {
+    auto forEachGroup = [&](auto task) {
+        if (m_threadPool == nullptr) {
+            for (int group = 0; group < m_groupCount; group++) {
+                task(group);
+            }
+            return;
+        }
+        m_threadPool->ParallelFor(m_groupCount, task);
+    };
+
+    forEachGroup([&](int group) { ComputeFluxes(group); });
+
+    //padding lanes do not take part in the shared step
+    Real sharedStep = std::numeric_limits<Real>::infinity();
+    for (int simulation = 0; simulation < m_count; simulation++) {
+        m_timeSteps[simulation] = CFL * m_sizes[simulation] / m_waveSpeeds[simulation];
+        sharedStep = std::min(sharedStep, m_timeSteps[simulation]);
+    }
+    for (int lane = 0; lane < (int)m_timeSteps.size(); lane++) {
+        if (timeStepMode == SHARED_TIME_STEP || lane >= m_count) {
+            m_timeSteps[lane] = sharedStep;
+        }
+        m_times[lane] += m_timeSteps[lane];
+    }
+
+    forEachGroup([&](int group) { UpdateRegions(group); });
+
+    m_density.swap(m_nextDensity);
+    m_momentum.swap(m_nextMomentum);
+    m_energy.swap(m_nextEnergy);
+}
+
+#define INSTANTIATE_GAS_ENSEMBLE(Real, Flux) \
+    template class BasicGasEnsemble<Real, Flux, ReflectiveBoundary>; \
+    template class BasicGasEnsemble<Real, Flux, TransmissiveBoundary>; \
+    template class BasicGasEnsemble<Real, Flux, InflowOutflowBoundary>;
+
+INSTANTIATE_GAS_ENSEMBLE(float, RusanovFlux)
+INSTANTIATE_GAS_ENSEMBLE(float, HLLFlux)
+INSTANTIATE_GAS_ENSEMBLE(float, HLLCFlux)
+INSTANTIATE_GAS_ENSEMBLE(float, RoeFlux)
+INSTANTIATE_GAS_ENSEMBLE(double, RusanovFlux)
+INSTANTIATE_GAS_ENSEMBLE(double, HLLFlux)
+INSTANTIATE_GAS_ENSEMBLE(double, HLLCFlux)
+INSTANTIATE_GAS_ENSEMBLE(double, RoeFlux)
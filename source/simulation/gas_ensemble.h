@@ -0,0 +1,81 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef GAS_ENSEMBLE_H
+#define GAS_ENSEMBLE_H
+
+#include <vector>
+
+#include "boundary_conditions.h"
+#include "flux_kernels.h"
+
+#endif //GAS_ENSEMBLE_H
+
+class ThreadPool;
+
+enum EnsembleTimeStep {
+    PER_LANE_TIME_STEP, //every simulation advances with its own CFL step
+    SHARED_TIME_STEP    //every simulation advances with the smallest CFL step of the ensemble
+};
+
+//many independent, equally resolved gas simulations stepped in lockstep. the simulations are interleaved by lane
+//(array of structures of arrays): a group holds one simulation per vector lane and stores each field as
+//[region][lane], so a single flux kernel call advances a whole group of short pipes at once
+template<typename Real, typename Flux, typename Boundary>
+class BasicGasEnsemble {
+public:
+    using Pack = SimdPack<Real>;
+    static constexpr int laneWidth = Pack::width;
+
+private:
+    int m_count = 0;
+    int m_resolution = 0;
+    int m_groupCount = 0;
+
+    std::vector<Real> m_density, m_momentum, m_energy;
+    std::vector<Real> m_nextDensity, m_nextMomentum, m_nextEnergy;
+    std::vector<Real> m_massFlux, m_momentumFlux, m_energyFlux;
+
+    //per lane values, [group][lane]
+    std::vector<Real> m_sizes;
+    std::vector<Real> m_waveSpeeds;
+    std::vector<Real> m_timeSteps;
+    std::vector<Real> m_times;
+
+    ThreadPool* m_threadPool = nullptr;
+
+    int Index(int simulation, int region) const;
+    void ComputeFluxes(int group);
+    void UpdateRegions(int group);
+
+public:
+    Real gamma = 1.4;
+    Real CFL = 0.9;
+    EnsembleTimeStep timeStepMode = PER_LANE_TIME_STEP;
+
+    //one boundary policy instance per simulation
+    std::vector<Boundary> boundaries;
+
+    //every simulation starts as a resting gas (density 1, pressure 1) in a pipe of unit length
+    BasicGasEnsemble(int count, int resolution = 32);
+
+    int GetCount() const { return m_count; }
+    int GetResolution() const { return m_resolution; }
+    void SetThreadPool(ThreadPool* threadPool) { m_threadPool = threadPool; }
+
+    void SetLength(int simulation, Real length);
+    void SetState(int simulation, int regionIndex, Real density, Real velocity, Real pressure);
+
+    Real GetDensity(int simulation, int regionIndex) const;
+    Real GetVelocity(int simulation, int regionIndex) const;
+    Real GetPressure(int simulation, int regionIndex) const;
+    Real GetTime(int simulation) const { return m_times[simulation]; }
+    Real GetTimeStep(int simulation) const { return m_timeSteps[simulation]; }
+
+    void Step();
+};
+
+using GasEnsemble = BasicGasEnsemble<float, HLLFlux, ReflectiveBoundary>;
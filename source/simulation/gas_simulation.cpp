@@ -4,130 +4,860 @@
 
 #include "gas_simulation.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
-GasSimulation::GasSimulation(int resolution) : resolution(resolution)
+#include "../core/thread_pool.h"
+
+template<typename Real, typename Flux, typename Boundary>
+BasicGasSimulation<Real, Flux, Boundary>::BasicGasSimulation(int resolution) : resolution(resolution)
 {
+    sizes.assign(resolution, Real(1) / Real(resolution));
+    density.resize(resolution);
+    momentum.resize(resolution);
+    energy.resize(resolution);
+    m_nextDensity.resize(resolution);
+    m_nextMomentum.resize(resolution);
+    m_nextEnergy.resize(resolution);
+    velocity.resize(resolution);
+    pressure.resize(resolution);
+
+    massFlux.assign(resolution - 1, Real(0));
+    momentumFlux.assign(resolution - 1, Real(0));
+    energyFlux.assign(resolution - 1, Real(0));
+    m_blockWaveSpeeds.resize(1);
+
+    //establish initial conservative values
     for (int i = 0; i < resolution; i++) {
-        regions.emplace_back((float)1/(float)resolution);
+        if (i < resolution / 2) {
+            SetState(i, Real(1.0), Real(0.0), Real(1.0));
+        }
+        else {
+            SetState(i, Real(0.125), Real(0.0), Real(0.1));
+        }
     }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::SetThreadPool(ThreadPool* threadPool) {
+    m_threadPool = threadPool;
+    m_blockWaveSpeeds.resize(threadPool != nullptr ? threadPool->GetThreadCount() : 1);
+}
 
-    for (int i = 0; i < resolution - 1; i++) {
-        fluxes.emplace_back(0, 0, 0);
+template<typename Real, typename Flux, typename Boundary>
+int BasicGasSimulation<Real, Flux, Boundary>::GetBlockCount() const {
+    if (m_threadPool == nullptr) {
+        return 1;
     }
+    return std::clamp(resolution / minimumBlockSize, 1, m_threadPool->GetThreadCount());
+}
 
-    //establish initial conservative values
-    for (int i = 0; i < regions.size(); i++) {
-        if (i < regions.size() / 2) {
-            regions[i].density = 1.0f;
-            regions[i].velocity = 0.0f;
-            regions[i].pressure = 1.0f;
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::GetBlockRange(int block, int blockCount, int& begin, int& end) const {
+    //blocks partition the regions, block boundaries are independent of the pack width on purpose
+    begin = (int)((long long)resolution * block / blockCount);
+    end = (int)((long long)resolution * (block + 1) / blockCount);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::SetReconstruction(Reconstruction reconstruction) {
+    m_reconstruction = reconstruction;
+
+    int faces = reconstruction == PIECEWISE_CONSTANT ? 0 : resolution - 1;
+    m_leftDensity.resize(faces);
+    m_leftMomentum.resize(faces);
+    m_leftEnergy.resize(faces);
+    m_rightDensity.resize(faces);
+    m_rightMomentum.resize(faces);
+    m_rightEnergy.resize(faces);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+template<typename Task>
+void BasicGasSimulation<Real, Flux, Boundary>::ForEachBlock(int blockCount, const Task& task) {
+    if (blockCount == 1) {
+        task(0, 0, resolution);
+        return;
+    }
+
+    m_threadPool->ParallelFor(blockCount, [&](int block) {
+        int begin, end;
+        GetBlockRange(block, blockCount, begin, end);
+        task(block, begin, end);
+    });
+}
+
+template<typename Real, typename Flux, typename Boundary>
+template<typename Task>
+auto BasicGasSimulation<Real, Flux, Boundary>::WithEquationOfState(const Task& task) const {
+    //like the limiter the gas is picked once per sweep, the loops inside are specialised for either
+    if (equationOfState != nullptr) {
+        return task(TabulatedGas<Real>{equationOfState});
+    }
+    return task(PerfectGas<Real>{gamma});
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::ReconstructFaces(int begin, int end) {
+    Real* faces[6] = {m_leftDensity.data(), m_leftMomentum.data(), m_leftEnergy.data(),
+                      m_rightDensity.data(), m_rightMomentum.data(), m_rightEnergy.data()};
+
+    //the limiter is picked once per sweep, the cell loop itself is fully specialised
+    WithEquationOfState([&](const auto& eos) {
+        switch (m_reconstruction) {
+            case MUSCL_MINMOD:
+                ::ReconstructFaces<MinmodLimiter>(density.data(), velocity.data(), pressure.data(), resolution, begin, end, eos,
+                                                  faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]);
+                break;
+            case MUSCL_VAN_LEER:
+                ::ReconstructFaces<VanLeerLimiter>(density.data(), velocity.data(), pressure.data(), resolution, begin, end, eos,
+                                                   faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]);
+                break;
+            case MUSCL_MC:
+                ::ReconstructFaces<MCLimiter>(density.data(), velocity.data(), pressure.data(), resolution, begin, end, eos,
+                                              faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]);
+                break;
+            default:
+                break;
         }
-        else {
-            regions[i].density = 0.125f;
-            regions[i].velocity = 0.0f;
-            regions[i].pressure = 0.1f;
+    });
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasSimulation<Real, Flux, Boundary>::ComputeFluxes(int begin, int end) {
+    //a block owns the interfaces on the right of its regions, so it reads one halo region from the next block
+    //(two for the reconstructions). the final region has no right interface
+    end = std::min(end, resolution - 1);
+    if (begin >= end) {
+        return Real(0);
+    }
+
+    if (m_reconstruction == PIECEWISE_CONSTANT) {
+        return WithEquationOfState([&](const auto& eos) {
+            return ::ComputeFluxes<Flux>(density.data(), momentum.data(), energy.data(),
+                                         density.data() + 1, momentum.data() + 1, energy.data() + 1,
+                                         massFlux.data(), momentumFlux.data(), energyFlux.data(),
+                                         begin, end, eos);
+        });
+    }
+
+    ReconstructFaces(begin, end);
+    return WithEquationOfState([&](const auto& eos) {
+        return ::ComputeFluxes<Flux>(m_leftDensity.data(), m_leftMomentum.data(), m_leftEnergy.data(),
+                                     m_rightDensity.data(), m_rightMomentum.data(), m_rightEnergy.data(),
+                                     massFlux.data(), momentumFlux.data(), energyFlux.data(),
+                                     begin, end, eos);
+    });
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::ComputeSpeciesFluxes(int begin, int end) {
+    end = std::min(end, resolution - 1);
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        size_t offset = (size_t)k * resolution;
+        ::ComputeSpeciesFluxes(massFlux.data(), massFractions.data() + offset, massFractions.data() + offset + 1,
+                               speciesFlux.data() + offset, begin, end);
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::UpdateRegions(int begin, int end, Real dt, Real previousWeight) {
+    //the walls are handled by ApplyBoundaries
+    begin = std::max(begin, 1);
+    end = std::min(end, resolution - 1);
+
+    if (previousWeight == Real(0)) {
+        for (int i = begin; i < end; i++) {
+            Real ratio = dt / sizes[i];
+            m_nextDensity[i] = density[i] - ratio * (massFlux[i] - massFlux[i - 1]);
+            m_nextMomentum[i] = momentum[i] - ratio * (momentumFlux[i] - momentumFlux[i - 1]);
+            m_nextEnergy[i] = energy[i] - ratio * (energyFlux[i] - energyFlux[i - 1]);
         }
+        return;
+    }
 
-        regions[i].energy = regions[i].pressure / (gamma - 1.0f) + 0.5f * regions[i].density * pow(regions[i].velocity, 2);
-        regions[i].conservatives = {
-            regions[i].density,
-            regions[i].density * regions[i].velocity,
-            regions[i].energy
-        };
+    //runge-kutta stage, the back buffers still hold the state the stage started from
+    Real currentWeight = Real(1) - previousWeight;
+    for (int i = begin; i < end; i++) {
+        Real ratio = dt / sizes[i];
+        m_nextDensity[i] = previousWeight * m_nextDensity[i] + currentWeight * (density[i] - ratio * (massFlux[i] - massFlux[i - 1]));
+        m_nextMomentum[i] = previousWeight * m_nextMomentum[i] + currentWeight * (momentum[i] - ratio * (momentumFlux[i] - momentumFlux[i - 1]));
+        m_nextEnergy[i] = previousWeight * m_nextEnergy[i] + currentWeight * (energy[i] - ratio * (energyFlux[i] - energyFlux[i - 1]));
     }
 }
 
-glm::vec3 GasSimulation::RiemannSolver(glm::vec3 ul, glm::vec3 ur) {
-    float rhoL = ul.x;
-    float uL = ul.y / rhoL;
-    float EL = ul.z;
-    float rhoR = ur.x;
-    float uR = ur.y / rhoR;
-    float ER = ur.z;
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::UpdateSpecies(int begin, int end, Real dt, Real previousWeight) {
+    //the same update as the density, one species array after the other
+    begin = std::max(begin, 1);
+    end = std::min(end, resolution - 1);
+    Real currentWeight = Real(1) - previousWeight;
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        size_t offset = (size_t)k * resolution;
+        const Real* current = speciesDensity.data() + offset;
+        const Real* flux = speciesFlux.data() + offset;
+        Real* next = m_nextSpeciesDensity.data() + offset;
+        if (previousWeight == Real(0)) {
+            for (int i = begin; i < end; i++) {
+                next[i] = current[i] - dt / sizes[i] * (flux[i] - flux[i - 1]);
+            }
+            continue;
+        }
+        for (int i = begin; i < end; i++) {
+            next[i] = previousWeight * next[i] + currentWeight * (current[i] - dt / sizes[i] * (flux[i] - flux[i - 1]));
+        }
+    }
+}
 
-    float pL = (gamma - 1.0f) * (EL - 0.5f * rhoL * pow(uL, 2));
-    float pR = (gamma - 1.0f) * (ER - 0.5f * rhoR * pow(uR, 2));
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::ApplyBoundaries(std::vector<Real>& density, std::vector<Real>& momentum, std::vector<Real>& energy,
+                                                               std::vector<Real>& speciesDensity) {
+    WithEquationOfState([&](const auto& eos) {
+        boundary.Apply(density.data(), momentum.data(), energy.data(), resolution, eos);
+    });
 
-    float cL = sqrt(gamma * pL / rhoL);
-    float cR = sqrt(gamma * pR / rhoR);
+    //ghost species follow the ghost density, with the fractions of their end or of the neighbouring region
+    int ghosts[2] = {0, resolution - 1};
+    int neighbours[2] = {1, resolution - 2};
+    for (int end = 0; end < 2; end++) {
+        for (int k = 0; k < GetSpeciesCount(); k++) {
+            size_t offset = (size_t)k * resolution;
+            Real fraction = ghostFractions[end].size() >= m_species.size() ? ghostFractions[end][k]
+                                                                : speciesDensity[offset + neighbours[end]] / density[neighbours[end]];
+            speciesDensity[offset + ghosts[end]] = fraction * density[ghosts[end]];
+        }
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::SwapBuffers() {
+    density.swap(m_nextDensity);
+    momentum.swap(m_nextMomentum);
+    energy.swap(m_nextEnergy);
+    speciesDensity.swap(m_nextSpeciesDensity);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasSimulation<Real, Flux, Boundary>::ComputeStageFluxes(int blockCount, Real dt) {
+    //compute interface fluxes per block, each block reduces its own wave speed
+    ForEachBlock(blockCount, [&](int block, int begin, int end) {
+        m_blockWaveSpeeds[block] = ComputeFluxes(begin, end);
+        ComputeSpeciesFluxes(begin, end);
+    });
+
+    //max is exact, so the global dt does not depend on how the regions were split
+    Real waveSpeed = Real(0);
+    for (int block = 0; block < blockCount; block++) {
+        waveSpeed = std::max(waveSpeed, m_blockWaveSpeeds[block]);
+    }
+    if (dt <= Real(0)) {
+        dt = std::min(CFL * GetSmallestSize() / waveSpeed, maxTimeStep);
+        maxWaveSpeed = waveSpeed;
+    }
+    return dt;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasSimulation<Real, Flux, Boundary>::AdvanceStage(int blockCount, Real dt, Real previousWeight) {
+    dt = ComputeStageFluxes(blockCount, dt);
+    AccumulateBoundaryFluxes(dt, previousWeight);
 
-    glm::vec3 FL = {rhoL * uL, rhoL * pow(uL, 2), uL * (EL + pL)};
-    glm::vec3 FR = {rhoR * uR, rhoR * pow(uR, 2), uR * (ER + pR)};
+    ForEachBlock(blockCount, [&](int block, int begin, int end) {
+        UpdateRegions(begin, end, dt, previousWeight);
+        UpdateSpecies(begin, end, dt, previousWeight);
+    });
+    ApplyBoundaries(m_nextDensity, m_nextMomentum, m_nextEnergy, m_nextSpeciesDensity);
+    SwapBuffers();
 
-    float SL = std::min(uL - cL, uR - cR);
-    float SR = std::max(uL + cL, uR + cR);
+    ForEachBlock(blockCount, [&](int block, int begin, int end) {
+        UpdatePrimatives(begin, end);
+    });
+    return dt;
+}
 
-    if (SL >= 0) {
-        return FL;
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::AccumulateBoundaryFluxes(Real dt, Real previousWeight) {
+    int faces[2] = {0, resolution - 2};
+    Real currentWeight = Real(1) - previousWeight;
+    for (int end = 0; end < 2; end++) {
+        boundaryMass[end] = previousWeight * boundaryMass[end] + currentWeight * dt * massFlux[faces[end]];
+        boundaryMomentum[end] = previousWeight * boundaryMomentum[end] + currentWeight * dt * momentumFlux[faces[end]];
+        boundaryEnergy[end] = previousWeight * boundaryEnergy[end] + currentWeight * dt * energyFlux[faces[end]];
+        for (int k = 0; k < GetSpeciesCount(); k++) {
+            Real& species = boundarySpecies[end][k];
+            species = previousWeight * species + currentWeight * dt * speciesFlux[(size_t)k * resolution + faces[end]];
+        }
     }
-    else if (SR <= 0) {
-        return FR;
+}
+
+//jacobian dF/dU of the euler flux at one region
+template<typename Real>
+static Block3<Real> EulerFluxJacobian(Real rho, Real u, Real p, Real gamma) {
+    Real enthalpy = (gamma / (gamma - Real(1))) * p / rho + Real(0.5) * u * u;
+    Block3<Real> a;
+    a.m[0][1] = Real(1);
+    a.m[1][0] = Real(0.5) * (gamma - Real(3)) * u * u;
+    a.m[1][1] = (Real(3) - gamma) * u;
+    a.m[1][2] = gamma - Real(1);
+    a.m[2][0] = u * (Real(0.5) * (gamma - Real(1)) * u * u - enthalpy);
+    a.m[2][1] = enthalpy - (gamma - Real(1)) * u * u;
+    a.m[2][2] = gamma * u;
+    return a;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::AssembleImplicitRows(int begin, int end, Real dt) {
+    begin = std::max(begin, 1);
+    end = std::min(end, resolution - 1);
+
+    //(I / dt + dR/dU) dU = -R, with R linearised as a rusanov flux around the current state:
+    //dF(i+1/2)/dU(i) = (A(i) + l I) / 2 and dF(i+1/2)/dU(i+1) = (A(i+1) - l I) / 2, l the interface wave speed.
+    //the right hand side keeps the policy fluxes (and reconstruction), only the jacobian is first order. a
+    //general gas is linearised as the perfect gas with the same pressure at each region
+    WithEquationOfState([&](const auto& eos) {
+        AssembleImplicitRows(begin, end, dt, eos);
+    });
+}
+
+template<typename Real, typename Flux, typename Boundary>
+template<typename Eos>
+void BasicGasSimulation<Real, Flux, Boundary>::AssembleImplicitRows(int begin, int end, Real dt, const Eos& eos) {
+    using Lane = ScalarPack<Real>;
+    auto region = [&](int i, Real& waveSpeed, Real& energyGamma) {
+        Lane internalEnergy = energy[i] - Real(0.5) * density[i] * velocity[i] * velocity[i];
+        waveSpeed = std::abs(velocity[i]) + eos.SoundSpeed(Lane(density[i]), internalEnergy, Lane(pressure[i])).v;
+        energyGamma = eos.EnergyGamma(Lane(density[i]), internalEnergy, Lane(pressure[i])).v;
+    };
+
+    for (int i = begin; i < end; i++) {
+        int row = i - 1;
+        Real inverseSize = Real(1) / sizes[i];
+        Real waveSpeed, leftSpeed, rightSpeed, energyGamma, leftGamma, rightGamma;
+        region(i, waveSpeed, energyGamma);
+        region(i - 1, leftSpeed, leftGamma);
+        region(i + 1, rightSpeed, rightGamma);
+        leftSpeed = std::max(waveSpeed, leftSpeed);
+        rightSpeed = std::max(waveSpeed, rightSpeed);
+
+        Block3<Real> lower = EulerFluxJacobian(density[i - 1], velocity[i - 1], pressure[i - 1], leftGamma);
+        Block3<Real> upper = EulerFluxJacobian(density[i + 1], velocity[i + 1], pressure[i + 1], rightGamma);
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                lower.m[r][c] *= Real(-0.5) * inverseSize;
+                upper.m[r][c] *= Real(0.5) * inverseSize;
+            }
+            lower.m[r][r] -= Real(0.5) * leftSpeed * inverseSize;
+            upper.m[r][r] -= Real(0.5) * rightSpeed * inverseSize;
+        }
+        m_lowerBlocks[row] = lower;
+        m_upperBlocks[row] = upper;
+        m_diagonalBlocks[row] = Block3<Real>::Identity(Real(1) / dt + Real(0.5) * (leftSpeed + rightSpeed) * inverseSize);
+
+        Real* rhs = m_implicitIncrement.data() + 3 * row;
+        rhs[0] = -(massFlux[i] - massFlux[i - 1]) * inverseSize;
+        rhs[1] = -(momentumFlux[i] - momentumFlux[i - 1]) * inverseSize;
+        rhs[2] = -(energyFlux[i] - energyFlux[i - 1]) * inverseSize;
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasSimulation<Real, Flux, Boundary>::AdvanceImplicit(int blockCount, Real dt) {
+    int rows = resolution - 2;
+    if ((int)m_diagonalBlocks.size() < rows) {
+        m_lowerBlocks.resize(rows);
+        m_diagonalBlocks.resize(rows);
+        m_upperBlocks.resize(rows);
+        m_implicitIncrement.resize(3 * rows);
+    }
+
+    dt = ComputeStageFluxes(blockCount, dt);
+    //the linearised update does not integrate these exactly, couplings only balance to the explicit part
+    AccumulateBoundaryFluxes(dt, Real(0));
+    ForEachBlock(blockCount, [&](int block, int begin, int end) {
+        AssembleImplicitRows(begin, end, dt);
+    });
+
+    //the ghost regions are functions of their neighbours, dU(0) = G dU(1), so their columns fold into the
+    //first and last diagonal blocks
+    Real leftGhost[3], rightGhost[3];
+    boundary.GhostJacobian(leftGhost, rightGhost);
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            m_diagonalBlocks[0].m[r][c] += m_lowerBlocks[0].m[r][c] * leftGhost[c];
+            m_diagonalBlocks[rows - 1].m[r][c] += m_upperBlocks[rows - 1].m[r][c] * rightGhost[c];
+        }
+    }
+
+    //the solve is a sequential recurrence, everything around it is split into blocks as usual
+    SolveBlockTridiagonal(m_lowerBlocks.data(), m_diagonalBlocks.data(), m_upperBlocks.data(), m_implicitIncrement.data(), rows);
+
+    ForEachBlock(blockCount, [&](int block, int begin, int end) {
+        begin = std::max(begin, 1);
+        end = std::min(end, resolution - 1);
+        for (int i = begin; i < end; i++) {
+            const Real* increment = m_implicitIncrement.data() + 3 * (i - 1);
+            m_nextDensity[i] = density[i] + increment[0];
+            m_nextMomentum[i] = momentum[i] + increment[1];
+            m_nextEnergy[i] = energy[i] + increment[2];
+        }
+    });
+    AdvanceImplicitSpecies(dt);
+    ApplyBoundaries(m_nextDensity, m_nextMomentum, m_nextEnergy, m_nextSpeciesDensity);
+    SwapBuffers();
+
+    ForEachBlock(blockCount, [&](int block, int begin, int end) {
+        UpdatePrimatives(begin, end);
+    });
+    return dt;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::AdvanceImplicitSpecies(Real dt) {
+    int count = GetSpeciesCount();
+    int rows = resolution - 2;
+    if (count == 0) {
+        return;
+    }
+    if ((int)m_speciesLower.size() < rows) {
+        m_speciesLower.resize(rows);
+        m_speciesUpper.resize(rows);
+        m_speciesScale.resize(rows);
+    }
+
+    //upwind in the fractions at the new time, with the new density:
+    //rho Y(i) + dt / size (F(i+1/2) - F(i-1/2)) = rho Y(n)(i), F = m+ Y(left) + m- Y(right).
+    //every species shares the matrix, so it is factored once (thomas) and solved for each. it is an M-matrix,
+    //which keeps the fractions within [0, 1] for any step
+    bool fixedEnds[2] = {ghostFractions[0].size() >= (size_t)count, ghostFractions[1].size() >= (size_t)count};
+    Real previousUpper = Real(0);
+    for (int row = 0; row < rows; row++) {
+        int i = row + 1;
+        Real ratio = dt / sizes[i];
+        Real lower = -ratio * std::max(massFlux[i - 1], Real(0));
+        Real upper = ratio * std::min(massFlux[i], Real(0));
+        Real diagonal = m_nextDensity[i] + ratio * (std::max(massFlux[i], Real(0)) - std::min(massFlux[i - 1], Real(0)));
+
+        //a ghost with the neighbouring region's fractions folds into the diagonal, fixed ones go to the right
+        //hand side below
+        if (row == 0 && !fixedEnds[0]) {
+            diagonal += lower;
+        }
+        if (row == rows - 1 && !fixedEnds[1]) {
+            diagonal += upper;
+        }
+        m_speciesScale[row] = Real(1) / (diagonal - lower * previousUpper);
+        m_speciesLower[row] = lower;
+        m_speciesUpper[row] = upper * m_speciesScale[row];
+        previousUpper = m_speciesUpper[row];
+    }
+
+    for (int k = 0; k < count; k++) {
+        size_t offset = (size_t)k * resolution;
+        const Real* current = speciesDensity.data() + offset;
+        Real* fractions = m_nextSpeciesDensity.data() + offset;
+
+        Real previous = Real(0);
+        for (int row = 0; row < rows; row++) {
+            int i = row + 1;
+            Real rhs = current[i];
+            if (row == 0 && fixedEnds[0]) {
+                rhs -= m_speciesLower[row] * ghostFractions[0][k];
+            }
+            if (row == rows - 1 && fixedEnds[1]) {
+                rhs -= dt / sizes[i] * std::min(massFlux[i], Real(0)) * ghostFractions[1][k];
+            }
+            previous = (rhs - m_speciesLower[row] * previous) * m_speciesScale[row];
+            fractions[i] = previous;
+        }
+        for (int row = rows - 2; row >= 0; row--) {
+            fractions[row + 1] -= m_speciesUpper[row] * fractions[row + 2];
+        }
+    }
+
+    //the new density only balances the mass fluxes to the linearisation, the fractions are renormalised before
+    //they go back to partial densities
+    for (int i = 1; i < resolution - 1; i++) {
+        Real sum = Real(0);
+        for (int k = 0; k < count; k++) {
+            sum += m_nextSpeciesDensity[(size_t)k * resolution + i];
+        }
+        Real scale = m_nextDensity[i] / sum;
+        for (int k = 0; k < count; k++) {
+            m_nextSpeciesDensity[(size_t)k * resolution + i] *= scale;
+        }
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::AdvanceSources(int blockCount, Real dt) {
+    //the sources work on the state in place and update the primitives as they go, the ghost regions are
+    //refreshed from the result like after a stage
+    ForEachBlock(blockCount, [&](int block, int begin, int end) {
+        int first = std::max(begin, 1);
+        int last = std::min(end, resolution - 1);
+        WithEquationOfState([&](const auto& eos) {
+            ApplySourceTerms(density.data(), momentum.data(), energy.data(), velocity.data(), pressure.data(),
+                             areaGradient.data(), lossCoefficient.data(), heatTransferCoefficient.data(), wallTemperature,
+                             first, last, dt, eos);
+        });
+        //the sources leave the mass fractions alone, only the area change moves the density they are carried by
+        for (int k = 0; k < GetSpeciesCount(); k++) {
+            size_t offset = (size_t)k * resolution;
+            for (int i = first; i < last; i++) {
+                speciesDensity[offset + i] = massFractions[offset + i] * density[i];
+            }
+        }
+    });
+    ApplyBoundaries(density, momentum, energy, speciesDensity);
+    UpdatePrimatives(0, 1);
+    UpdatePrimatives(resolution - 1, resolution);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::ComputeState(Real dt) {
+    int blockCount = GetBlockCount();
+
+    //strang splitting, half of the sources on either side of the flux update. the first half needs the step
+    //before the fluxes are there to pick it, so a CFL step comes from the current state instead
+    bool sources = !lossCoefficient.empty();
+    if (sources) {
+        if (dt <= Real(0)) {
+            dt = ComputeTimeStep();
+        }
+        AdvanceSources(blockCount, Real(0.5) * dt);
+    }
+
+    if (timeIntegration == BACKWARD_EULER) {
+        timeStep = AdvanceImplicit(blockCount, dt);
     }
     else {
-        return (SR * FL - SL * FR + SL * SR * (ur - ul)) / (SR - SL);
+        //the first stage picks the CFL step unless one is given, later stages reuse it
+        timeStep = AdvanceStage(blockCount, dt, Real(0));
+        if (timeIntegration == SSP_RK2) {
+            //after the swap the back buffers hold the state at the start of the step, so
+            //u(n+1) = 1/2 u(n) + 1/2 (u1 + dt L(u1))
+            AdvanceStage(blockCount, timeStep, Real(0.5));
+        }
     }
+
+    if (sources) {
+        AdvanceSources(blockCount, Real(0.5) * timeStep);
+    }
+    time += timeStep;
 }
 
-void GasSimulation::ComputeState() {
-    //compute interface fluxes
-    for (int i = 0; i < regions.size() - 1; i++) {
-        glm::vec3 ul = regions[i].conservatives;
-        glm::vec3 ur = regions[i + 1].conservatives;
-        fluxes[i] = RiemannSolver(ul, ur);
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::UpdatePrimatives(int begin, int end) {
+    WithEquationOfState([&](const auto& eos) {
+        auto region = [&](auto pack, int i) {
+            using P = decltype(pack);
+            P rho = P::Load(density.data() + i);
+            P u = P::Load(momentum.data() + i) / rho;
+
+            u.Store(velocity.data() + i);
+            eos.Pressure(rho, P::Load(energy.data() + i) - P(Real(0.5)) * rho * u * u).Store(pressure.data() + i);
+        };
+
+        using Pack = SimdPack<Real>;
+        int i = begin;
+        for (; i + Pack::width <= end; i += Pack::width) {
+            region(Pack(), i);
+        }
+        for (; i < end; i++) {
+            region(ScalarPack<Real>(), i);
+        }
+    });
+
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        size_t offset = (size_t)k * resolution;
+        for (int i = begin; i < end; i++) {
+            massFractions[offset + i] = speciesDensity[offset + i] / density[i];
+        }
     }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::SetState(int regionIndex, Real density, Real velocity, Real pressure) {
+    this->density[regionIndex] = density;
+    this->velocity[regionIndex] = velocity;
+    this->pressure[regionIndex] = pressure;
+    this->momentum[regionIndex] = density * velocity;
+    Real internalEnergy = WithEquationOfState([&](const auto& eos) {
+        return eos.InternalEnergy(ScalarPack<Real>(density), ScalarPack<Real>(pressure)).v;
+    });
+    this->energy[regionIndex] = internalEnergy + Real(0.5) * density * velocity * velocity;
+
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        size_t index = (size_t)k * resolution + regionIndex;
+        speciesDensity[index] = massFractions[index] * density;
+    }
+
+    //a table does not invert exactly, the primitives are the ones the conservatives give back, as after a step
+    if (equationOfState != nullptr) {
+        UpdatePrimatives(regionIndex, regionIndex + 1);
+    }
+}
 
-    //compute delta time
-    float maxSpeed = 0;
-    for (int i = 0; i < regions.size(); i++) {
-        float c = sqrt(gamma * regions[i].pressure / regions[i].density);
-        maxSpeed = std::max(maxSpeed, abs(regions[i].velocity) + c);
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::SetSpecies(const std::vector<Gas>& species) {
+    m_species = species;
+    size_t size = species.size() * resolution;
+    speciesDensity.assign(size, Real(0));
+    m_nextSpeciesDensity.assign(size, Real(0));
+    massFractions.assign(size, Real(0));
+    speciesFlux.assign(size, Real(0));
+    for (int end = 0; end < 2; end++) {
+        boundarySpecies[end].assign(species.size(), Real(0));
+        m_boundarySpeciesSums[end].assign(species.size(), Real(0));
     }
-    float dt = CFL * regions[0].size / maxSpeed; // assuming uniform grid
 
-    //evaluate
-    std::vector<glm::vec3> updated;
-    updated.resize(regions.size());
-    updated[0] = regions[1].conservatives;
-    updated[0].y = -updated[0].y; // flip momentum
-    updated[regions.size() - 1] = regions[regions.size() - 2].conservatives;
-    updated[regions.size() - 1].y = -updated[regions.size() - 1].y;
-    for (int i = 1; i < regions.size() - 1; i++) {
-        updated[i] = regions[i].conservatives - (dt / regions[i].size) * (fluxes[i] - fluxes[i - 1]);
+    if (species.empty()) {
+        return;
     }
+    for (int i = 0; i < resolution; i++) {
+        massFractions[i] = Real(1);
+        speciesDensity[i] = density[i];
+    }
+}
 
-    for (int i = 0; i < regions.size(); i++) {
-        regions[i].conservatives = updated[i];
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::SetMassFractions(int regionIndex, const Real* fractions) {
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        size_t index = (size_t)k * resolution + regionIndex;
+        massFractions[index] = fractions[k];
+        speciesDensity[index] = fractions[k] * density[regionIndex];
     }
 }
 
-void GasSimulation::UpdatePrimatives() {
-    for (auto& region : regions) {
-        float rho = region.conservatives.x;
-        float momentum = region.conservatives.y;
-        float energy = region.conservatives.z;
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::SetPipeGeometry(const Real* areas, const Real* diameters, Real frictionFactor, const Real* fittingLosses) {
+    areaGradient.resize(resolution);
+    lossCoefficient.resize(resolution);
+    heatTransferCoefficient.resize(resolution);
+    for (int i = 0; i < resolution; i++) {
+        //central differences between region centres, one sided at the ends
+        int previous = std::max(i - 1, 0);
+        int next = std::min(i + 1, resolution - 1);
+        Real distance = Real(0.5) * (sizes[previous] + sizes[next]) + (previous != i && next != i ? sizes[i] : Real(0));
+        areaGradient[i] = (areas[next] - areas[previous]) / (distance * areas[i]);
 
-        region.density = rho;
-        region.velocity = momentum / rho;
-        region.energy = energy;
-        region.pressure = (gamma - 1.0f) * (energy - 0.5f * rho * region.velocity * region.velocity);
+        Real wall = frictionFactor / (Real(2) * diameters[i]);
+        lossCoefficient[i] = wall + (fittingLosses != nullptr ? fittingLosses[i] / (Real(2) * sizes[i]) : Real(0));
+        heatTransferCoefficient[i] = wall;
     }
 }
 
-void GasSimulation::SetState(int regionIndex, float density, float velocity, float pressure) {
-    regions[regionIndex].density = density;
-    regions[regionIndex].velocity = velocity;
-    regions[regionIndex].pressure = pressure;
-    regions[regionIndex].energy = regions[regionIndex].pressure / (gamma - 1.0f) + 0.5f * regions[regionIndex].density * pow(regions[regionIndex].velocity, 2);
-    regions[regionIndex].conservatives = {
-        regions[regionIndex].density,
-        regions[regionIndex].density * regions[regionIndex].velocity,
-        regions[regionIndex].energy
-    };
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasSimulation<Real, Flux, Boundary>::ComputeTimeStep() const {
+    using Lane = ScalarPack<Real>;
+    Real waveSpeed = WithEquationOfState([&](const auto& eos) {
+        Real waveSpeed = Real(0);
+        for (int i = 0; i < resolution; i++) {
+            Lane internalEnergy = energy[i] - Real(0.5) * density[i] * velocity[i] * velocity[i];
+            waveSpeed = std::max(waveSpeed, std::abs(velocity[i]) + eos.SoundSpeed(Lane(density[i]), internalEnergy, Lane(pressure[i])).v);
+        }
+        return waveSpeed;
+    });
+    return std::min(CFL * GetSmallestSize() / waveSpeed, maxTimeStep);
+}
+
+template<typename Real, typename Flux, typename Boundary>
+Real BasicGasSimulation<Real, Flux, Boundary>::GetSmallestSize() const {
+    //the regions need not be uniform (pipes, refinement levels), the smallest one limits the step. a pass over
+    //the sizes is cheap next to the fluxes
+    Real size = std::numeric_limits<Real>::infinity();
+    for (int i = 0; i < resolution; i++) {
+        size = std::min(size, sizes[i]);
+    }
+    return size;
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::Step() {
+    ComputeState(Real(0));
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::Step(Real dt) {
+    ComputeState(dt);
 }
 
-void GasSimulation::Step() {
-    ComputeState();
-    UpdatePrimatives();
+template<typename Real, typename Flux, typename Boundary>
+int BasicGasSimulation<Real, Flux, Boundary>::GetDependencyRadius() const {
+    //regions a step can carry information across: one per stage, two per stage with a reconstruction
+    int stencil = m_reconstruction == PIECEWISE_CONSTANT ? 1 : 2;
+    int stages = timeIntegration == SSP_RK2 ? 2 : 1;
+    return stencil * stages;
 }
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::StepTile(BasicGasSimulation& tile, int begin, int end, int halo, Real dt, int steps) {
+    //window clipped to the domain. where it reaches the real ends the ghost regions come along and the
+    //boundary policy acts on them as usual, elsewhere the window edges only pollute the halo
+    int windowBegin = std::max(begin - halo, 0);
+    int windowEnd = std::min(end + halo, resolution);
+    int windowSize = windowEnd - windowBegin;
+
+    tile.resolution = windowSize;
+    for (int i = 0; i < windowSize; i++) {
+        tile.sizes[i] = sizes[windowBegin + i];
+        tile.density[i] = density[windowBegin + i];
+        tile.momentum[i] = momentum[windowBegin + i];
+        tile.energy[i] = energy[windowBegin + i];
+    }
+    if (!lossCoefficient.empty()) {
+        for (int i = 0; i < windowSize; i++) {
+            tile.areaGradient[i] = areaGradient[windowBegin + i];
+            tile.lossCoefficient[i] = lossCoefficient[windowBegin + i];
+            tile.heatTransferCoefficient[i] = heatTransferCoefficient[windowBegin + i];
+        }
+    }
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        for (int i = 0; i < windowSize; i++) {
+            tile.speciesDensity[(size_t)k * windowSize + i] = speciesDensity[(size_t)k * resolution + windowBegin + i];
+        }
+    }
+    tile.UpdatePrimatives(0, windowSize);
+
+    //the tiles on the ends carry the domain's end interfaces, their fluxes add up over the run
+    for (int step = 0; step < steps; step++) {
+        tile.ComputeState(dt);
+        if (begin == 0) {
+            AddBoundaryFluxes(tile, 0);
+        }
+        if (end == resolution) {
+            AddBoundaryFluxes(tile, 1);
+        }
+    }
+
+    //only the tile itself is valid after all steps, it goes to the back buffers so later tiles still read
+    //the state at the start of the run
+    for (int i = begin; i < end; i++) {
+        int local = i - windowBegin;
+        m_nextDensity[i] = tile.density[local];
+        m_nextMomentum[i] = tile.momentum[local];
+        m_nextEnergy[i] = tile.energy[local];
+        velocity[i] = tile.velocity[local];
+        pressure[i] = tile.pressure[local];
+    }
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        for (int i = begin; i < end; i++) {
+            size_t local = (size_t)k * windowSize + i - windowBegin;
+            m_nextSpeciesDensity[(size_t)k * resolution + i] = tile.speciesDensity[local];
+            massFractions[(size_t)k * resolution + i] = tile.massFractions[local];
+        }
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::AddBoundaryFluxes(const BasicGasSimulation& tile, int end) {
+    boundaryMass[end] += tile.boundaryMass[end];
+    boundaryMomentum[end] += tile.boundaryMomentum[end];
+    boundaryEnergy[end] += tile.boundaryEnergy[end];
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        boundarySpecies[end][k] += tile.boundarySpecies[end][k];
+    }
+}
+
+template<typename Real, typename Flux, typename Boundary>
+void BasicGasSimulation<Real, Flux, Boundary>::StepBlocked(Real dt, int steps, int tileSize) {
+    //every step overwrites the boundary fluxes with its own, they are summed on the side over the run
+    if (timeIntegration == BACKWARD_EULER) {
+        Real sums[2][3] = {};
+        for (int end = 0; end < 2; end++) {
+            std::fill(m_boundarySpeciesSums[end].begin(), m_boundarySpeciesSums[end].end(), Real(0));
+        }
+        for (int step = 0; step < steps; step++) {
+            ComputeState(dt);
+            for (int end = 0; end < 2; end++) {
+                sums[end][0] += boundaryMass[end];
+                sums[end][1] += boundaryMomentum[end];
+                sums[end][2] += boundaryEnergy[end];
+                for (int k = 0; k < GetSpeciesCount(); k++) {
+                    m_boundarySpeciesSums[end][k] += boundarySpecies[end][k];
+                }
+            }
+        }
+        for (int end = 0; end < 2; end++) {
+            boundaryMass[end] = sums[end][0];
+            boundaryMomentum[end] = sums[end][1];
+            boundaryEnergy[end] = sums[end][2];
+            std::copy(m_boundarySpeciesSums[end].begin(), m_boundarySpeciesSums[end].end(), boundarySpecies[end].begin());
+        }
+        return;
+    }
+
+    //the tiles on the ends add theirs in
+    for (int end = 0; end < 2; end++) {
+        boundaryMass[end] = boundaryMomentum[end] = boundaryEnergy[end] = Real(0);
+        std::fill(boundarySpecies[end].begin(), boundarySpecies[end].end(), Real(0));
+    }
+
+    int halo = steps * GetDependencyRadius();
+    int tileCount = (resolution + tileSize - 1) / tileSize;
+    int windowCapacity = std::min(tileSize + 2 * halo, resolution);
+
+    //the windows are plain simulations with the same scheme, sized once for the largest window
+    int threadCount = m_threadPool != nullptr ? m_threadPool->GetThreadCount() : 1;
+    m_tiles.resize(threadCount);
+    for (auto& tile : m_tiles) {
+        if (tile == nullptr || (int)tile->sizes.size() < windowCapacity) {
+            tile = std::make_unique<BasicGasSimulation>(windowCapacity);
+        }
+        tile->gamma = gamma;
+        tile->equationOfState = equationOfState;
+        tile->boundary = boundary;
+        tile->timeIntegration = timeIntegration;
+        if (tile->m_reconstruction != m_reconstruction) {
+            tile->SetReconstruction(m_reconstruction);
+        }
+        //the species arrays of a window are strided by its own size, so they are sized for the largest one
+        if (tile->GetSpeciesCount() != GetSpeciesCount()) {
+            tile->resolution = (int)tile->sizes.size();
+            tile->SetSpecies(m_species);
+        }
+        tile->ghostFractions[0] = ghostFractions[0];
+        tile->ghostFractions[1] = ghostFractions[1];
+        //the sources are per region, a window takes those of the regions it covers
+        size_t sourceSize = lossCoefficient.empty() ? 0 : tile->sizes.size();
+        tile->areaGradient.resize(sourceSize);
+        tile->lossCoefficient.resize(sourceSize);
+        tile->heatTransferCoefficient.resize(sourceSize);
+        tile->wallTemperature = wallTemperature;
+    }
+
+    auto stepTile = [&](int index) {
+        BasicGasSimulation& tile = *m_tiles[m_threadPool != nullptr ? m_threadPool->GetCurrentThreadIndex() : 0];
+        int begin = index * tileSize;
+        StepTile(tile, begin, std::min(begin + tileSize, resolution), halo, dt, steps);
+    };
+    if (m_threadPool != nullptr) {
+        m_threadPool->ParallelFor(tileCount, stepTile);
+    }
+    else {
+        for (int index = 0; index < tileCount; index++) {
+            stepTile(index);
+        }
+    }
+
+    SwapBuffers();
+    timeStep = dt;
+    time += dt * Real(steps);
+}
+
+//every policy combination is compiled here, so the definitions can stay out of the header
+#define INSTANTIATE_GAS_SIMULATION(Real, Flux) \
+    template class BasicGasSimulation<Real, Flux, ReflectiveBoundary>; \
+    template class BasicGasSimulation<Real, Flux, TransmissiveBoundary>; \
+    template class BasicGasSimulation<Real, Flux, InflowOutflowBoundary>; \
+    template class BasicGasSimulation<Real, Flux, ExternalBoundary>;
+
+INSTANTIATE_GAS_SIMULATION(float, RusanovFlux)
+INSTANTIATE_GAS_SIMULATION(float, HLLFlux)
+INSTANTIATE_GAS_SIMULATION(float, HLLCFlux)
+INSTANTIATE_GAS_SIMULATION(float, RoeFlux)
+INSTANTIATE_GAS_SIMULATION(double, RusanovFlux)
+INSTANTIATE_GAS_SIMULATION(double, HLLFlux)
+INSTANTIATE_GAS_SIMULATION(double, HLLCFlux)
+INSTANTIATE_GAS_SIMULATION(double, RoeFlux)
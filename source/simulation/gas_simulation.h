@@ -6,47 +6,227 @@
 
 #ifndef GAS_SIMULATION_H
 #define GAS_SIMULATION_H
+#include <limits>
+#include <memory>
 #include <vector>
 
+#include "block_tridiagonal.h"
+#include "boundary_conditions.h"
+#include "equation_of_state.h"
+#include "flux_kernels.h"
+#include "reconstruction.h"
+#include "source_terms.h"
 #include "glm/vec3.hpp"
 
 #endif //GAS_SIMULATION_H
 
-//for simplified uses
+class ThreadPool;
+
+//for simplified uses, and the species a BasicGasSimulation tracks
 struct Gas {
     float specificConstant = 1.0f;
     float density = 1.0f;
+    float heatCapacityRatio = 1.4f;
     glm::vec3 color = glm::vec3(0.8f);
 };
 
-//for CFD
-struct GasRegion {
-    float size = 0;
-    float density = 1.0f;
-    float velocity = 0.0f;
-    float pressure = 1.0f;
-    float energy = 0.0f;
-    glm::vec3 conservatives;
-    glm::vec3 flux;
-    glm::vec3 previousFluxHalf = glm::vec3(1.0f);
-    GasRegion(float size) : size(size) {};
+//time integration of BasicGasSimulation, SSP_RK2 is the two stage strong stability preserving Runge-Kutta
+//(Heun) scheme and pairs with the MUSCL reconstructions for a fully second order update.
+//BACKWARD_EULER is a linearised implicit step (one block tridiagonal solve per step) for low mach pipe flow,
+//where the acoustic CFL limit is far below what the flow needs. it stays stable at CFL 10-100, set CFL to match
+enum TimeIntegration {
+    FORWARD_EULER,
+    SSP_RK2,
+    BACKWARD_EULER
 };
 
-class GasSimulation {
+//for CFD
+//cell state is kept as structure-of-arrays (one contiguous array per field) so the flux kernels can stream
+//whole vector lanes instead of striding over interleaved regions.
+//the scalar type, riemann solver (flux_kernels.h) and wall treatment (boundary_conditions.h) are template
+//policies, so the cell loops are specialised at compile time and never go through a virtual call. the equation
+//of state is picked at run time, but only once per sweep, each sweep is compiled for both
+template<typename Real, typename Flux, typename Boundary>
+class BasicGasSimulation {
     int resolution = 32;
-;
-    glm::vec3 RiemannSolver(glm::vec3 ul, glm::vec3 ur);
-    void ComputeState();
-    void UpdatePrimatives();
+
+    //back buffers for the conservatives. a step reads the public arrays and writes these, then the two are
+    //swapped (a pointer swap), so nothing is allocated or copied once the simulation is constructed
+    std::vector<Real> m_nextDensity;
+    std::vector<Real> m_nextMomentum;
+    std::vector<Real> m_nextEnergy;
+
+    //per block scratch for the wave speed reduction, sized with the thread pool
+    ThreadPool* m_threadPool = nullptr;
+    std::vector<Real> m_blockWaveSpeeds;
+
+    //reconstructed interface states, only sized when a MUSCL reconstruction is selected
+    Reconstruction m_reconstruction = PIECEWISE_CONSTANT;
+    std::vector<Real> m_leftDensity;
+    std::vector<Real> m_leftMomentum;
+    std::vector<Real> m_leftEnergy;
+    std::vector<Real> m_rightDensity;
+    std::vector<Real> m_rightMomentum;
+    std::vector<Real> m_rightEnergy;
+
+    //linearised implicit system, one row of blocks per interior region. only sized on the first implicit step
+    std::vector<Block3<Real>> m_lowerBlocks;
+    std::vector<Block3<Real>> m_diagonalBlocks;
+    std::vector<Block3<Real>> m_upperBlocks;
+    std::vector<Real> m_implicitIncrement;
+
+    //species back buffer and the factored implicit species system (BACKWARD_EULER). empty without species
+    std::vector<Gas> m_species;
+    std::vector<Real> m_nextSpeciesDensity;
+    std::vector<Real> m_speciesLower;
+    std::vector<Real> m_speciesUpper;
+    std::vector<Real> m_speciesScale;
+
+    int GetBlockCount() const;
+    void GetBlockRange(int block, int blockCount, int& begin, int& end) const;
+    template<typename Task>
+    void ForEachBlock(int blockCount, const Task& task);
+    template<typename Task>
+    auto WithEquationOfState(const Task& task) const;
+    void ReconstructFaces(int begin, int end);
+    Real ComputeFluxes(int begin, int end);
+    void ComputeSpeciesFluxes(int begin, int end);
+    void UpdateRegions(int begin, int end, Real dt, Real previousWeight);
+    void UpdateSpecies(int begin, int end, Real dt, Real previousWeight);
+    Real ComputeStageFluxes(int blockCount, Real dt);
+    Real AdvanceStage(int blockCount, Real dt, Real previousWeight);
+    void AccumulateBoundaryFluxes(Real dt, Real previousWeight);
+    void AssembleImplicitRows(int begin, int end, Real dt);
+    template<typename Eos>
+    void AssembleImplicitRows(int begin, int end, Real dt, const Eos& eos);
+    Real AdvanceImplicit(int blockCount, Real dt);
+    void AdvanceImplicitSpecies(Real dt);
+    void AdvanceSources(int blockCount, Real dt);
+    void ApplyBoundaries(std::vector<Real>& density, std::vector<Real>& momentum, std::vector<Real>& energy,
+                         std::vector<Real>& speciesDensity);
+    void SwapBuffers();
+    void UpdatePrimatives(int begin, int end);
+    void ComputeState(Real dt);
+
+    //temporal blocking scratch, one window simulation per thread
+    std::vector<std::unique_ptr<BasicGasSimulation>> m_tiles;
+    std::vector<Real> m_boundarySpeciesSums[2];
+
+    Real GetSmallestSize() const;
+    int GetDependencyRadius() const;
+    void StepTile(BasicGasSimulation& tile, int begin, int end, int halo, Real dt, int steps);
+    void AddBoundaryFluxes(const BasicGasSimulation& tile, int end);
 
 public:
-    std::vector<GasRegion> regions;
-    std::vector<glm::vec3> fluxes;
-    float gamma = 1.4f;
-    float CFL = 0.9f;
+    using Scalar = Real;
+
+    std::vector<Real> sizes;
+
+    //conservatives (density doubles as a primitive)
+    std::vector<Real> density;
+    std::vector<Real> momentum;
+    std::vector<Real> energy;
+
+    //primitives
+    std::vector<Real> velocity;
+    std::vector<Real> pressure;
+
+    //interface fluxes, interface i sits between region i and i + 1
+    std::vector<Real> massFlux;
+    std::vector<Real> momentumFlux;
+    std::vector<Real> energyFlux;
+
+    //flux through the first and last interface integrated over the last Step, with the same stage weights as
+    //the regions, so whatever couples the ends (PipeNetwork) can balance exactly what the pipe exchanged
+    Real boundaryMass[2] = {};
+    Real boundaryMomentum[2] = {};
+    Real boundaryEnergy[2] = {};
 
-    GasSimulation(int resolution = 32);
+    //passive species (SetSpecies) carried with the mass flux, each kept as one contiguous array of regions so a
+    //species is advected with whole packs: species k of region i is at k * resolution + i. the partial densities
+    //are conservatives, the mass fractions primitives, the species fluxes sit at the index of their interface.
+    //BACKWARD_EULER moves them with an implicit upwind step, bounded at any CFL but only conservative to the
+    //linearisation, like the rest of that scheme. the species are purely passive markers: the flux, the equation
+    //of state and the network nodes all keep following gamma (or equationOfState), a species only carries a name
+    //and a colour for telemetry and the editor, its gas constant and gamma are not read
+    std::vector<Real> speciesDensity;
+    std::vector<Real> massFractions;
+    std::vector<Real> speciesFlux;
 
-    void SetState(int regionIndex, float density, float velocity, float pressure);
+    //mass fractions of the gas each end's ghost region holds, one per species. empty takes the neighbouring
+    //region's, which is what walls and outflows want, an inflow sets the composition it brings in
+    std::vector<Real> ghostFractions[2];
+
+    //species flux through the first and last interface over the last Step, like boundaryMass
+    std::vector<Real> boundarySpecies[2];
+
+    //quasi-1D pipe geometry (source_terms.h, SetPipeGeometry), per region: the relative area change dA/dx / A,
+    //the loss coefficient k of the momentum loss k rho u |u| (f / 2D of the walls plus K / 2dx of the fittings
+    //in the region) and the heat transfer coefficient of the walls. empty, the default, is a frictionless
+    //adiabatic tube of constant area and skips the sources altogether
+    std::vector<Real> areaGradient;
+    std::vector<Real> lossCoefficient;
+    std::vector<Real> heatTransferCoefficient;
+    //R T of the walls, 0 keeps them adiabatic
+    Real wallTemperature = 0;
+
+    Real gamma = 1.4;
+    //a tabulated gas (equation_of_state.h) to follow instead of the constant gamma, not owned
+    const GasPropertyTable<Real>* equationOfState = nullptr;
+    Real CFL = 0.9;
+    Real maxWaveSpeed = 0;
+
+    //simulated time, the last step taken and an upper bound on it (to land exactly on output times)
+    Real time = 0;
+    Real timeStep = 0;
+    Real maxTimeStep = std::numeric_limits<Real>::infinity();
+
+    TimeIntegration timeIntegration = FORWARD_EULER;
+
+    //policy state, e.g. the inflow/outflow conditions of InflowOutflowBoundary
+    Boundary boundary = {};
+
+    //parallel stepping, the region array is split into one block per thread once it is long enough to pay
+    //for the hand off. results are bit-identical to the serial path for any thread count
+    int minimumBlockSize = 8192;
+
+    BasicGasSimulation(int resolution = 32);
+
+    int GetResolution() const { return resolution; }
+    void SetThreadPool(ThreadPool* threadPool);
+    Reconstruction GetReconstruction() const { return m_reconstruction; }
+    void SetReconstruction(Reconstruction reconstruction);
+
+    //keeps the region's mass fractions
+    void SetState(int regionIndex, Real density, Real velocity, Real pressure);
+
+    int GetSpeciesCount() const { return (int)m_species.size(); }
+    const std::vector<Gas>& GetSpecies() const { return m_species; }
+    //every region starts out as the first species
+    void SetSpecies(const std::vector<Gas>& species);
+    //one fraction per species, they should add up to one
+    void SetMassFractions(int regionIndex, const Real* fractions);
+
+    //the source coefficients of a pipe from the area and hydraulic diameter of every region, the darcy friction
+    //factor of its walls and the loss coefficients of the fittings in each region (nullptr for none). the walls
+    //exchange heat by the reynolds analogy, Stanton number f / 8
+    void SetPipeGeometry(const Real* areas, const Real* diameters, Real frictionFactor, const Real* fittingLosses = nullptr);
+
+    //largest stable step for the current state, without stepping
+    Real ComputeTimeStep() const;
+
+    //advance with the CFL step, or with a fixed step
     void Step();
-};
\ No newline at end of file
+    void Step(Real dt);
+
+    //temporal blocking, equivalent to calling Step(dt) steps times. the grid is cut into tiles of tileSize
+    //regions, and each tile is copied with a halo wide enough for the whole run (the trapezoid of regions its
+    //result depends on) into a cache sized window that is advanced all steps in one go. results are
+    //bit-identical to plain stepping, at the cost of recomputing the halos. BACKWARD_EULER couples the whole
+    //pipe every step, so it falls back to plain stepping. the boundary fluxes (boundaryMass and the others)
+    //are those of the whole run, the sum of its steps, so what couples the ends balances all of it at once
+    void StepBlocked(Real dt, int steps, int tileSize = 4096);
+};
+
+//the configuration used by the editor
+using GasSimulation = BasicGasSimulation<float, HLLFlux, ReflectiveBoundary>;
@@ -0,0 +1,954 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "network_simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "glm/geometric.hpp"
+#include "checkpoint.h"
+#include "telemetry.h"
+
+//checkpoint sections, the per pipe ones are indexed by pipe
+enum NetworkCheckpointSection {
+    LAYOUT_SETTINGS_SECTION = 1,
+    LAYOUT_COMPONENTS_SECTION,
+    LAYOUT_PIPES_SECTION,
+    LAYOUT_PORTS_SECTION,
+    SIMULATION_STATE_SECTION,
+    INLET_PRESSURES_SECTION,
+    OUTLET_PRESSURES_SECTION,
+    NODES_SECTION,
+    STEADY_PRESSURES_SECTION,
+    STEADY_FLOWS_SECTION,
+    PIPE_STATE_SECTION,
+    PIPE_DENSITY_SECTION,
+    PIPE_MOMENTUM_SECTION,
+    PIPE_ENERGY_SECTION,
+    PIPE_VELOCITY_SECTION,
+    PIPE_PRESSURE_SECTION,
+    BLOWDOWN_STATE_SECTION,
+    LAYOUT_LOSSES_SECTION,
+    LAYOUT_BENDS_SECTION,
+    LAYOUT_SPECIES_SECTION,
+    LAYOUT_FRACTIONS_SECTION,
+    NODE_FRACTIONS_SECTION,
+    LUMPED_SPECIES_SECTION,
+    PIPE_SPECIES_DENSITY_SECTION,
+    PIPE_MASS_FRACTIONS_SECTION,
+    PIPE_BOUNDARY_SPECIES_SECTION,
+    PIPE_GHOST_FRACTIONS_SECTION
+};
+
+using NetworkReal = PipeNetwork::Simulation::Scalar;
+
+struct LayoutSettingsState {
+    float ambientPressure;
+    float ambientDensity;
+    float pipeRegionSize;
+    float sleepTolerance;
+    int fidelity;
+};
+
+struct SimulationState {
+    double time;
+    int mode;
+    NetworkReal networkTime;
+    NetworkReal networkTimeStep;
+    NetworkReal gamma;
+    NetworkReal CFL;
+    double blowdownStepSize;
+};
+
+//what a pipe carries from one step to the next besides its region arrays (all of a lumped pipe's state)
+struct PipeState {
+    NetworkReal time;
+    NetworkReal timeStep;
+    NetworkReal maxWaveSpeed;
+    NetworkReal boundaryMass[2];
+    NetworkReal boundaryMomentum[2];
+    NetworkReal boundaryEnergy[2];
+    ExternalBoundary boundary;
+    PipeSleepState<NetworkReal> sleep;
+    PipeFidelityState<NetworkReal> fidelity;
+};
+
+//loss coefficient of a bend (Idelchik): a rounded bend loses A(angle) B(radius / diameter), a sharp mitre
+//0.95 sin^2 + 2.05 sin^4 of half its angle (Weisbach). a bend rounded too tightly is no better than a mitre
+static float ComputeBendLoss(float angle, float radius, float diameter) {
+    float halfSine = std::sin(0.5f * angle);
+    float mitre = 0.95f * halfSine * halfSine + 2.05f * halfSine * halfSine * halfSine * halfSine;
+    if (!(radius > 0.0f) || !(diameter > 0.0f)) {
+        return mitre;
+    }
+
+    static const float angles[] = {0.0f, 20.0f, 30.0f, 45.0f, 60.0f, 75.0f, 90.0f, 110.0f, 130.0f, 150.0f, 180.0f};
+    static const float factors[] = {0.0f, 0.31f, 0.45f, 0.6f, 0.78f, 0.9f, 1.0f, 1.13f, 1.2f, 1.28f, 1.4f};
+    float degrees = std::min(std::max(angle * (float)(180.0 / M_PI), 0.0f), 180.0f);
+    int interval = 0;
+    while (interval < 9 && degrees > angles[interval + 1]) {
+        interval++;
+    }
+    float weight = (degrees - angles[interval]) / (angles[interval + 1] - angles[interval]);
+    float angleFactor = factors[interval] + weight * (factors[interval + 1] - factors[interval]);
+    float ratio = radius / diameter;
+    float radiusFactor = ratio >= 1.0f ? 0.21f / std::sqrt(ratio) : 0.21f / std::pow(ratio, 2.5f);
+    return std::min(angleFactor * radiusFactor, mitre);
+}
+
+void AddPathBends(int pipe, const std::vector<glm::vec3>& path, const std::vector<float>& bevelRadii, std::vector<PipeBend>& bends) {
+    float position = 0.0f;
+    for (int i = 1; i + 1 < (int)path.size(); i++) {
+        glm::vec3 incoming = path[i] - path[i - 1];
+        glm::vec3 outgoing = path[i + 1] - path[i];
+        position += glm::length(incoming);
+        if (glm::length(incoming) <= 0.0f || glm::length(outgoing) <= 0.0f) {
+            continue;
+        }
+        float angle = std::acos(glm::clamp(glm::dot(glm::normalize(incoming), glm::normalize(outgoing)), -1.0f, 1.0f));
+        if (angle <= 1e-3f) {
+            continue;
+        }
+
+        //the bevel cuts both legs at its radius times the cosine of half the angle from the corner, the arc
+        //touching both cuts has a radius of that cut over the tangent of half the angle
+        PipeBend bend;
+        bend.pipe = pipe;
+        bend.position = position;
+        bend.angle = angle;
+        float bevel = i < (int)bevelRadii.size() ? bevelRadii[i] : 0.0f;
+        bend.radius = bevel * std::cos(0.5f * angle) / std::tan(0.5f * angle);
+        bends.push_back(bend);
+    }
+}
+
+int FindConnectionPoint(const std::vector<glm::vec3>& connectionPoints, glm::vec3 componentPosition, glm::vec3 point, float tolerance) {
+    for (int i = 0; i < (int)connectionPoints.size(); i++) {
+        if (glm::distance(componentPosition + connectionPoints[i], point) <= tolerance) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void NetworkSimulation::Compile(const NetworkLayout& layout) {
+    float ambientPressure = layout.ambientPressure;
+    float ambientDensity = layout.ambientDensity;
+    m_layout = layout;
+    m_ambientPressure = ambientPressure;
+    m_time = 0.0;
+    m_network = PipeNetwork();
+    m_blowdown = DormandPrinceIntegrator();
+    m_blowdownState.clear();
+    m_network.sleepTolerance = layout.sleepTolerance;
+    m_network.SetSpecies(layout.species);
+    m_steadyNetwork = SteadyNetworkSolver();
+    m_steadyNetwork.gamma = m_network.gamma;
+    m_steadyNetwork.gasConstantTemperature = ambientPressure / ambientDensity;
+    m_steadyNetwork.wallTemperature = ambientPressure / ambientDensity;
+    m_steadyEnds.assign(2 * layout.pipes.size(), -1);
+    m_endNodes.assign(2 * layout.pipes.size(), -1);
+    m_componentTypes.clear();
+    m_componentNodes.clear();
+    m_componentSteadyNodes.clear();
+    m_componentSteadyEdges.clear();
+    m_inletPressures.clear();
+    m_outletPressures.clear();
+    m_tanks.clear();
+    m_engines.clear();
+    m_ports = layout.ports;
+    m_mixtureRatios.clear();
+    m_throatAreas.clear();
+    m_chamberVolumes.clear();
+    m_pressureUnit = (float)(SEA_LEVEL_PRESSURE / ambientPressure);
+    m_velocityUnit = (float)std::sqrt(SEA_LEVEL_GAS_CONSTANT_TEMPERATURE / (ambientPressure / ambientDensity));
+
+    //one simulation per pipe, in layout order. with friction each bend is a fitting in the region it falls in,
+    //the steady solver takes their sum per pipe
+    std::vector<float> bendLosses(layout.pipes.size(), 0.0f);
+    for (const PipeLayout& pipe : layout.pipes) {
+        float length = std::max(pipe.length, layout.pipeRegionSize);
+        int regions = std::max((int)std::ceil(length / layout.pipeRegionSize), 8);
+        float density = pipe.density > 0.0f ? pipe.density : ambientDensity;
+        float pressure = ambientPressure + (pipe.density > 0.0f ? pipe.pressure : 0.0f);
+        int index = m_network.AddPipe(length, (float)M_PI * pipe.radius * pipe.radius, regions + 2, density, pressure);
+        if (pipe.velocity != 0.0f) {
+            PipeNetwork::Simulation& simulation = m_network.GetPipe(index);
+            for (int r = 0; r < simulation.GetResolution(); r++) {
+                simulation.SetState(r, density, pipe.velocity, pressure);
+            }
+        }
+        if (layout.frictionFactor > 0.0f) {
+            std::vector<float> fittingLosses(regions + 2, 0.0f);
+            for (const PipeBend& bend : layout.bends) {
+                if (bend.pipe != index) {
+                    continue;
+                }
+                float loss = ComputeBendLoss(bend.angle, bend.radius, 2.0f * pipe.radius);
+                int region = 1 + std::min(std::max((int)(bend.position / length * regions), 0), regions - 1);
+                fittingLosses[region] += loss;
+                bendLosses[index] += loss;
+            }
+            m_network.SetWallLosses(index, layout.frictionFactor, fittingLosses.data(), ambientPressure / ambientDensity);
+        }
+        m_network.SetFidelity(index, layout.fidelity);
+    }
+
+    //one node per component, a pump is two nodes and an edge in the steady graph
+    std::vector<int> steadyOutlets(layout.components.size(), -1);
+    for (int i = 0; i < (int)layout.components.size(); i++) {
+        const ComponentLayout& component = layout.components[i];
+        int node = 0, steadyNode = 0;
+        if (component.type == TANK_COMPONENT) {
+            float volume = component.volume > 0.0f ? component.volume : 1.0f;
+            float density = component.storedAmount > 0.0f ? component.storedAmount / volume : ambientDensity;
+            node = m_network.AddNode(volume, density, ambientPressure + component.outletPressure);
+            steadyNode = m_steadyNetwork.AddNode(ambientPressure + component.outletPressure, true);
+            m_steadyNetwork.SetTemperature(steadyNode, (ambientPressure + component.outletPressure) / density);
+            m_tanks.push_back(i);
+        }
+        else if (component.type == PUMP_COMPONENT) {
+            float rise = component.outletPressure - component.inletPressure;
+            node = m_network.AddNode(0.0f, ambientDensity, ambientPressure, rise);
+            steadyNode = m_steadyNetwork.AddNode(ambientPressure, false);
+            steadyOutlets[i] = m_steadyNetwork.AddNode(ambientPressure + rise, false);
+        }
+        else if (component.type == ENGINE_COMPONENT) {
+            //the chamber is a fixed pressure sink to the pipes, a burning one is moved by StepCombustion
+            float chamberPressure = std::max(ambientPressure + component.inletPressure, 0.01f * ambientPressure);
+            node = m_network.AddNode(std::numeric_limits<float>::infinity(), ambientDensity, chamberPressure);
+            steadyNode = m_steadyNetwork.AddNode(chamberPressure, true);
+            m_steadyNetwork.SetTemperature(steadyNode, chamberPressure / ambientDensity);
+            m_engines.push_back(i);
+            m_mixtureRatios.push_back(component.mixtureRatio);
+            m_throatAreas.push_back(component.throatArea);
+            m_chamberVolumes.push_back(component.volume > 0.0f ? component.volume : 1.0f);
+        }
+        m_componentTypes.push_back(component.type);
+        m_componentNodes.push_back(node);
+        m_componentSteadyNodes.push_back(steadyNode);
+        m_componentSteadyEdges.push_back(-1);
+        m_inletPressures.push_back(component.inletPressure);
+        m_outletPressures.push_back(component.outletPressure);
+
+        //weights rather than fractions, so a scenario can set one species at a time
+        size_t speciesCount = layout.species.size();
+        if (speciesCount > 0 && layout.componentMassFractions.size() >= (i + 1) * speciesCount) {
+            const float* weights = layout.componentMassFractions.data() + i * speciesCount;
+            float total = 0.0f;
+            for (size_t k = 0; k < speciesCount; k++) {
+                total += std::max(weights[k], 0.0f);
+            }
+            float* fractions = m_network.GetNodeMassFractions(node);
+            for (size_t k = 0; k < speciesCount && total > 0.0f; k++) {
+                fractions[k] = std::max(weights[k], 0.0f) / total;
+            }
+        }
+    }
+
+    std::vector<bool> endConnected(2 * layout.pipes.size(), false);
+    for (const PortLayout& port : layout.ports) {
+        int end = 2 * port.pipe + port.end;
+        endConnected[end] = true;
+        m_network.Connect(port.pipe, port.end, m_componentNodes[port.component], port.outlet);
+        m_endNodes[end] = m_componentNodes[port.component];
+        m_steadyEnds[end] = port.outlet ? steadyOutlets[port.component] : m_componentSteadyNodes[port.component];
+    }
+
+    //free pipe ends that meet are joined, anything still unconnected is a closed end
+    auto position = [&layout](int end) {
+        return end % 2 == 0 ? layout.pipes[end / 2].start : layout.pipes[end / 2].end;
+    };
+    for (int a = 0; a < (int)endConnected.size(); a++) {
+        if (endConnected[a]) {
+            continue;
+        }
+        int node = -1;
+        for (int b = a + 1; b < (int)endConnected.size(); b++) {
+            if (endConnected[b] || b / 2 == a / 2 || !(glm::distance(position(a), position(b)) <= 1e-3f)) {
+                continue;
+            }
+            if (node == -1) {
+                node = m_network.AddNode(0.0f, ambientDensity, ambientPressure);
+                m_steadyEnds[a] = m_steadyNetwork.AddNode(ambientPressure, false);
+                endConnected[a] = true;
+                m_network.Connect(a / 2, (PipeEnd)(a % 2), node);
+                m_endNodes[a] = node;
+            }
+            m_steadyEnds[b] = m_steadyEnds[a];
+            endConnected[b] = true;
+            m_network.Connect(b / 2, (PipeEnd)(b % 2), node);
+            m_endNodes[b] = node;
+        }
+    }
+
+    //steady edges, pipes first so the edge index is the pipe index, with the losses of the transient pipes. a
+    //closed end is a node of its own
+    for (int i = 0; i < (int)layout.pipes.size(); i++) {
+        for (int end = 0; end < 2; end++) {
+            if (m_steadyEnds[2 * i + end] == -1) {
+                m_steadyEnds[2 * i + end] = m_steadyNetwork.AddNode(ambientPressure, false);
+            }
+        }
+        float length = std::max(layout.pipes[i].length, layout.pipeRegionSize);
+        m_steadyNetwork.AddPipe(m_steadyEnds[2 * i], m_steadyEnds[2 * i + 1], length, 2.0f * layout.pipes[i].radius, layout.frictionFactor, bendLosses[i]);
+    }
+    for (int i = 0; i < (int)layout.components.size(); i++) {
+        const ComponentLayout& component = layout.components[i];
+        if (component.type == PUMP_COMPONENT) {
+            float rise = component.outletPressure - component.inletPressure;
+            m_componentSteadyEdges[i] = m_steadyNetwork.AddPump(m_componentSteadyNodes[i], steadyOutlets[i], rise, component.maxMassFlowRate, ambientDensity);
+        }
+    }
+}
+
+void NetworkSimulation::CarryState(const NetworkSimulation& previous, const std::vector<int>& pipeSources, const std::vector<int>& componentSources) {
+    const PipeNetwork& network = previous.m_network;
+    int speciesCount = m_network.GetSpeciesCount();
+    bool carrySpecies = speciesCount > 0 && network.GetSpeciesCount() == speciesCount;
+    std::vector<float> fractions(speciesCount);
+
+    for (int i = 0; i < GetPipeCount() && i < (int)pipeSources.size(); i++) {
+        int source = pipeSources[i];
+        if (source < 0 || source >= network.GetPipeCount()) {
+            continue;
+        }
+        const PipeNetwork::Simulation& from = network.GetPipe(source);
+        const PipeFidelityState<float>& fromState = network.GetFidelityState(source);
+        PipeNetwork::Simulation& to = m_network.GetPipe(i);
+        int fromResolution = from.GetResolution();
+        int resolution = to.GetResolution();
+
+        //the state goes into the regions, so the pipe is resolved while it is carried
+        m_network.SetFidelity(i, RESOLVED_FIDELITY);
+        if (fromState.lumped) {
+            float density, velocity, pressure;
+            network.GetLumpedState(source, density, velocity, pressure);
+            const float* masses = network.GetLumpedSpeciesMasses(source);
+            float total = 0.0f;
+            for (int k = 0; carrySpecies && k < speciesCount; k++) {
+                total += masses[k];
+            }
+            for (int k = 0; carrySpecies && k < speciesCount; k++) {
+                fractions[k] = total > 0.0f ? masses[k] / total : (k == 0 ? 1.0f : 0.0f);
+            }
+            for (int r = 1; r < resolution - 1; r++) {
+                to.SetState(r, density, velocity, pressure);
+                if (carrySpecies) {
+                    to.SetMassFractions(r, fractions.data());
+                }
+            }
+        }
+        else if (fromResolution == resolution) {
+            to.density = from.density;
+            to.momentum = from.momentum;
+            to.energy = from.energy;
+            to.velocity = from.velocity;
+            to.pressure = from.pressure;
+            if (carrySpecies) {
+                to.speciesDensity = from.speciesDensity;
+                to.massFractions = from.massFractions;
+            }
+        }
+        else {
+            //each region takes the state of the previous region at its centre, relative to the length
+            int interior = resolution - 2;
+            int fromInterior = fromResolution - 2;
+            for (int r = 1; r <= interior; r++) {
+                int s = 1 + std::min((int)(((float)r - 0.5f) / (float)interior * (float)fromInterior), fromInterior - 1);
+                to.SetState(r, from.density[s], from.velocity[s], from.pressure[s]);
+                for (int k = 0; carrySpecies && k < speciesCount; k++) {
+                    fractions[k] = from.massFractions[(size_t)k * fromResolution + s];
+                }
+                if (carrySpecies) {
+                    to.SetMassFractions(r, fractions.data());
+                }
+            }
+        }
+
+        //a resolved adaptive pipe stays resolved until its own check lumps it
+        if (fromState.fidelity == RESOLVED_FIDELITY) {
+            continue;
+        }
+        if (!fromState.lumped) {
+            PipeFidelityState<float> state = m_network.GetFidelityState(i);
+            state.fidelity = fromState.fidelity;
+            m_network.SetFidelityState(i, state);
+            continue;
+        }
+        //the flows of the halves go on as they were, the gas keeps its density in the new volume
+        m_network.SetFidelity(i, fromState.fidelity);
+        float volumeRatio = (m_network.GetArea(i) * to.sizes[1] * (float)(resolution - 2)) /
+                            (network.GetArea(source) * from.sizes[1] * (float)(fromResolution - 2));
+        PipeFidelityState<float> state = fromState;
+        state.mass *= volumeRatio;
+        state.energy *= volumeRatio;
+        m_network.SetFidelityState(i, state);
+        const float* masses = network.GetLumpedSpeciesMasses(source);
+        for (int k = 0; carrySpecies && k < speciesCount; k++) {
+            m_network.GetLumpedSpeciesMasses(i)[k] = masses[k] * volumeRatio;
+        }
+    }
+
+    //components only take their own node's gas, new ones keep what they were compiled with
+    std::vector<bool> carried(m_network.GetNodeCount(), false);
+    for (int node : m_componentNodes) {
+        carried[node] = true;
+    }
+    auto carryNode = [&](int node, int fromNode) {
+        NetworkNode<float>& to = m_network.GetNode(node);
+        const NetworkNode<float>& from = network.GetNode(fromNode);
+        to.density = from.density;
+        to.pressure = from.pressure;
+        std::copy_n(network.GetNodeMassFractions(fromNode), carrySpecies ? speciesCount : 0, m_network.GetNodeMassFractions(node));
+    };
+    for (int i = 0; i < (int)m_componentNodes.size() && i < (int)componentSources.size(); i++) {
+        int source = componentSources[i];
+        if (source < 0 || source >= (int)previous.m_componentNodes.size() || previous.m_componentTypes[source] != m_componentTypes[i]) {
+            continue;
+        }
+        carryNode(m_componentNodes[i], previous.m_componentNodes[source]);
+        //set points that did not move are left alone, applying one resets a drained tank or a lit chamber
+        if (previous.m_inletPressures[source] != m_inletPressures[i] || previous.m_outletPressures[source] != m_outletPressures[i]) {
+            ApplySetPoints(i);
+        }
+        else if (m_componentTypes[i] == TANK_COMPONENT) {
+            const NetworkNode<float>& node = m_network.GetNode(m_componentNodes[i]);
+            m_steadyNetwork.SetPressure(m_componentSteadyNodes[i], node.pressure);
+            m_steadyNetwork.SetTemperature(m_componentSteadyNodes[i], node.pressure / node.density);
+        }
+    }
+    for (int i = 0; i < GetPipeCount() && i < (int)pipeSources.size(); i++) {
+        int source = pipeSources[i];
+        for (int end = 0; end < 2 && source >= 0 && source < network.GetPipeCount(); end++) {
+            int node = m_endNodes[2 * i + end];
+            int fromNode = previous.m_endNodes[2 * source + end];
+            if (node != -1 && fromNode != -1 && !carried[node]) {
+                carryNode(node, fromNode);
+                carried[node] = true;
+            }
+        }
+    }
+
+    m_time = previous.m_time;
+    m_network.time = network.time;
+}
+
+void NetworkSimulation::SetInletPressure(int component, float pressure) {
+    m_inletPressures[component] = pressure;
+    ApplySetPoints(component);
+}
+
+void NetworkSimulation::SetOutletPressure(int component, float pressure) {
+    m_outletPressures[component] = pressure;
+    ApplySetPoints(component);
+}
+
+void NetworkSimulation::ApplySetPoints(int component) {
+    NetworkNode<float>& node = m_network.GetNode(m_componentNodes[component]);
+    if (m_componentTypes[component] == TANK_COMPONENT) {
+        //a regulator resetting the tank, the gas it holds is compressed or expanded isentropically
+        float tankPressure = std::max(m_ambientPressure + m_outletPressures[component], 1e-3f * m_ambientPressure);
+        node.density *= std::pow(tankPressure / node.pressure, 1.0f / m_network.gamma);
+        node.pressure = tankPressure;
+        m_steadyNetwork.SetPressure(m_componentSteadyNodes[component], tankPressure);
+        m_steadyNetwork.SetTemperature(m_componentSteadyNodes[component], tankPressure / node.density);
+    }
+    else if (m_componentTypes[component] == PUMP_COMPONENT) {
+        node.pressureRise = m_outletPressures[component] - m_inletPressures[component];
+        m_steadyNetwork.SetPumpRise(m_componentSteadyEdges[component], node.pressureRise);
+    }
+    else if (m_componentTypes[component] == ENGINE_COMPONENT) {
+        float chamberPressure = std::max(m_ambientPressure + m_inletPressures[component], 0.01f * m_ambientPressure);
+        node.pressure = chamberPressure;
+        m_steadyNetwork.SetPressure(m_componentSteadyNodes[component], chamberPressure);
+        m_steadyNetwork.SetTemperature(m_componentSteadyNodes[component], chamberPressure / node.density);
+    }
+}
+
+void NetworkSimulation::SetPipeFidelity(int pipe, PipeFidelity fidelity) {
+    for (int i = 0; i < m_network.GetPipeCount(); i++) {
+        if (pipe == -1 || pipe == i) {
+            m_network.SetFidelity(i, fidelity);
+        }
+    }
+}
+
+void NetworkSimulation::AdvanceBlowdown(double time) {
+    //the integrator keeps the tanks in double, they are only taken back from the nodes when something else
+    //(a transient step, a set point) changed them since
+    float gamma = m_network.gamma;
+    int tankCount = (int)m_tanks.size();
+    bool changed = (int)m_blowdownState.size() != 2 * tankCount;
+    for (int i = 0; i < tankCount && !changed; i++) {
+        const NetworkNode<float>& node = m_network.GetNode(m_componentNodes[m_tanks[i]]);
+        changed = node.density != (float)(m_blowdownState[2 * i] / node.volume) ||
+                  node.pressure != (float)((gamma - 1.0) * m_blowdownState[2 * i + 1] / node.volume);
+    }
+    if (changed) {
+        m_blowdownState.resize(2 * tankCount);
+        for (int i = 0; i < tankCount; i++) {
+            const NetworkNode<float>& node = m_network.GetNode(m_componentNodes[m_tanks[i]]);
+            m_blowdownState[2 * i] = (double)node.density * node.volume;
+            m_blowdownState[2 * i + 1] = (double)node.pressure / (gamma - 1.0) * node.volume;
+        }
+    }
+
+    //every evaluation solves the steady network at the tank pressures and temperatures it is handed, warm
+    //started from the last, so the flows after the last step are those of the final state. a state the network
+    //does not converge at fails the step, which is retaken shorter, and when no step gets past it the tanks stay
+    //at the last state it converged at with its flows
+    m_blowdown.Integrate(m_blowdownState, m_time, time, [&](double, const double* state, double* derivative) {
+        for (int i = 0; i < tankCount; i++) {
+            double volume = m_network.GetNode(m_componentNodes[m_tanks[i]]).volume;
+            double pressure = std::max((gamma - 1.0) * state[2 * i + 1] / volume, 1e-6 * m_ambientPressure);
+            m_steadyNetwork.SetPressure(m_componentSteadyNodes[m_tanks[i]], pressure);
+            m_steadyNetwork.SetTemperature(m_componentSteadyNodes[m_tanks[i]], (gamma - 1.0) * state[2 * i + 1] / std::max(state[2 * i], 1e-30));
+        }
+        if (!m_steadyNetwork.Solve().converged) {
+            return false;
+        }
+        for (int i = 0; i < tankCount; i++) {
+            int node = m_componentSteadyNodes[m_tanks[i]];
+            double inflow = m_steadyNetwork.GetNodeInflow(node);
+            double enthalpy = gamma / (gamma - 1.0) * (inflow < 0.0 ? m_steadyNetwork.GetTemperature(node) : m_steadyNetwork.GetInflowTemperature(node));
+            derivative[2 * i] = inflow;
+            derivative[2 * i + 1] = inflow * enthalpy;
+        }
+        return true;
+    });
+
+    for (int i = 0; i < tankCount; i++) {
+        NetworkNode<float>& node = m_network.GetNode(m_componentNodes[m_tanks[i]]);
+        node.density = (float)(m_blowdownState[2 * i] / node.volume);
+        node.pressure = (float)((gamma - 1.0) * m_blowdownState[2 * i + 1] / node.volume);
+    }
+}
+
+void NetworkSimulation::StepCombustion(float timeStep) {
+    if (m_combustionTable == nullptr || m_combustionTable->IsEmpty()) {
+        return;
+    }
+    for (int i = 0; i < (int)m_engines.size(); i++) {
+        if (m_throatAreas[i] <= 0.0f) {
+            continue;
+        }
+        //V / (R T) dp/dt = inflow - p A* / c*, implicit in the outflow so a small chamber cannot overshoot
+        NetworkNode<float>& node = m_network.GetNode(m_componentNodes[m_engines[i]]);
+        CombustionProperties properties = m_combustionTable->Sample(m_mixtureRatios[i], node.pressure * m_pressureUnit);
+        float characteristicVelocity = properties.characteristicVelocity / m_velocityUnit;
+        float gasConstantTemperature = (float)(UNIVERSAL_GAS_CONSTANT / properties.molecularWeight) * properties.temperature / (m_velocityUnit * m_velocityUnit);
+        float fill = timeStep * gasConstantTemperature / m_chamberVolumes[i];
+        float pressure = (node.pressure + fill * node.massFlowRate) / (1.0f + fill * m_throatAreas[i] / characteristicVelocity);
+        node.pressure = std::max(pressure, m_ambientPressure);
+    }
+}
+
+float NetworkSimulation::ComputeThrust(int engine, float chamberPressure) const {
+    if (m_combustionTable == nullptr || m_combustionTable->IsEmpty() || m_throatAreas[engine] <= 0.0f) {
+        return 0.0f;
+    }
+    CombustionProperties properties = m_combustionTable->Sample(m_mixtureRatios[engine], chamberPressure * m_pressureUnit);
+    return properties.thrustCoefficient * chamberPressure * m_throatAreas[engine];
+}
+
+void NetworkSimulation::Advance(double time, int maxSubSteps) {
+    if (mode == STEADY_STATE) {
+        //at the tanks as the other modes left them
+        for (int tank : m_tanks) {
+            const NetworkNode<float>& node = m_network.GetNode(m_componentNodes[tank]);
+            m_steadyNetwork.SetPressure(m_componentSteadyNodes[tank], node.pressure);
+            m_steadyNetwork.SetTemperature(m_componentSteadyNodes[tank], node.pressure / node.density);
+        }
+        m_steadyNetwork.Solve();
+    }
+    else if (mode == QUASI_STEADY) {
+        AdvanceBlowdown(time);
+    }
+    else if (m_network.GetPipeCount() > 0) {
+        float endTime = m_network.time + (float)time;
+        double stepTime = m_time;
+        for (int step = 0; step < maxSubSteps && m_network.time < endTime; step++) {
+            m_network.maxTimeStep = endTime - m_network.time;
+            m_network.Step();
+            StepCombustion(m_network.timeStep);
+            stepTime = m_network.time < endTime ? stepTime + m_network.timeStep : m_time + time;
+            if (m_telemetry) {
+                RecordTelemetry(stepTime);
+            }
+        }
+    }
+    m_time += time;
+}
+
+void NetworkSimulation::WriteSnapshot(SimulationSnapshot& snapshot) const {
+    snapshot.version = version;
+    snapshot.time = (float)m_time;
+    snapshot.tankStoredAmounts.resize(m_tanks.size());
+    snapshot.engineMassFlowRates.resize(m_engines.size());
+    snapshot.engineThrusts.resize(m_engines.size());
+    snapshot.engineMassFractions.resize(m_engines.size() * m_network.GetSpeciesCount());
+    snapshot.controlPointPressures.resize(m_ports.size());
+    snapshot.pipePressures.resize(m_network.GetPipeCount());
+    snapshot.pipeMassFlowRates.resize(m_network.GetPipeCount());
+    snapshot.activePipeCount = mode != TRANSIENT ? 0 : m_network.GetActivePipeCount();
+    snapshot.lumpedPipeCount = mode != TRANSIENT ? 0 : m_network.GetLumpedPipeCount();
+
+    for (int i = 0; i < (int)m_tanks.size(); i++) {
+        const NetworkNode<float>& node = m_network.GetNode(m_componentNodes[m_tanks[i]]);
+        snapshot.tankStoredAmounts[i] = node.density * node.volume;
+    }
+    for (int i = 0; i < (int)m_engines.size() && m_network.GetSpeciesCount() > 0; i++) {
+        m_network.GetNodeInflowFractions(m_componentNodes[m_engines[i]], &snapshot.engineMassFractions[i * m_network.GetSpeciesCount()]);
+    }
+
+    if (mode != TRANSIENT) {
+        for (int i = 0; i < (int)m_engines.size(); i++) {
+            snapshot.engineMassFlowRates[i] = (float)m_steadyNetwork.GetNodeInflow(m_componentSteadyNodes[m_engines[i]]);
+            snapshot.engineThrusts[i] = ComputeThrust(i, (float)m_steadyNetwork.GetPressure(m_componentSteadyNodes[m_engines[i]]));
+        }
+        for (int i = 0; i < (int)m_ports.size(); i++) {
+            const PortLayout& port = m_ports[i];
+            snapshot.controlPointPressures[i] = (float)m_steadyNetwork.GetPressure(m_steadyEnds[2 * port.pipe + port.end]) - m_ambientPressure;
+        }
+        for (int i = 0; i < m_network.GetPipeCount(); i++) {
+            double pressure = 0.5 * (m_steadyNetwork.GetPressure(m_steadyEnds[2 * i]) + m_steadyNetwork.GetPressure(m_steadyEnds[2 * i + 1]));
+            snapshot.pipePressures[i] = (float)pressure - m_ambientPressure;
+            snapshot.pipeMassFlowRates[i] = (float)m_steadyNetwork.GetMassFlowRate(i);
+        }
+        return;
+    }
+
+    for (int i = 0; i < (int)m_engines.size(); i++) {
+        const NetworkNode<float>& node = m_network.GetNode(m_componentNodes[m_engines[i]]);
+        snapshot.engineMassFlowRates[i] = node.massFlowRate;
+        snapshot.engineThrusts[i] = ComputeThrust(i, node.pressure);
+    }
+    for (int i = 0; i < (int)m_ports.size(); i++) {
+        const PortLayout& port = m_ports[i];
+        const PipeNetwork::Simulation& pipe = m_network.GetPipe(port.pipe);
+        snapshot.controlPointPressures[i] = pipe.pressure[port.end == PIPE_START ? 0 : pipe.GetResolution() - 1] - m_ambientPressure;
+    }
+    for (int i = 0; i < m_network.GetPipeCount(); i++) {
+        if (m_network.IsLumped(i)) {
+            const PipeFidelityState<float>& state = m_network.GetFidelityState(i);
+            float density, velocity, pressure;
+            m_network.GetLumpedState(i, density, velocity, pressure);
+            snapshot.pipePressures[i] = pressure - m_ambientPressure;
+            snapshot.pipeMassFlowRates[i] = 0.5f * (state.massFlowRate[0] + state.massFlowRate[1]);
+            continue;
+        }
+        const PipeNetwork::Simulation& pipe = m_network.GetPipe(i);
+        int interior = pipe.GetResolution() - 2;
+        float pressure = 0.0f;
+        float massFlux = 0.0f;
+        for (int r = 1; r <= interior; r++) {
+            pressure += pipe.pressure[r];
+            massFlux += pipe.momentum[r];
+        }
+        snapshot.pipePressures[i] = pressure / interior - m_ambientPressure;
+        snapshot.pipeMassFlowRates[i] = m_network.GetArea(i) * massFlux / interior;
+    }
+}
+
+std::vector<std::string> NetworkSimulation::GetTelemetryChannels(const std::vector<std::string>& componentNames, const std::vector<std::string>& pipeNames,
+                                                              const std::vector<std::string>& speciesNames) const {
+    std::vector<std::string> species;
+    for (int k = 0; k < m_network.GetSpeciesCount(); k++) {
+        species.push_back("." + (k < (int)speciesNames.size() ? speciesNames[k] : "massFraction" + std::to_string(k)));
+    }
+
+    std::vector<std::string> channels;
+    for (int i = 0; i < m_network.GetPipeCount(); i++) {
+        std::string name = i < (int)pipeNames.size() ? pipeNames[i] : "pipe" + std::to_string(i);
+        for (const char* quantity : {".pressure", ".density", ".velocity", ".massFlowRate"}) {
+            channels.push_back(name + quantity);
+        }
+        for (const std::string& quantity : species) {
+            channels.push_back(name + quantity);
+        }
+    }
+    for (int i = 0; i < (int)m_componentTypes.size(); i++) {
+        std::string name = i < (int)componentNames.size() ? componentNames[i] : "component" + std::to_string(i);
+        channels.push_back(name + ".pressure");
+        channels.push_back(name + ".massFlowRate");
+        if (m_componentTypes[i] == TANK_COMPONENT) {
+            channels.push_back(name + ".storedAmount");
+        }
+        else if (m_componentTypes[i] == ENGINE_COMPONENT) {
+            channels.push_back(name + ".thrust");
+        }
+        for (const std::string& quantity : species) {
+            channels.push_back(name + quantity);
+        }
+    }
+    return channels;
+}
+
+void NetworkSimulation::RecordTelemetry(double time) {
+    float* frame = m_telemetry->BeginFrame(time);
+    if (frame == nullptr) {
+        return;
+    }
+
+    //the middle region of each pipe, like a transducer on it. averaging every region would cost as much as a
+    //good part of the step itself
+    int speciesCount = m_network.GetSpeciesCount();
+    for (int i = 0; i < m_network.GetPipeCount(); i++) {
+        if (m_network.IsLumped(i)) {
+            float density, velocity, pressure;
+            m_network.GetLumpedState(i, density, velocity, pressure);
+            frame[0] = pressure - m_ambientPressure;
+            frame[1] = density;
+            frame[2] = velocity;
+            frame[3] = m_network.GetArea(i) * density * velocity;
+            frame += 4;
+            const float* masses = m_network.GetLumpedSpeciesMasses(i);
+            float total = 0.0f;
+            for (int k = 0; k < speciesCount; k++) {
+                total += masses[k];
+            }
+            for (int k = 0; k < speciesCount; k++) {
+                *frame++ = total > 0.0f ? masses[k] / total : 0.0f;
+            }
+            continue;
+        }
+        const PipeNetwork::Simulation& pipe = m_network.GetPipe(i);
+        int middle = pipe.GetResolution() / 2;
+        frame[0] = pipe.pressure[middle] - m_ambientPressure;
+        frame[1] = pipe.density[middle];
+        frame[2] = pipe.velocity[middle];
+        frame[3] = m_network.GetArea(i) * pipe.momentum[middle];
+        frame += 4;
+        for (int k = 0; k < speciesCount; k++) {
+            *frame++ = pipe.massFractions[(size_t)k * pipe.GetResolution() + middle];
+        }
+    }
+    for (int i = 0, engine = 0; i < (int)m_componentTypes.size(); i++) {
+        const NetworkNode<float>& node = m_network.GetNode(m_componentNodes[i]);
+        *frame++ = node.pressure - m_ambientPressure;
+        *frame++ = node.massFlowRate;
+        if (m_componentTypes[i] == TANK_COMPONENT) {
+            *frame++ = node.density * node.volume;
+        }
+        else if (m_componentTypes[i] == ENGINE_COMPONENT) {
+            *frame++ = ComputeThrust(engine++, node.pressure);
+        }
+        if (speciesCount == 0) {
+            continue;
+        }
+        if (m_componentTypes[i] == ENGINE_COMPONENT) {
+            m_network.GetNodeInflowFractions(m_componentNodes[i], frame);
+        }
+        else {
+            std::copy_n(m_network.GetNodeMassFractions(m_componentNodes[i]), speciesCount, frame);
+        }
+        frame += speciesCount;
+    }
+    m_telemetry->CommitFrame();
+}
+
+bool NetworkSimulation::SaveCheckpoint(const std::string& path, std::string& error) const {
+    LayoutSettingsState settings = {m_layout.ambientPressure, m_layout.ambientDensity, m_layout.pipeRegionSize, m_layout.sleepTolerance, (int)m_layout.fidelity};
+    SimulationState state = {m_time, (int)mode, m_network.time, m_network.timeStep, m_network.gamma, m_network.CFL,
+                             m_blowdown.GetStepSize()};
+
+    //the steady solver only hands out single values, its arrays are small
+    std::vector<double> steadyPressures(m_steadyNetwork.GetNodeCount());
+    std::vector<double> steadyFlows(m_steadyNetwork.GetEdgeCount());
+    for (int i = 0; i < (int)steadyPressures.size(); i++) {
+        steadyPressures[i] = m_steadyNetwork.GetPressure(i);
+    }
+    for (int i = 0; i < (int)steadyFlows.size(); i++) {
+        steadyFlows[i] = m_steadyNetwork.GetMassFlowRate(i);
+    }
+
+    int pipeCount = m_network.GetPipeCount();
+    std::vector<PipeState> pipeStates(pipeCount);
+    for (int i = 0; i < pipeCount; i++) {
+        const PipeNetwork::Simulation& pipe = m_network.GetPipe(i);
+        PipeState& pipeState = pipeStates[i];
+        pipeState.time = pipe.time;
+        pipeState.timeStep = pipe.timeStep;
+        pipeState.maxWaveSpeed = pipe.maxWaveSpeed;
+        for (int end = 0; end < 2; end++) {
+            pipeState.boundaryMass[end] = pipe.boundaryMass[end];
+            pipeState.boundaryMomentum[end] = pipe.boundaryMomentum[end];
+            pipeState.boundaryEnergy[end] = pipe.boundaryEnergy[end];
+        }
+        pipeState.boundary = pipe.boundary;
+        pipeState.sleep = m_network.GetSleepState(i);
+        pipeState.fidelity = m_network.GetFidelityState(i);
+    }
+
+    //the species at both ends of every pipe, boundary species then ghost fractions (4 * species per pipe)
+    size_t speciesCount = m_network.GetSpeciesCount();
+    std::vector<NetworkReal> pipeSpecies(4 * pipeCount * speciesCount);
+    for (int i = 0; i < pipeCount && speciesCount > 0; i++) {
+        const PipeNetwork::Simulation& pipe = m_network.GetPipe(i);
+        NetworkReal* ends = pipeSpecies.data() + 4 * i * speciesCount;
+        for (int end = 0; end < 2; end++) {
+            std::copy_n(pipe.boundarySpecies[end].data(), speciesCount, ends + end * speciesCount);
+            std::copy_n(pipe.ghostFractions[end].data(), speciesCount, ends + (2 + end) * speciesCount);
+        }
+    }
+
+    CheckpointWriter writer;
+    writer.Add(LAYOUT_SETTINGS_SECTION, 0, &settings, 1);
+    writer.Add(LAYOUT_COMPONENTS_SECTION, 0, m_layout.components);
+    writer.Add(LAYOUT_PIPES_SECTION, 0, m_layout.pipes);
+    writer.Add(LAYOUT_PORTS_SECTION, 0, m_layout.ports);
+    writer.Add(SIMULATION_STATE_SECTION, 0, &state, 1);
+    writer.Add(INLET_PRESSURES_SECTION, 0, m_inletPressures);
+    writer.Add(OUTLET_PRESSURES_SECTION, 0, m_outletPressures);
+    writer.Add(NODES_SECTION, 0, m_network.GetNodeCount() > 0 ? &m_network.GetNode(0) : nullptr, m_network.GetNodeCount());
+    writer.Add(STEADY_PRESSURES_SECTION, 0, steadyPressures);
+    writer.Add(STEADY_FLOWS_SECTION, 0, steadyFlows);
+    writer.Add(BLOWDOWN_STATE_SECTION, 0, m_blowdownState);
+    writer.Add(LAYOUT_LOSSES_SECTION, 0, &m_layout.frictionFactor, 1);
+    writer.Add(LAYOUT_BENDS_SECTION, 0, m_layout.bends);
+    writer.Add(LAYOUT_SPECIES_SECTION, 0, m_layout.species);
+    writer.Add(LAYOUT_FRACTIONS_SECTION, 0, m_layout.componentMassFractions);
+    writer.Add(NODE_FRACTIONS_SECTION, 0, m_network.GetNodeMassFractions(0), m_network.GetNodeCount() * speciesCount);
+    writer.Add(LUMPED_SPECIES_SECTION, 0, m_network.GetLumpedSpeciesMasses(0), m_network.GetPipeCount() * speciesCount);
+    for (int i = 0; i < pipeCount; i++) {
+        const PipeNetwork::Simulation& pipe = m_network.GetPipe(i);
+        writer.Add(PIPE_STATE_SECTION, i, &pipeStates[i], 1);
+        writer.Add(PIPE_DENSITY_SECTION, i, pipe.density);
+        writer.Add(PIPE_MOMENTUM_SECTION, i, pipe.momentum);
+        writer.Add(PIPE_ENERGY_SECTION, i, pipe.energy);
+        writer.Add(PIPE_VELOCITY_SECTION, i, pipe.velocity);
+        writer.Add(PIPE_PRESSURE_SECTION, i, pipe.pressure);
+        writer.Add(PIPE_SPECIES_DENSITY_SECTION, i, pipe.speciesDensity);
+        writer.Add(PIPE_MASS_FRACTIONS_SECTION, i, pipe.massFractions);
+        writer.Add(PIPE_BOUNDARY_SPECIES_SECTION, i, pipeSpecies.data() + 4 * i * speciesCount, 2 * speciesCount);
+        writer.Add(PIPE_GHOST_FRACTIONS_SECTION, i, pipeSpecies.data() + (4 * i + 2) * speciesCount, 2 * speciesCount);
+    }
+    return writer.Write(path, error);
+}
+
+bool NetworkSimulation::LoadCheckpoint(const std::string& path, std::string& error) {
+    CheckpointReader reader;
+    if (!reader.Open(path, error)) {
+        return false;
+    }
+
+    LayoutSettingsState settings;
+    SimulationState state;
+    NetworkLayout layout;
+    bool read = reader.Read(LAYOUT_SETTINGS_SECTION, 0, &settings, 1) &&
+                reader.Read(LAYOUT_COMPONENTS_SECTION, 0, layout.components) &&
+                reader.Read(LAYOUT_PIPES_SECTION, 0, layout.pipes) &&
+                reader.Read(LAYOUT_PORTS_SECTION, 0, layout.ports) &&
+                reader.Read(SIMULATION_STATE_SECTION, 0, &state, 1);
+    if (!read) {
+        error = path + ": not a network checkpoint";
+        return false;
+    }
+    layout.ambientPressure = settings.ambientPressure;
+    layout.ambientDensity = settings.ambientDensity;
+    layout.pipeRegionSize = settings.pipeRegionSize;
+    layout.sleepTolerance = settings.sleepTolerance;
+    layout.fidelity = (PipeFidelity)settings.fidelity;
+    //checkpoints from before the wall losses are of frictionless layouts
+    if (!reader.Read(LAYOUT_LOSSES_SECTION, 0, &layout.frictionFactor, 1) || !reader.Read(LAYOUT_BENDS_SECTION, 0, layout.bends)) {
+        layout.frictionFactor = 0.0f;
+        layout.bends.clear();
+    }
+    //and from before the species of layouts without any
+    if (!reader.Read(LAYOUT_SPECIES_SECTION, 0, layout.species) || !reader.Read(LAYOUT_FRACTIONS_SECTION, 0, layout.componentMassFractions)) {
+        layout.species.clear();
+        layout.componentMassFractions.clear();
+    }
+
+    //the layout builds every array at its size, the state is then copied straight into them
+    Compile(layout);
+    m_network.Prepare();
+    m_time = state.time;
+    mode = (SimulationMode)state.mode;
+    m_network.time = state.networkTime;
+    m_network.timeStep = state.networkTimeStep;
+    m_network.gamma = state.gamma;
+    m_network.CFL = state.CFL;
+    m_blowdown.SetStepSize(state.blowdownStepSize);
+
+    int nodeCount = m_network.GetNodeCount();
+    read = reader.Read(INLET_PRESSURES_SECTION, 0, m_inletPressures.data(), m_inletPressures.size()) &&
+           reader.Read(OUTLET_PRESSURES_SECTION, 0, m_outletPressures.data(), m_outletPressures.size()) &&
+           (nodeCount == 0 || reader.Read(NODES_SECTION, 0, &m_network.GetNode(0), nodeCount));
+    size_t speciesCount = m_network.GetSpeciesCount();
+    if (read && speciesCount > 0) {
+        read = reader.Read(NODE_FRACTIONS_SECTION, 0, m_network.GetNodeMassFractions(0), nodeCount * speciesCount) &&
+               reader.Read(LUMPED_SPECIES_SECTION, 0, m_network.GetLumpedSpeciesMasses(0), m_network.GetPipeCount() * speciesCount);
+    }
+
+    for (int i = 0; read && i < m_network.GetPipeCount(); i++) {
+        PipeNetwork::Simulation& pipe = m_network.GetPipe(i);
+        size_t resolution = pipe.GetResolution();
+        PipeState pipeState;
+        read = reader.Read(PIPE_STATE_SECTION, i, &pipeState, 1) &&
+               reader.Read(PIPE_DENSITY_SECTION, i, pipe.density.data(), resolution) &&
+               reader.Read(PIPE_MOMENTUM_SECTION, i, pipe.momentum.data(), resolution) &&
+               reader.Read(PIPE_ENERGY_SECTION, i, pipe.energy.data(), resolution) &&
+               reader.Read(PIPE_VELOCITY_SECTION, i, pipe.velocity.data(), resolution) &&
+               reader.Read(PIPE_PRESSURE_SECTION, i, pipe.pressure.data(), resolution);
+        pipe.time = pipeState.time;
+        pipe.timeStep = pipeState.timeStep;
+        pipe.maxWaveSpeed = pipeState.maxWaveSpeed;
+        for (int end = 0; end < 2; end++) {
+            pipe.boundaryMass[end] = pipeState.boundaryMass[end];
+            pipe.boundaryMomentum[end] = pipeState.boundaryMomentum[end];
+            pipe.boundaryEnergy[end] = pipeState.boundaryEnergy[end];
+        }
+        pipe.boundary = pipeState.boundary;
+        m_network.SetSleepState(i, pipeState.sleep);
+        m_network.SetFidelityState(i, pipeState.fidelity);
+        if (!read || speciesCount == 0) {
+            continue;
+        }
+
+        read = reader.Read(PIPE_MASS_FRACTIONS_SECTION, i, pipe.massFractions.data(), speciesCount * resolution) &&
+               reader.Read(PIPE_SPECIES_DENSITY_SECTION, i, pipe.speciesDensity.data(), speciesCount * resolution);
+        std::vector<NetworkReal> ends(4 * speciesCount);
+        read = read && reader.Read(PIPE_BOUNDARY_SPECIES_SECTION, i, ends.data(), 2 * speciesCount) &&
+               reader.Read(PIPE_GHOST_FRACTIONS_SECTION, i, ends.data() + 2 * speciesCount, 2 * speciesCount);
+        if (!read) {
+            continue;
+        }
+        for (int end = 0; end < 2; end++) {
+            std::copy_n(ends.data() + end * speciesCount, speciesCount, pipe.boundarySpecies[end].data());
+            std::copy_n(ends.data() + (2 + end) * speciesCount, speciesCount, pipe.ghostFractions[end].data());
+        }
+    }
+
+    size_t steadyNodes = 0, steadyEdges = 0;
+    const double* steadyPressures = reader.Get<double>(STEADY_PRESSURES_SECTION, 0, steadyNodes);
+    const double* steadyFlows = reader.Get<double>(STEADY_FLOWS_SECTION, 0, steadyEdges);
+    read = read && steadyPressures && steadyFlows && (int)steadyNodes == m_steadyNetwork.GetNodeCount() &&
+           (int)steadyEdges == m_steadyNetwork.GetEdgeCount();
+    if (!read) {
+        Compile(layout);
+        error = path + ": the state does not match its layout";
+        return false;
+    }
+    for (int i = 0; i < (int)steadyNodes; i++) {
+        m_steadyNetwork.SetPressure(i, steadyPressures[i]);
+    }
+    for (int i = 0; i < (int)steadyEdges; i++) {
+        m_steadyNetwork.SetMassFlowRate(i, steadyFlows[i]);
+    }
+    if (!reader.Read(BLOWDOWN_STATE_SECTION, 0, m_blowdownState)) {
+        m_blowdownState.clear();
+    }
+
+    //pump rises live on the nodes in the transient network, the steady solver holds its own copy
+    for (int i = 0; i < (int)m_componentTypes.size(); i++) {
+        if (m_componentTypes[i] == PUMP_COMPONENT) {
+            m_steadyNetwork.SetPumpRise(m_componentSteadyEdges[i], m_network.GetNode(m_componentNodes[i]).pressureRise);
+        }
+    }
+    return true;
+}
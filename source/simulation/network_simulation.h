@@ -0,0 +1,248 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef NETWORK_SIMULATION_H
+#define NETWORK_SIMULATION_H
+
+#include <string>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "combustion_table.h"
+#include "dormand_prince.h"
+#include "pipe_network.h"
+#include "steady_network.h"
+
+#endif //NETWORK_SIMULATION_H
+
+class TelemetryWriter;
+
+enum SimulationMode {
+    TRANSIENT,      //the pipe network is integrated in time
+    STEADY_STATE,   //the operating point the network settles at is solved for directly
+    QUASI_STEADY    //the network stays at its operating point while the tanks drain or fill along it
+};
+
+enum NetworkComponentType {
+    TANK_COMPONENT,
+    PUMP_COMPONENT,
+    ENGINE_COMPONENT
+};
+
+//plain description of a feed system, what both the editor's scene and a scenario file are turned into.
+//pressures are gauge pressures, relative to the ambient pressure, like on the models
+struct ComponentLayout {
+    NetworkComponentType type = TANK_COMPONENT;
+    float volume = 1.0f;            //tank, engine chamber
+    float storedAmount = 0.0f;      //tank, 0 fills it at ambient density
+    float inletPressure = 0.0f;     //pump inlet, engine chamber (where a burning chamber starts)
+    float outletPressure = 0.0f;    //tank outlet, pump outlet
+    float maxMassFlowRate = 2.0f;   //pump, where its rise has fallen to zero
+
+    //engine, the oxidizer to fuel mass ratio it burns at and its nozzle throat. 0 holds the chamber at its set
+    //pressure, see NetworkSimulation::SetCombustionTable
+    float mixtureRatio = 2.6f;
+    float throatArea = 0.0f;
+};
+
+struct PipeLayout {
+    float length = 1.0f;
+    float radius = 0.1f;
+
+    //where the ends are. free ends that meet become a junction, the rest are closed (a nan never meets anything)
+    glm::vec3 start = glm::vec3(0.0f);
+    glm::vec3 end = glm::vec3(0.0f);
+
+    //initial gas state, a density of 0 starts the pipe at ambient conditions
+    float density = 0.0f;
+    float pressure = 0.0f;
+    float velocity = 0.0f;
+};
+
+//a corner of a pipe's path. it loses the dynamic pressure of the flow times a loss coefficient that grows with
+//the angle and falls as the corner is rounded more generously relative to the pipe's diameter
+struct PipeBend {
+    int pipe = 0;
+    float position = 0.0f;      //along the pipe, from its start
+    float angle = 0.0f;         //the direction turns through, in radians
+    float radius = 0.0f;        //of the centre line, 0 for a sharp mitre
+};
+
+//the bends of a pipe path with a corner at every inner point, each rounded by a bevel of its radius
+//(Control::bevelRadius, 0 for a sharp corner). appended to bends
+void AddPathBends(int pipe, const std::vector<glm::vec3>& path, const std::vector<float>& bevelRadii, std::vector<PipeBend>& bends);
+
+//index of the connection point a pipe end at point (world space) sits on, the points are relative to the
+//component's position like Model::connectionPoints. -1 when it is on none of them
+int FindConnectionPoint(const std::vector<glm::vec3>& connectionPoints, glm::vec3 componentPosition, glm::vec3 point, float tolerance = 1e-3f);
+
+//a pipe end on a component. every pipe end is in at most one port, and on a pump the outlet side is marked
+struct PortLayout {
+    int component = 0;
+    int pipe = 0;
+    PipeEnd end = PIPE_START;
+    bool outlet = false;
+};
+
+struct NetworkLayout {
+    float ambientPressure = 1.0f;
+    float ambientDensity = 1.0f;
+    float pipeRegionSize = 0.05f;   //region length the pipes are resolved with
+    float sleepTolerance = 0.0f;    //residual below which pipes at rest stop being stepped (PipeNetwork), 0 never
+    PipeFidelity fidelity = RESOLVED_FIDELITY;     //of every pipe when compiled
+
+    //darcy friction factor of the pipe walls, 0 leaves the pipes frictionless. with friction the bends take
+    //their losses too, in the transient pipes (whatever their fidelity) and the steady solution, and the walls
+    //of the transient pipes exchange heat with the gas at the ambient temperature
+    float frictionFactor = 0.0f;
+
+    std::vector<ComponentLayout> components;
+    std::vector<PipeLayout> pipes;
+    std::vector<PortLayout> ports;
+    std::vector<PipeBend> bends;
+
+    //passive species the pipes carry and the nodes mix (PipeNetwork::SetSpecies), none carries no composition.
+    //the mass fractions of every component's gas, one per species (component * species + k) and taken over
+    //their sum. the pipes and the junctions start out as the first species, and so does every component when
+    //this is empty or its fractions are all 0
+    std::vector<Gas> species;
+    std::vector<float> componentMassFractions;
+};
+
+//what is shown of a running network: the tanks and engines in the order of the layout's components, the
+//ports in layout order and the pipes. the steady modes carry no composition, the engines keep the one the
+//transient network last gave them
+struct SimulationSnapshot {
+    unsigned long long version = 0;
+    float time = 0.0f;
+    std::vector<float> tankStoredAmounts;
+    std::vector<float> engineMassFlowRates;
+    std::vector<float> engineThrusts;
+    std::vector<float> engineMassFractions;     //of what reaches each engine, one per species (engine * species + k)
+    std::vector<float> controlPointPressures;
+    std::vector<float> pipePressures;
+    std::vector<float> pipeMassFlowRates;
+    int activePipeCount = 0;        //resolved pipes the last sub step advanced, the rest were asleep or lumped
+    int lumpedPipeCount = 0;
+};
+
+//a layout compiled into a pipe network (one gas simulation per pipe, one node per tank, pump, engine and pipe to
+//pipe junction) and the same graph for the steady state solver (with pipe i as its edge i), plus flat index
+//arrays for what is reported, so a step never walks the layout
+class NetworkSimulation {
+    NetworkLayout m_layout;                 //what was compiled, a checkpoint carries it to recompile from
+    float m_ambientPressure = 1.0f;
+    double m_time = 0.0;
+
+    PipeNetwork m_network;
+    SteadyNetworkSolver m_steadyNetwork;
+    std::vector<int> m_steadyEnds;          //steady solver node of every pipe end, indexed 2 * pipe + end
+    std::vector<int> m_endNodes;            //network node of every pipe end the same way, -1 for a closed end
+
+    //per component, its network node, its steady solver node (a pump's inlet side), a pump's steady edge and
+    //the set points it was last given
+    std::vector<NetworkComponentType> m_componentTypes;
+    std::vector<int> m_componentNodes;
+    std::vector<int> m_componentSteadyNodes;
+    std::vector<int> m_componentSteadyEdges;
+    std::vector<float> m_inletPressures;
+    std::vector<float> m_outletPressures;
+
+    std::vector<int> m_tanks;               //component indices
+    std::vector<int> m_engines;
+    std::vector<PortLayout> m_ports;
+
+    //per engine, what its chamber burns and how it empties
+    std::vector<float> m_mixtureRatios;
+    std::vector<float> m_throatAreas;
+    std::vector<float> m_chamberVolumes;
+    const CombustionTable* m_combustionTable = nullptr;
+    float m_pressureUnit = 1.0f;            //Pa per unit of the network's pressures
+    float m_velocityUnit = 1.0f;            //m/s per unit of its velocities
+
+    //quasi steady: the mass and internal energy of every tank, in the order of m_tanks
+    DormandPrinceIntegrator m_blowdown;
+    std::vector<double> m_blowdownState;
+
+    TelemetryWriter* m_telemetry = nullptr;
+
+    void ApplySetPoints(int component);
+    void AdvanceBlowdown(double time);
+    void StepCombustion(float timeStep);
+    float ComputeThrust(int engine, float chamberPressure) const;
+    void RecordTelemetry(double time);
+
+public:
+    unsigned long long version = 0;
+    SimulationMode mode = TRANSIENT;
+
+    void Compile(const NetworkLayout& layout);
+    void SetThreadPool(ThreadPool* threadPool) { m_network.SetThreadPool(threadPool); }
+
+    //engines with a throat burn what reaches them: after every transient sub step each chamber fills with
+    //the mass flowing in and empties through its choked throat at chamber pressure * throat area / c*, at
+    //the temperature and c* the table gives for its mixture ratio and pressure. the chamber does not fall
+    //below the ambient pressure, and the steady modes hold it at its set pressure. the network's ambient
+    //state is taken as sea level air to convert to and from the table's units. without a table every
+    //chamber is held at its set pressure. the table has to outlive the simulation
+    void SetCombustionTable(const CombustionTable* table) { m_combustionTable = table; }
+
+    int GetPipeCount() const { return m_network.GetPipeCount(); }
+    double GetTime() const { return m_time; }
+    const NetworkLayout& GetLayout() const { return m_layout; }
+    const PipeNetwork& GetNetwork() const { return m_network; }
+    const SteadyNetworkSolver& GetSteadyNetwork() const { return m_steadyNetwork; }
+
+    //carries the state of a running simulation over to this one, freshly compiled from an edited layout, so an
+    //edit does not start the network over from ambient. the sources give the index in the previous layout of
+    //every pipe and component of this one, -1 for a new one, which keeps the state it was compiled with.
+    //a carried pipe takes the gas along the previous pipe, copied as it is when its region count is the same
+    //and sampled at the same relative positions otherwise, and keeps the fidelity it was switched to (a lumped
+    //pipe keeps the flows of its halves, and its gas the density it had). a carried component's node takes the
+    //previous node's gas and composition, set points that moved are applied over them. a junction takes the
+    //gas of the node a carried pipe end was on. the time carries on, the steady solver starts cold
+    void CarryState(const NetworkSimulation& previous, const std::vector<int>& pipeSources, const std::vector<int>& componentSources);
+
+    //moves the set points of a component while it runs, with the meaning they have in ComponentLayout
+    void SetInletPressure(int component, float pressure);
+    void SetOutletPressure(int component, float pressure);
+
+    //switches how a pipe is modelled while it runs, -1 for every pipe (PipeNetwork::SetFidelity)
+    void SetPipeFidelity(int pipe, PipeFidelity fidelity);
+
+    //transient: integrates over the time in CFL limited sub steps. steady state: solves for the operating
+    //point at the tanks' current state, warm started from the last one. quasi steady: integrates the tanks over
+    //the time, as ideal gas volumes exchanging the steady flows of their pressures, with error controlled steps
+    //that grow as long as the flows change slowly (a blowdown takes tens of steps instead of millions of CFL
+    //steps). the tanks expand adiabatically, what flows in arrives at the temperature the steady network
+    //carries to them. the steady network loses what the transient pipes do (SteadyNetworkSolver)
+    void Advance(double time, int maxSubSteps);
+
+    const IntegrationStatistics& GetBlowdownStatistics() const { return m_blowdown.statistics; }
+
+    //the buffers keep their capacity, so this only allocates when the layout grew
+    void WriteSnapshot(SimulationSnapshot& snapshot) const;
+
+    //records a frame after every transient sub step (steady state and quasi steady advances are not network
+    //steps and record nothing):
+    //the pressure, density, velocity and mass flow rate in the middle of every pipe (the mean of a lumped one), then the pressure and net
+    //mass inflow of every component's node, the stored amount of every tank and the thrust of every engine.
+    //with species every pipe and component adds a mass fraction per species after its other channels (an
+    //engine's of what reaches it). the channels are named "<pipe>.pressure", "<pipe>.<species>" and so on, by
+    //index when no names are given
+    std::vector<std::string> GetTelemetryChannels(const std::vector<std::string>& componentNames = {}, const std::vector<std::string>& pipeNames = {},
+                                                  const std::vector<std::string>& speciesNames = {}) const;
+    void SetTelemetry(TelemetryWriter* telemetry) { m_telemetry = telemetry; }
+
+    //the whole state in a checkpoint file (checkpoint.h): the layout, every pipe's regions, boundary fluxes and
+    //ghost states and species, the nodes and their composition, the steady solver's last solution, the tanks' quasi steady state and step size,
+    //the set points, the mode and the time. loading recompiles the stored layout and copies the state back
+    //over it, so a run continued from a checkpoint takes bit for bit the steps the saved run would have taken
+    //with the same build. a checkpoint can be loaded any number of times, to fork several runs from one warm
+    //state
+    bool SaveCheckpoint(const std::string& path, std::string& error) const;
+    bool LoadCheckpoint(const std::string& path, std::string& error);
+};
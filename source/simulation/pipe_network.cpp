@@ -0,0 +1,823 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "pipe_network.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../core/thread_pool.h"
+
+template<typename Real, typename Flux>
+int BasicPipeNetwork<Real, Flux>::AddPipe(Real length, Real area, int resolution, Real density, Real pressure) {
+    auto pipe = std::make_unique<Simulation>(resolution);
+    pipe->gamma = gamma;
+    pipe->sizes.assign(resolution, length / Real(resolution - 2));
+    for (int i = 0; i < resolution; i++) {
+        pipe->SetState(i, density, Real(0), pressure);
+    }
+    if (!m_species.empty()) {
+        pipe->SetSpecies(m_species);
+        pipe->ghostFractions[0].assign(m_species.size(), Real(0));
+        pipe->ghostFractions[1].assign(m_species.size(), Real(0));
+        m_lumpedSpeciesMasses.resize(m_lumpedSpeciesMasses.size() + m_species.size(), Real(0));
+    }
+
+    m_pipes.push_back(std::move(pipe));
+    m_areas.push_back(area);
+    Real interiorLength = Real(0);
+    for (int i = 1; i < resolution - 1; i++) {
+        interiorLength += m_pipes.back()->sizes[i];
+    }
+    m_lengths.push_back(interiorLength);
+    m_halfLosses.push_back(Real(0));
+    m_halfLosses.push_back(Real(0));
+    m_sleepStates.emplace_back();
+    m_fidelityStates.emplace_back();
+    m_compiled = false;
+    return (int)m_pipes.size() - 1;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::SetWallLosses(int pipeIndex, Real frictionFactor, const Real* fittingLosses, Real wallTemperature) {
+    Simulation& pipe = *m_pipes[pipeIndex];
+    int resolution = pipe.GetResolution();
+    if (frictionFactor == Real(0) && fittingLosses == nullptr && wallTemperature == Real(0)) {
+        pipe.areaGradient.clear();
+        pipe.lossCoefficient.clear();
+        pipe.heatTransferCoefficient.clear();
+        pipe.wallTemperature = Real(0);
+        m_halfLosses[2 * pipeIndex] = m_halfLosses[2 * pipeIndex + 1] = Real(0);
+        return;
+    }
+
+    std::vector<Real> areas(resolution, m_areas[pipeIndex]);
+    std::vector<Real> diameters(resolution, Real(2) * std::sqrt(m_areas[pipeIndex] / Real(M_PI)));
+    pipe.SetPipeGeometry(areas.data(), diameters.data(), frictionFactor, fittingLosses);
+    pipe.wallTemperature = wallTemperature;
+
+    //the halves split the interior like Lump does
+    int interior = resolution - 2;
+    Real halfLengths[2] = {};
+    Real halfLosses[2] = {};
+    for (int i = 1; i <= interior; i++) {
+        int half = 2 * (i - 1) < interior ? 0 : 1;
+        halfLengths[half] += pipe.sizes[i];
+        halfLosses[half] += pipe.lossCoefficient[i] * pipe.sizes[i];
+    }
+    for (int end = 0; end < 2; end++) {
+        m_halfLosses[2 * pipeIndex + end] = halfLosses[end] / halfLengths[end];
+    }
+}
+
+template<typename Real, typename Flux>
+int BasicPipeNetwork<Real, Flux>::AddNode(Real volume, Real density, Real pressure, Real pressureRise) {
+    NetworkNode<Real> node;
+    node.volume = volume;
+    node.density = density;
+    node.pressure = pressure;
+    node.pressureRise = pressureRise;
+    node.designDensity = density;
+    m_automaticVolumes.push_back(volume <= Real(0));
+    if (volume <= Real(0)) {
+        node.volume = Real(0);
+    }
+    m_nodes.push_back(node);
+    for (size_t k = 0; k < m_species.size(); k++) {
+        m_nodeMassFractions.push_back(k == 0 ? Real(1) : Real(0));
+    }
+    m_compiled = false;
+    return (int)m_nodes.size() - 1;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::Connect(int pipe, PipeEnd end, int node, bool outlet) {
+    NetworkPort port;
+    port.pipe = pipe;
+    port.end = end;
+    port.node = node;
+    port.outlet = outlet;
+    m_ports.push_back(port);
+
+    if (m_automaticVolumes[node]) {
+        const Simulation& simulation = *m_pipes[pipe];
+        m_nodes[node].volume += m_areas[pipe] * simulation.sizes[end == PIPE_START ? 1 : simulation.GetResolution() - 2];
+    }
+    m_compiled = false;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::SetSpecies(const std::vector<Gas>& species) {
+    m_species = species;
+    size_t count = species.size();
+    m_nodeMassFractions.assign(m_nodes.size() * count, Real(0));
+    m_lumpedSpeciesMasses.assign(m_pipes.size() * count, Real(0));
+    if (count == 0) {
+        for (auto& pipe : m_pipes) {
+            pipe->SetSpecies(species);
+            pipe->ghostFractions[0].clear();
+            pipe->ghostFractions[1].clear();
+        }
+        return;
+    }
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        m_nodeMassFractions[i * count] = Real(1);
+    }
+    for (size_t i = 0; i < m_pipes.size(); i++) {
+        m_pipes[i]->SetSpecies(species);
+        m_pipes[i]->ghostFractions[0].assign(count, Real(0));
+        m_pipes[i]->ghostFractions[1].assign(count, Real(0));
+        m_lumpedSpeciesMasses[i * count] = m_fidelityStates[i].mass;
+    }
+    m_compiled = false;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::Compile() {
+    //group the ports by node, so each node owns a contiguous run of them and nodes can be balanced in parallel
+    std::stable_sort(m_ports.begin(), m_ports.end(), [](const NetworkPort& a, const NetworkPort& b) { return a.node < b.node; });
+    for (NetworkNode<Real>& node : m_nodes) {
+        node.portCount = 0;
+    }
+    for (int i = (int)m_ports.size() - 1; i >= 0; i--) {
+        NetworkNode<Real>& node = m_nodes[m_ports[i].node];
+        node.firstPort = i;
+        node.portCount++;
+    }
+
+    for (auto& pipe : m_pipes) {
+        pipe->boundary.closed[PIPE_START] = true;
+        pipe->boundary.closed[PIPE_END] = true;
+    }
+    for (const NetworkPort& port : m_ports) {
+        m_pipes[port.pipe]->boundary.closed[port.end] = false;
+    }
+
+    //largest pipes first, the pool hands tasks out in order so the long ones do not end up last
+    m_pipeOrder.resize(m_pipes.size());
+    for (int i = 0; i < (int)m_pipes.size(); i++) {
+        m_pipeOrder[i] = i;
+    }
+    std::stable_sort(m_pipeOrder.begin(), m_pipeOrder.end(), [&](int a, int b) { return m_pipes[a]->GetResolution() > m_pipes[b]->GetResolution(); });
+    m_pipeTimeSteps.resize(m_pipes.size());
+
+    //everything starts awake, with the residual checks spread over the interval
+    m_wakeRequests.assign(2 * m_pipes.size(), 0);
+    for (int i = 0; i < (int)m_pipes.size(); i++) {
+        m_sleepStates[i] = PipeSleepState<Real>();
+        m_sleepStates[i].stepsUntilCheck = 1 + i % std::max(sleepCheckInterval, 1);
+    }
+    m_activePipes = m_pipeOrder;
+    m_sleepingPipes.clear();
+    for (int i = 0; i < (int)m_pipes.size(); i++) {
+        m_fidelityStates[i].stepsUntilCheck = 1 + i % std::max(fidelityCheckInterval, 1);
+    }
+
+    m_nodePortAreas.assign(m_nodes.size(), Real(0));
+    m_endNodes.assign(2 * m_pipes.size(), -1);
+    m_endOutlets.assign(2 * m_pipes.size(), 0);
+    for (const NetworkPort& port : m_ports) {
+        m_nodePortAreas[port.node] += m_areas[port.pipe];
+        m_endNodes[2 * port.pipe + port.end] = port.node;
+        m_endOutlets[2 * port.pipe + port.end] = port.outlet ? 1 : 0;
+    }
+
+    for (int i = 0; i < (int)m_nodes.size(); i++) {
+        UpdateGhostStates(i);
+    }
+    for (int i = 0; i < 2 * (int)m_pipes.size(); i++) {
+        if (m_endNodes[i] != -1) {
+            Real density;
+            GetEndState(i / 2, (PipeEnd)(i % 2), density, m_fidelityStates[i / 2].ghostPressure[i % 2]);
+        }
+    }
+    m_compiled = true;
+}
+
+template<typename Real, typename Flux>
+template<typename Task>
+void BasicPipeNetwork<Real, Flux>::ForEach(int count, const Task& task) {
+    if (m_threadPool == nullptr) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+    m_threadPool->ParallelFor(count, task);
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::BalanceNode(int nodeIndex, Real dt) {
+    NetworkNode<Real>& node = m_nodes[nodeIndex];
+    Real specificEnthalpy = gamma / (gamma - Real(1)) * node.pressure / node.density;
+
+    //what left the pipes through their end interfaces entered the node and the other way around
+    Real mass = Real(0);
+    Real energy = Real(0);
+    for (int i = node.firstPort; i < node.firstPort + node.portCount; i++) {
+        const NetworkPort& port = m_ports[i];
+        const Simulation& pipe = *m_pipes[port.pipe];
+        Real area = m_areas[port.pipe];
+        Real sign = port.end == PIPE_START ? Real(-1) : Real(1);
+        Real portMass = sign * area * pipe.boundaryMass[port.end];
+        mass += portMass;
+
+        //gas a pump pushes out leaves with the node enthalpy, the pump supplies the rest
+        energy += port.outlet ? portMass * specificEnthalpy : sign * area * pipe.boundaryEnergy[port.end];
+    }
+    node.massFlowRate = mass / dt;
+
+    if (std::isinf(node.volume)) {
+        return;
+    }
+
+    //the species mass the ports exchanged mixes with the node's, in place of its fractions. the pipes' species
+    //fluxes add up to their mass fluxes, so the fractions only drift by round-off (or an implicit pipe's
+    //linearisation) and are taken back to a sum of one
+    int speciesCount = GetSpeciesCount();
+    if (speciesCount > 0) {
+        Real* fractions = GetNodeMassFractions(nodeIndex);
+        Real nodeMass = node.density * node.volume;
+        for (int k = 0; k < speciesCount; k++) {
+            fractions[k] *= nodeMass;
+        }
+        for (int i = node.firstPort; i < node.firstPort + node.portCount; i++) {
+            const NetworkPort& port = m_ports[i];
+            const Simulation& pipe = *m_pipes[port.pipe];
+            Real sign = port.end == PIPE_START ? Real(-1) : Real(1);
+            for (int k = 0; k < speciesCount; k++) {
+                fractions[k] += sign * m_areas[port.pipe] * pipe.boundarySpecies[port.end][k];
+            }
+        }
+        Real total = Real(0);
+        for (int k = 0; k < speciesCount; k++) {
+            fractions[k] = std::max(fractions[k], Real(0));
+            total += fractions[k];
+        }
+        for (int k = 0; k < speciesCount; k++) {
+            fractions[k] = total > Real(0) ? fractions[k] / total : (k == 0 ? Real(1) : Real(0));
+        }
+    }
+
+    Real internalEnergy = node.pressure / (gamma - Real(1)) * node.volume;
+    node.density = (node.density * node.volume + mass) / node.volume;
+    node.pressure = (gamma - Real(1)) * (internalEnergy + energy) / node.volume;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::GetNodeInflowFractions(int nodeIndex, Real* fractions) const {
+    const NetworkNode<Real>& node = m_nodes[nodeIndex];
+    int speciesCount = GetSpeciesCount();
+    std::fill(fractions, fractions + speciesCount, Real(0));
+    Real total = Real(0);
+    for (int i = node.firstPort; i < node.firstPort + node.portCount; i++) {
+        const NetworkPort& port = m_ports[i];
+        const Simulation& pipe = *m_pipes[port.pipe];
+        Real sign = port.end == PIPE_START ? Real(-1) : Real(1);
+        if (sign * pipe.boundaryMass[port.end] <= Real(0)) {
+            continue;
+        }
+        for (int k = 0; k < speciesCount; k++) {
+            Real mass = std::max(sign * m_areas[port.pipe] * pipe.boundarySpecies[port.end][k], Real(0));
+            fractions[k] += mass;
+            total += mass;
+        }
+    }
+    const Real* own = GetNodeMassFractions(nodeIndex);
+    for (int k = 0; k < speciesCount; k++) {
+        fractions[k] = total > Real(0) ? fractions[k] / total : own[k];
+    }
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::GetEndState(int pipe, PipeEnd end, Real& density, Real& pressure) const {
+    const NetworkNode<Real>& node = m_nodes[m_endNodes[2 * pipe + end]];
+    density = node.density;
+    pressure = node.pressure;
+
+    //pump outlets see the raised pressure, compressed isentropically
+    if (m_endOutlets[2 * pipe + end] && node.pressureRise != Real(0)) {
+        pressure += node.pressureRise * node.density / node.designDensity;
+        density *= std::pow(pressure / node.pressure, Real(1) / gamma);
+    }
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::UpdateGhostState(int pipeIndex, PipeEnd end) {
+    Simulation& pipe = *m_pipes[pipeIndex];
+    Real totalDensity, totalPressure;
+    GetEndState(pipeIndex, end, totalDensity, totalPressure);
+
+    //the velocity at the end of the pipe, of the region next to the ghost or of the half of a lumped pipe
+    int neighbour = end == PIPE_START ? 1 : pipe.GetResolution() - 2;
+    Real density = pipe.density[neighbour];
+    Real velocity = pipe.velocity[neighbour];
+    if (m_fidelityStates[pipeIndex].lumped) {
+        Real pressure;
+        GetLumpedState(pipeIndex, density, velocity, pressure);
+        velocity = m_fidelityStates[pipeIndex].massFlowRate[end] / (density * m_areas[pipeIndex]);
+    }
+
+    //the ghost carries that velocity on. gas leaving the pipe meets the node's static pressure, gas entering it
+    //has accelerated out of the node at rest, isentropically from the node's state (its total state) and no
+    //faster than sound
+    Real pressure = totalPressure;
+    bool entering = end == PIPE_START ? velocity >= Real(0) : velocity <= Real(0);
+    if (entering) {
+        Real totalTemperature = totalPressure / totalDensity;
+        Real sonicVelocity = std::sqrt(Real(2) * gamma / (gamma + Real(1)) * totalTemperature);
+        velocity = std::max(std::min(velocity, sonicVelocity), -sonicVelocity);
+        Real temperature = totalTemperature - (gamma - Real(1)) / (Real(2) * gamma) * velocity * velocity;
+        pressure = totalPressure * std::pow(temperature / totalTemperature, gamma / (gamma - Real(1)));
+        density = pressure / temperature;
+    }
+
+    pipe.boundary.density[end] = density;
+    pipe.boundary.momentum[end] = density * velocity;
+    pipe.boundary.energy[end] = pressure / (gamma - Real(1)) + Real(0.5) * density * velocity * velocity;
+
+    //the ghost region itself too, the pipe only applies its boundary after a stage
+    pipe.SetState(end == PIPE_START ? 0 : pipe.GetResolution() - 1, density, velocity, pressure);
+
+    //the node's composition, which only enters the pipe with an inflow, the species flux is upwind
+    if (!m_species.empty()) {
+        const Real* fractions = GetNodeMassFractions(m_endNodes[2 * pipeIndex + end]);
+        std::copy(fractions, fractions + m_species.size(), pipe.ghostFractions[end].begin());
+        pipe.SetMassFractions(end == PIPE_START ? 0 : pipe.GetResolution() - 1, fractions);
+    }
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::UpdateGhostStates(int nodeIndex) {
+    const NetworkNode<Real>& node = m_nodes[nodeIndex];
+    for (int i = node.firstPort; i < node.firstPort + node.portCount; i++) {
+        const NetworkPort& port = m_ports[i];
+        UpdateGhostState(port.pipe, port.end);
+
+        const PipeSleepState<Real>& sleep = m_sleepStates[port.pipe];
+        if (sleep.asleep) {
+            const ExternalBoundary& boundary = m_pipes[port.pipe]->boundary;
+            Real density = (Real)boundary.density[port.end];
+            Real energy = (Real)boundary.energy[port.end];
+            bool moved = std::abs(density - sleep.ghostDensity[port.end]) > wakeTolerance * sleep.ghostDensity[port.end] ||
+                         std::abs(energy - sleep.ghostEnergy[port.end]) > wakeTolerance * sleep.ghostEnergy[port.end];
+            m_wakeRequests[2 * port.pipe + port.end] = moved ? 1 : 0;
+        }
+    }
+}
+
+template<typename Real, typename Flux>
+Real BasicPipeNetwork<Real, Flux>::ComputeResidual(int pipeIndex, Real dt) const {
+    //the update of region i is dt / size * (F[i - 1] - F[i]) with the fluxes the step left behind, the momentum
+    //is measured against sqrt(density * energy), the momentum of gas moving at about the speed of sound
+    const Simulation& pipe = *m_pipes[pipeIndex];
+    Real residual = Real(0);
+    for (int i = 1; i < pipe.GetResolution() - 1; i++) {
+        Real scale = dt / pipe.sizes[i];
+        Real mass = std::abs(pipe.massFlux[i - 1] - pipe.massFlux[i]) * scale / pipe.density[i];
+        Real momentum = std::abs(pipe.momentumFlux[i - 1] - pipe.momentumFlux[i]) * scale / std::sqrt(pipe.density[i] * pipe.energy[i]);
+        Real energy = std::abs(pipe.energyFlux[i - 1] - pipe.energyFlux[i]) * scale / pipe.energy[i];
+        residual = std::max(residual, std::max(mass, std::max(momentum, energy)));
+    }
+    return residual;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::SetFidelity(int pipe, PipeFidelity fidelity) {
+    PipeFidelityState<Real>& state = m_fidelityStates[pipe];
+    state.fidelity = fidelity;
+    if (fidelity == RESOLVED_FIDELITY && state.lumped) {
+        Resolve(pipe);
+    }
+    else if (fidelity != RESOLVED_FIDELITY && !state.lumped) {
+        Lump(pipe);
+    }
+}
+
+template<typename Real, typename Flux>
+int BasicPipeNetwork<Real, Flux>::GetLumpedPipeCount() const {
+    int count = 0;
+    for (const PipeFidelityState<Real>& state : m_fidelityStates) {
+        count += state.lumped ? 1 : 0;
+    }
+    return count;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::GetLumpedState(int pipe, Real& density, Real& velocity, Real& pressure) const {
+    const PipeFidelityState<Real>& state = m_fidelityStates[pipe];
+    Real volume = m_areas[pipe] * m_lengths[pipe];
+    density = state.mass / volume;
+    velocity = Real(0.5) * (state.massFlowRate[0] + state.massFlowRate[1]) / (density * m_areas[pipe]);
+    pressure = (gamma - Real(1)) * (state.energy - Real(0.5) * state.mass * velocity * velocity) / volume;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::Lump(int pipeIndex) {
+    //the flow of each half is its mean momentum
+    const Simulation& pipe = *m_pipes[pipeIndex];
+    PipeFidelityState<Real>& state = m_fidelityStates[pipeIndex];
+    Real area = m_areas[pipeIndex];
+    int interior = pipe.GetResolution() - 2;
+    Real halfLengths[2] = {};
+    Real halfMomenta[2] = {};
+    state.mass = Real(0);
+    state.energy = Real(0);
+    for (int i = 1; i <= interior; i++) {
+        int half = 2 * (i - 1) < interior ? 0 : 1;
+        state.mass += area * pipe.density[i] * pipe.sizes[i];
+        state.energy += area * pipe.energy[i] * pipe.sizes[i];
+        halfLengths[half] += pipe.sizes[i];
+        halfMomenta[half] += pipe.momentum[i] * pipe.sizes[i];
+    }
+    Real* speciesMasses = GetLumpedSpeciesMasses(pipeIndex);
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        speciesMasses[k] = Real(0);
+        for (int i = 1; i <= interior; i++) {
+            speciesMasses[k] += area * pipe.speciesDensity[(size_t)k * pipe.GetResolution() + i] * pipe.sizes[i];
+        }
+    }
+    for (int end = 0; end < 2; end++) {
+        state.massFlowRate[end] = area * halfMomenta[end] / halfLengths[end];
+        //before the network is compiled there are no ends yet, Compile sets them
+        if (m_compiled && m_endNodes[2 * pipeIndex + end] != -1) {
+            Real endDensity;
+            GetEndState(pipeIndex, (PipeEnd)end, endDensity, state.ghostPressure[end]);
+        }
+    }
+    state.lumped = true;
+    state.stepsUntilCheck = std::max(fidelityCheckInterval, 1);
+    m_sleepStates[pipeIndex] = PipeSleepState<Real>();
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::Resolve(int pipeIndex) {
+    //uniform density, the momentum linear from the start flow to the end flow and a uniform internal energy
+    //that leaves the total energy what it was
+    Simulation& pipe = *m_pipes[pipeIndex];
+    PipeFidelityState<Real>& state = m_fidelityStates[pipeIndex];
+    Real area = m_areas[pipeIndex];
+    Real length = m_lengths[pipeIndex];
+    Real density = state.mass / (area * length);
+    int interior = pipe.GetResolution() - 2;
+
+    Real kineticEnergy = Real(0);
+    Real position = Real(0);
+    for (int i = 1; i <= interior; i++) {
+        Real weight = (position + Real(0.5) * pipe.sizes[i]) / length;
+        pipe.momentum[i] = ((Real(1) - weight) * state.massFlowRate[0] + weight * state.massFlowRate[1]) / area;
+        kineticEnergy += Real(0.5) * pipe.momentum[i] * pipe.momentum[i] / density * pipe.sizes[i];
+        position += pipe.sizes[i];
+    }
+    Real internalEnergy = state.energy / area - kineticEnergy;
+    bool still = internalEnergy <= Real(0);
+    if (still) {
+        internalEnergy = state.energy / area;
+    }
+    Real pressure = (gamma - Real(1)) * internalEnergy / length;
+    for (int i = 1; i <= interior; i++) {
+        pipe.SetState(i, density, still ? Real(0) : pipe.momentum[i] / density, pressure);
+    }
+
+    //a uniform composition too, the species masses are left as fractions until the pipe is lumped again
+    if (!m_species.empty()) {
+        Real* fractions = GetLumpedSpeciesMasses(pipeIndex);
+        Real total = Real(0);
+        for (int k = 0; k < GetSpeciesCount(); k++) {
+            total += fractions[k];
+        }
+        for (int k = 0; k < GetSpeciesCount(); k++) {
+            fractions[k] = total > Real(0) ? fractions[k] / total : (k == 0 ? Real(1) : Real(0));
+        }
+        for (int i = 1; i <= interior; i++) {
+            pipe.SetMassFractions(i, fractions);
+        }
+    }
+
+    state.lumped = false;
+    state.stepsUntilCheck = std::max(fidelityCheckInterval, 1);
+    m_sleepStates[pipeIndex] = PipeSleepState<Real>();
+    m_sleepStates[pipeIndex].stepsUntilCheck = std::max(sleepCheckInterval, 1);
+}
+
+template<typename Real, typename Flux>
+Real BasicPipeNetwork<Real, Flux>::ComputeLumpedTimeStep(int pipeIndex) const {
+    //a wave crossing half the pipe, the oscillation of each half's inertance against the volume of the node at
+    //its end (shared with every other pipe on it), and the flow through the node replacing its gas
+    Real density, velocity, pressure;
+    GetLumpedState(pipeIndex, density, velocity, pressure);
+    Real soundSpeed = std::sqrt(gamma * std::max(pressure, Real(0)) / density);
+    Real halfLength = Real(0.5) * m_lengths[pipeIndex];
+    Real timeStep = halfLength / (soundSpeed + std::abs(velocity));
+    for (int end = 0; end < 2; end++) {
+        int nodeIndex = m_endNodes[2 * pipeIndex + end];
+        if (nodeIndex != -1 && !std::isinf(m_nodes[nodeIndex].volume)) {
+            const NetworkNode<Real>& node = m_nodes[nodeIndex];
+            Real nodeSoundSpeed = std::sqrt(gamma * node.pressure / node.density);
+            Real flowSpeed = std::abs(m_fidelityStates[pipeIndex].massFlowRate[end]) / (m_areas[pipeIndex] * std::min(node.density, density));
+            Real length = node.volume / m_nodePortAreas[nodeIndex];
+            timeStep = std::min(timeStep, std::sqrt(halfLength * length) / nodeSoundSpeed);
+            timeStep = std::min(timeStep, length / flowSpeed);
+        }
+    }
+    return CFL * timeStep;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::StepLumped(int pipeIndex, Real dt) {
+    Simulation& pipe = *m_pipes[pipeIndex];
+    PipeFidelityState<Real>& state = m_fidelityStates[pipeIndex];
+    const ExternalBoundary& boundary = pipe.boundary;
+    Real area = m_areas[pipeIndex];
+    Real halfLength = Real(0.5) * m_lengths[pipeIndex];
+    Real density, velocity, pressure;
+    GetLumpedState(pipeIndex, density, velocity, pressure);
+
+    //the flows first, then the volume with the new flows (symplectic euler, stable up to the lumped time step)
+    Real ghostDensity[2] = {}, ghostPressure[2] = {};
+    for (int end = 0; end < 2; end++) {
+        Real& flow = state.massFlowRate[end];
+        if (boundary.closed[end]) {
+            flow = Real(0);
+            continue;
+        }
+        GetEndState(pipeIndex, (PipeEnd)end, ghostDensity[end], ghostPressure[end]);
+
+        //positive flow enters at the start and leaves at the end. gas entering from the node reaches the pipe at
+        //the pressure it expands to, isentropically at the velocity it has in the pipe, gas leaving at the node
+        //pressure, like the ghost states of a resolved pipe. the drop on the way in is taken implicitly (as a
+        //resistance, the drop over the flow), and so is the friction of the half, k rho u |u| over its volume
+        Real drive = end == PIPE_START ? ghostPressure[end] - pressure : pressure - ghostPressure[end];
+        bool entering = end == PIPE_START ? flow > Real(0) : flow < Real(0);
+        Real entrance = Real(0);
+        if (entering) {
+            Real totalTemperature = ghostPressure[end] / ghostDensity[end];
+            Real entryVelocity = flow / (density * area);
+            Real temperature = std::max(totalTemperature - (gamma - Real(1)) / (Real(2) * gamma) * entryVelocity * entryVelocity,
+                                        Real(2) / (gamma + Real(1)) * totalTemperature);
+            Real drop = ghostPressure[end] * (Real(1) - std::pow(temperature / totalTemperature, gamma / (gamma - Real(1))));
+            entrance = drop / std::abs(flow);
+        }
+        Real friction = m_halfLosses[2 * pipeIndex + end] * std::abs(flow) / (density * area);
+        flow = (flow + dt * area / halfLength * drive) / (Real(1) + dt * area / halfLength * entrance + dt * friction);
+
+        //the inertance alone lets a large pressure ratio drive any flow, gas cannot leave a volume faster than
+        //choked. the pipe's gas is moving, it chokes at its total state
+        bool inflow = end == PIPE_START ? flow > Real(0) : flow < Real(0);
+        Real upstreamDensity = ghostDensity[end];
+        Real upstreamPressure = ghostPressure[end];
+        if (!inflow) {
+            Real halfVelocity = flow / (density * area);
+            Real temperature = pressure / density;
+            Real totalTemperature = temperature + (gamma - Real(1)) / (Real(2) * gamma) * halfVelocity * halfVelocity;
+            upstreamPressure = pressure * std::pow(totalTemperature / temperature, gamma / (gamma - Real(1)));
+            upstreamDensity = upstreamPressure / totalTemperature;
+        }
+        Real chokedFlow = area * m_chokedFactor * std::sqrt(gamma * upstreamPressure * upstreamDensity);
+        flow = std::max(std::min(flow, chokedFlow), -chokedFlow);
+    }
+
+    Real enthalpy = (state.energy / (area * Real(2) * halfLength) + pressure) / density;
+    for (int end = 0; end < 2; end++) {
+        Real flow = state.massFlowRate[end];
+        bool entering = end == PIPE_START ? flow > Real(0) : flow < Real(0);
+        Real upwindEnthalpy = entering ? gamma / (gamma - Real(1)) * ghostPressure[end] / ghostDensity[end] : enthalpy;
+        pipe.boundaryMass[end] = dt * flow / area;
+        pipe.boundaryMomentum[end] = dt * (flow / area * velocity + pressure);
+        pipe.boundaryEnergy[end] = dt * flow / area * upwindEnthalpy;
+    }
+    //the species go upwind like the enthalpy, the node's composition in and the pipe's mean one out
+    Real* speciesMasses = GetLumpedSpeciesMasses(pipeIndex);
+    for (int end = 0; end < 2; end++) {
+        Real flow = state.massFlowRate[end];
+        bool entering = end == PIPE_START ? flow > Real(0) : flow < Real(0);
+        const Real* fractions = entering ? GetNodeMassFractions(m_endNodes[2 * pipeIndex + end]) : nullptr;
+        for (int k = 0; k < GetSpeciesCount(); k++) {
+            Real fraction = entering ? fractions[k] : speciesMasses[k] / state.mass;
+            pipe.boundarySpecies[end][k] = pipe.boundaryMass[end] * fraction;
+        }
+    }
+    for (int k = 0; k < GetSpeciesCount(); k++) {
+        speciesMasses[k] += area * (pipe.boundarySpecies[PIPE_START][k] - pipe.boundarySpecies[PIPE_END][k]);
+    }
+    state.mass += area * (pipe.boundaryMass[PIPE_START] - pipe.boundaryMass[PIPE_END]);
+    state.energy += area * (pipe.boundaryEnergy[PIPE_START] - pipe.boundaryEnergy[PIPE_END]);
+    pipe.timeStep = dt;
+    pipe.time += dt;
+}
+
+template<typename Real, typename Flux>
+bool BasicPipeNetwork<Real, Flux>::ExceedsPromotionThresholds(int pipeIndex, Real dt, Real scale) {
+    //across the pipe, and the jump a front moving at the speed of sound makes over one region
+    const Simulation& pipe = *m_pipes[pipeIndex];
+    Real ratio = Real(0), gradient = Real(0);
+    if (m_fidelityStates[pipeIndex].lumped) {
+        PipeFidelityState<Real>& state = m_fidelityStates[pipeIndex];
+        Real density, velocity, pressure;
+        GetLumpedState(pipeIndex, density, velocity, pressure);
+        Real soundSpeed = std::sqrt(gamma * std::max(pressure, Real(0)) / density);
+        Real regionTime = pipe.sizes[1] / soundSpeed;
+        Real lowest = pressure, highest = pressure;
+        for (int end = 0; end < 2; end++) {
+            if (pipe.boundary.closed[end]) {
+                continue;
+            }
+            Real ghostDensity, ghostPressure;
+            GetEndState(pipeIndex, (PipeEnd)end, ghostDensity, ghostPressure);
+            lowest = std::min(lowest, ghostPressure);
+            highest = std::max(highest, ghostPressure);
+            Real change = std::abs(ghostPressure - state.ghostPressure[end]) / std::min(ghostPressure, state.ghostPressure[end]);
+            gradient = dt > Real(0) ? std::max(gradient, change * regionTime / dt) : gradient;
+            state.ghostPressure[end] = ghostPressure;
+        }
+        ratio = highest / lowest - Real(1);
+    }
+    else {
+        Real lowest = pipe.pressure[0], highest = pipe.pressure[0];
+        for (int i = 1; i < pipe.GetResolution(); i++) {
+            lowest = std::min(lowest, pipe.pressure[i]);
+            highest = std::max(highest, pipe.pressure[i]);
+            gradient = std::max(gradient, std::abs(pipe.pressure[i] - pipe.pressure[i - 1]) / std::min(pipe.pressure[i], pipe.pressure[i - 1]));
+        }
+        ratio = highest / lowest - Real(1);
+    }
+    return !(ratio <= scale * promotionPressureRatio && gradient <= scale * promotionPressureGradient);
+}
+
+template<typename Real, typename Flux>
+Real BasicPipeNetwork<Real, Flux>::GetTotalMass() const {
+    Real mass = Real(0);
+    for (int p = 0; p < (int)m_pipes.size(); p++) {
+        const Simulation& pipe = *m_pipes[p];
+        if (m_fidelityStates[p].lumped) {
+            mass += m_fidelityStates[p].mass;
+            continue;
+        }
+        for (int i = 1; i < pipe.GetResolution() - 1; i++) {
+            mass += m_areas[p] * pipe.density[i] * pipe.sizes[i];
+        }
+    }
+    for (const NetworkNode<Real>& node : m_nodes) {
+        if (!std::isinf(node.volume)) {
+            mass += node.density * node.volume;
+        }
+    }
+    return mass;
+}
+
+template<typename Real, typename Flux>
+Real BasicPipeNetwork<Real, Flux>::GetTotalEnergy() const {
+    Real energy = Real(0);
+    for (int p = 0; p < (int)m_pipes.size(); p++) {
+        const Simulation& pipe = *m_pipes[p];
+        if (m_fidelityStates[p].lumped) {
+            energy += m_fidelityStates[p].energy;
+            continue;
+        }
+        for (int i = 1; i < pipe.GetResolution() - 1; i++) {
+            energy += m_areas[p] * pipe.energy[i] * pipe.sizes[i];
+        }
+    }
+    for (const NetworkNode<Real>& node : m_nodes) {
+        if (!std::isinf(node.volume)) {
+            energy += node.pressure / (gamma - Real(1)) * node.volume;
+        }
+    }
+    return energy;
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::Step() {
+    Step(Real(0));
+}
+
+template<typename Real, typename Flux>
+void BasicPipeNetwork<Real, Flux>::Step(Real dt) {
+    if (!m_compiled) {
+        Compile();
+    }
+
+    //promoted against the ghost states the nodes handed them at the end of the last step (or when compiled)
+    for (int pipe = 0; pipe < (int)m_pipes.size(); pipe++) {
+        const PipeFidelityState<Real>& fidelity = m_fidelityStates[pipe];
+        if (fidelity.lumped && fidelity.fidelity == ADAPTIVE_FIDELITY && ExceedsPromotionThresholds(pipe, timeStep, Real(1))) {
+            Resolve(pipe);
+        }
+    }
+
+    //the lists keep the largest first order. pipes fall asleep, are lumped and are resolved in the step before
+    //and between steps, walking the flags costs next to nothing against stepping the pipes
+    m_activePipes.clear();
+    m_sleepingPipes.clear();
+    m_lumpedPipes.clear();
+    for (int pipe : m_pipeOrder) {
+        if (m_fidelityStates[pipe].lumped) {
+            m_lumpedPipes.push_back(pipe);
+        }
+        else {
+            (m_sleepStates[pipe].asleep ? m_sleepingPipes : m_activePipes).push_back(pipe);
+        }
+    }
+    int activeCount = (int)m_activePipes.size();
+    int lumpedCount = (int)m_lumpedPipes.size();
+
+    if (dt <= Real(0)) {
+        ForEach(activeCount, [&](int index) {
+            int pipe = m_activePipes[index];
+            m_pipes[pipe]->CFL = CFL;
+            m_pipeTimeSteps[pipe] = m_pipes[pipe]->ComputeTimeStep();
+        });
+        ForEach(lumpedCount, [&](int index) {
+            int pipe = m_lumpedPipes[index];
+            m_pipeTimeSteps[pipe] = ComputeLumpedTimeStep(pipe);
+        });
+        for (int pipe : m_sleepingPipes) {
+            m_pipeTimeSteps[pipe] = m_sleepStates[pipe].timeStep;
+        }
+        dt = maxTimeStep;
+        for (Real pipeTimeStep : m_pipeTimeSteps) {
+            dt = std::min(dt, pipeTimeStep);
+        }
+    }
+
+    ForEach(activeCount, [&](int index) {
+        int pipe = m_activePipes[index];
+        m_pipes[pipe]->Step(dt);
+
+        if (sleepTolerance > Real(0) && --m_sleepStates[pipe].stepsUntilCheck <= 0) {
+            PipeSleepState<Real>& sleep = m_sleepStates[pipe];
+            sleep.stepsUntilCheck = std::max(sleepCheckInterval, 1);
+            if (ComputeResidual(pipe, dt) < sleepTolerance) {
+                const ExternalBoundary& boundary = m_pipes[pipe]->boundary;
+                sleep.asleep = true;
+                sleep.timeStep = m_pipeTimeSteps[pipe];
+                for (int end = 0; end < 2; end++) {
+                    sleep.ghostDensity[end] = (Real)boundary.density[end];
+                    sleep.ghostEnergy[end] = (Real)boundary.energy[end];
+                }
+            }
+        }
+
+        //lumped after its step, the nodes still balance the fluxes the step left behind
+        PipeFidelityState<Real>& fidelity = m_fidelityStates[pipe];
+        if (fidelity.fidelity == ADAPTIVE_FIDELITY && --fidelity.stepsUntilCheck <= 0) {
+            fidelity.stepsUntilCheck = std::max(fidelityCheckInterval, 1);
+            if (!ExceedsPromotionThresholds(pipe, dt, Real(0.5))) {
+                Lump(pipe);
+            }
+        }
+    });
+
+    m_chokedFactor = std::pow(Real(2) / (gamma + Real(1)), (gamma + Real(1)) / (Real(2) * (gamma - Real(1))));
+    ForEach(lumpedCount, [&](int index) {
+        StepLumped(m_lumpedPipes[index], dt);
+    });
+
+    //the end fluxes of a sleeping pipe stay what they were, only the step they are integrated over changes
+    for (int pipe : m_sleepingPipes) {
+        Simulation& simulation = *m_pipes[pipe];
+        int faces[2] = {0, simulation.GetResolution() - 2};
+        for (int end = 0; end < 2; end++) {
+            simulation.boundaryMass[end] = dt * simulation.massFlux[faces[end]];
+            simulation.boundaryMomentum[end] = dt * simulation.momentumFlux[faces[end]];
+            simulation.boundaryEnergy[end] = dt * simulation.energyFlux[faces[end]];
+            for (int k = 0; k < GetSpeciesCount(); k++) {
+                simulation.boundarySpecies[end][k] = dt * simulation.speciesFlux[(size_t)k * simulation.GetResolution() + faces[end]];
+            }
+        }
+        simulation.timeStep = dt;
+        simulation.time += dt;
+    }
+
+    //every port belongs to exactly one node, so nodes only write their own pipe ends
+    ForEach((int)m_nodes.size(), [&](int index) {
+        BalanceNode(index, dt);
+        UpdateGhostStates(index);
+    });
+
+    //pipes whose ghost states moved wake here, so nothing is pending between steps
+    if (sleepTolerance > Real(0) || !m_sleepingPipes.empty()) {
+        for (int pipe = 0; pipe < (int)m_pipes.size(); pipe++) {
+            PipeSleepState<Real>& sleep = m_sleepStates[pipe];
+            if (sleep.asleep && (m_wakeRequests[2 * pipe] || m_wakeRequests[2 * pipe + 1] || sleepTolerance <= Real(0))) {
+                sleep.asleep = false;
+                sleep.stepsUntilCheck = std::max(sleepCheckInterval, 1);
+            }
+            m_wakeRequests[2 * pipe] = 0;
+            m_wakeRequests[2 * pipe + 1] = 0;
+        }
+    }
+
+    timeStep = dt;
+    time += dt;
+}
+
+#define INSTANTIATE_PIPE_NETWORK(Real) \
+    template class BasicPipeNetwork<Real, RusanovFlux>; \
+    template class BasicPipeNetwork<Real, HLLFlux>; \
+    template class BasicPipeNetwork<Real, HLLCFlux>; \
+    template class BasicPipeNetwork<Real, RoeFlux>;
+
+INSTANTIATE_PIPE_NETWORK(float)
+INSTANTIATE_PIPE_NETWORK(double)
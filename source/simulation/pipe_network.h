@@ -0,0 +1,277 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef PIPE_NETWORK_H
+#define PIPE_NETWORK_H
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "gas_simulation.h"
+
+#endif //PIPE_NETWORK_H
+
+class ThreadPool;
+
+enum PipeEnd {
+    PIPE_START,     //region 1 side, the pipe's first interface
+    PIPE_END        //region n - 2 side, the pipe's last interface
+};
+
+//a 0D volume pipes end in: a junction between pipes, a tank, a pump or an engine. the gas in it is at rest, so
+//its state is the total state of gas flowing into a pipe, and the static pressure gas flowing out of one meets
+//(see BasicPipeNetwork for the ghost states this hands the pipe ends). an infinite volume holds its state fixed.
+//the composition of its gas is kept by the network (GetNodeMassFractions), so the node stays plain data a
+//checkpoint can copy
+template<typename Real>
+struct NetworkNode {
+    Real volume = std::numeric_limits<Real>::infinity();
+    Real density = 1;
+    Real pressure = 1;
+
+    //added to the pressure seen by outlet ports, the pressure rise of a pump at its design density. like a
+    //pump at fixed speed the rise scales with the density it is fed, so a starved pump stops pumping instead
+    //of drawing its inlet down to vacuum
+    Real pressureRise = 0;
+    Real designDensity = 1;
+
+    //net mass entering the node per unit time over the last step
+    Real massFlowRate = 0;
+
+    //flat port table of the node, filled when the network is compiled
+    int firstPort = 0;
+    int portCount = 0;
+};
+
+//a pipe at rest is skipped by the step. it sleeps with the ghost states it was last handed, and wakes when one
+//of them moves away from those
+template<typename Real>
+struct PipeSleepState {
+    bool asleep = false;
+    int stepsUntilCheck = 1;
+    Real timeStep = 0;      //the CFL step it proposed, its state does not change while it sleeps
+    Real ghostDensity[2] = {};
+    Real ghostEnergy[2] = {};
+};
+
+//how a pipe is modelled. RESOLVED_FIDELITY steps the 1D gas simulation, LUMPED_FIDELITY a 0D volume between
+//two inertances (see BasicPipeNetwork), ADAPTIVE_FIDELITY runs lumped and is promoted to the 1D simulation
+//while the pressures along it differ by more than the promotion thresholds
+enum PipeFidelity {
+    RESOLVED_FIDELITY,
+    LUMPED_FIDELITY,
+    ADAPTIVE_FIDELITY
+};
+
+//a lumped pipe: the gas of the whole pipe as one volume, and the mass flow through each half of it (positive
+//towards the end)
+template<typename Real>
+struct PipeFidelityState {
+    PipeFidelity fidelity = RESOLVED_FIDELITY;
+    bool lumped = false;
+    int stepsUntilCheck = 1;
+    Real mass = 0;
+    Real energy = 0;
+    Real massFlowRate[2] = {};
+    Real ghostPressure[2] = {};     //handed to it on the step before, for the rate the ends change at
+};
+
+struct NetworkPort {
+    int pipe = 0;
+    PipeEnd end = PIPE_START;
+    int node = 0;
+    bool outlet = false;
+};
+
+//1D pipes coupled through 0D nodes. each pipe is its own gas simulation whose ends are handed ghost states by
+//the node they connect to, and each node balances the mass and energy its pipes exchanged through their end
+//interfaces (integrated over the step with the pipe's own stage weights), so mass is conserved to round-off
+//across junctions. energy is too, except for the work pumps add at their outlets and the heat pipes with wall
+//losses (SetWallLosses) exchange with their walls. with species, a node takes in the species mass its ports
+//exchanged the same way and mixes it with its own, and hands its composition to the ghosts of its pipes.
+//
+//the ghost state at a pipe end carries the velocity of the region next to it. when the gas flows out of the
+//pipe the ghost holds the node's pressure (with the region's density), when it flows in the ghost is the node's
+//gas accelerated isentropically to that velocity, at most to the speed of sound. a pipe between two nodes at
+//rest then carries the flow bernoulli gives it: it takes in gas at the upstream node's total pressure and
+//dumps its dynamic pressure into the downstream node, which is where the momentum of gas entering a node goes,
+//like in a plenum.
+//
+//a step is three data parallel levels: every pipe proposes a CFL step (reduced to the smallest), every pipe
+//advances, every node balances its ports and refreshes the ghost states of its pipes. pipes are handed out
+//largest first, so the pipe level balances across cores as the network grows. the pipes run single threaded
+//inside the network, parallelism is across pipes.
+//
+//most pipes of a feed system sit at rest or at a steady flow for long stretches. with a sleep tolerance set,
+//every few steps each pipe checks its residual (the largest change of its conservatives over the step, from
+//its interface fluxes, relative to the region's own state) and goes to sleep below it. a sleeping pipe skips
+//its time step proposal, fluxes and update, and keeps handing its nodes the end fluxes it last had, so a
+//steady flow through it carries on. it wakes when a node hands it a ghost state that moved by more than the
+//wake tolerance, and the step costs roughly what the awake pipes cost.
+//
+//a pipe can also be lumped instead of resolved: its interior is one volume holding the pipe's mass and energy,
+//joined to the nodes at its ends by the inertance of each half of the pipe. the mass flow of a half is driven
+//by the pressure difference across it, with the node side at the pressure the ghost state of a resolved pipe
+//would have: gas entering from a node loses its dynamic pressure on the way in, gas leaving meets the node
+//pressure, short of choking. the ends hand the nodes the flows times the upwind total enthalpy, so the nodes
+//balance a lumped pipe like a resolved one. each half also loses to wall friction and fittings what its regions would, at their mean loss coefficient.
+//a lumped pipe costs the same few operations whatever its resolution, and takes a step limited by the wave
+//crossing half of it (and the volumes at its ends) rather than a region. adaptive pipes are promoted to the
+//1D simulation when the pressure ratio across them or the rate their end pressures change (as a jump per
+//region length) exceeds its threshold, and lumped again once the 1D pressures fall below half of both.
+//both transfers are conservative: lumping sums the regions' mass and energy, promoting spreads them back
+//over the regions at a uniform density with the momentum running between the two flows
+template<typename Real, typename Flux>
+class BasicPipeNetwork {
+public:
+    using Simulation = BasicGasSimulation<Real, Flux, ExternalBoundary>;
+
+private:
+    std::vector<std::unique_ptr<Simulation>> m_pipes;
+    std::vector<Real> m_areas;
+    std::vector<Real> m_lengths;        //of the interior regions
+    std::vector<Real> m_halfLosses;     //per pipe end, the mean loss coefficient of the half of the pipe at it
+    std::vector<NetworkNode<Real>> m_nodes;
+    std::vector<NetworkPort> m_ports;
+    std::vector<bool> m_automaticVolumes;
+
+    ThreadPool* m_threadPool = nullptr;
+    bool m_compiled = false;
+    std::vector<int> m_pipeOrder;
+    std::vector<Real> m_pipeTimeSteps;
+
+    std::vector<PipeSleepState<Real>> m_sleepStates;
+    std::vector<unsigned char> m_wakeRequests;     //per pipe end, so the two nodes of a pipe never write the same byte
+    std::vector<int> m_activePipes;                //awake pipes in pipe order
+    std::vector<int> m_sleepingPipes;
+
+    std::vector<PipeFidelityState<Real>> m_fidelityStates;
+    std::vector<int> m_lumpedPipes;
+
+    //passive species, the mass fractions of every node and the species masses of every lumped pipe, one per
+    //species each (index * species + k)
+    std::vector<Gas> m_species;
+    std::vector<Real> m_nodeMassFractions;
+    std::vector<Real> m_lumpedSpeciesMasses;
+    std::vector<Real> m_nodePortAreas;      //summed over the ports of every node
+    std::vector<int> m_endNodes;            //per pipe end, -1 when closed
+    std::vector<unsigned char> m_endOutlets;    //per pipe end, whether it is a pump outlet
+    Real m_chokedFactor = 0;                //choked mass flux over sqrt(gamma pressure density)
+
+    void Compile();
+    void BalanceNode(int nodeIndex, Real dt);
+    void GetEndState(int pipe, PipeEnd end, Real& density, Real& pressure) const;
+    void UpdateGhostState(int pipe, PipeEnd end);
+    void UpdateGhostStates(int nodeIndex);
+    Real ComputeResidual(int pipe, Real dt) const;
+    Real ComputeLumpedTimeStep(int pipe) const;
+    void StepLumped(int pipe, Real dt);
+    bool ExceedsPromotionThresholds(int pipe, Real dt, Real scale);
+    void Lump(int pipe);
+    void Resolve(int pipe);
+
+    template<typename Task>
+    void ForEach(int count, const Task& task);
+
+public:
+    Real gamma = 1.4;
+    Real CFL = 0.9;
+    Real time = 0;
+    Real timeStep = 0;
+    Real maxTimeStep = std::numeric_limits<Real>::infinity();
+
+    //0 keeps every pipe awake. the residual is checked every sleepCheckInterval steps, staggered across pipes
+    Real sleepTolerance = 0;
+    Real wakeTolerance = Real(1e-4);
+    int sleepCheckInterval = 8;
+
+    //adaptive pipes are promoted when the largest pressure over the smallest one across them exceeds 1 plus
+    //the ratio, or the relative pressure jump per region length exceeds the gradient. resolved adaptive pipes
+    //check every fidelityCheckInterval steps whether they fell below half of both
+    Real promotionPressureRatio = Real(0.1);
+    Real promotionPressureGradient = Real(0.01);
+    int fidelityCheckInterval = 8;
+
+    //resolution counts the two ghost regions, the state starts uniform and at rest
+    int AddPipe(Real length, Real area, int resolution, Real density = 1, Real pressure = 1);
+
+    //a volume of 0 sizes the node like one region of each connected pipe, the smallest volume that keeps the
+    //node as stable as the pipes at the same CFL number
+    int AddNode(Real volume, Real density, Real pressure, Real pressureRise = 0);
+
+    void Connect(int pipe, PipeEnd end, int node, bool outlet = false);
+
+    //wall friction of a pipe (darcy friction factor, over the hydraulic diameter of its area), the loss
+    //coefficients of the fittings along it, one per region (nullptr for a straight pipe), and the R T of its
+    //walls, 0 for adiabatic walls. 0 friction and no fittings is the frictionless pipe it starts out as
+    void SetWallLosses(int pipe, Real frictionFactor, const Real* fittingLosses = nullptr, Real wallTemperature = 0);
+
+    void SetThreadPool(ThreadPool* threadPool) { m_threadPool = threadPool; }
+
+    //passive species (BasicGasSimulation::SetSpecies) carried through every pipe, lumped pipes included, and
+    //mixed by mass in the nodes, so what a junction or a tank mixes comes out of the same run. everything starts
+    //out as the first species, none (the default) carries no composition at all
+    void SetSpecies(const std::vector<Gas>& species);
+    int GetSpeciesCount() const { return (int)m_species.size(); }
+    const std::vector<Gas>& GetSpecies() const { return m_species; }
+
+    //one per species, they add up to one. an infinite node keeps the composition it is given, like its state
+    Real* GetNodeMassFractions(int node) { return m_nodeMassFractions.data() + (size_t)node * m_species.size(); }
+    const Real* GetNodeMassFractions(int node) const { return m_nodeMassFractions.data() + (size_t)node * m_species.size(); }
+
+    //the mixed composition of the gas a node's ports brought in over the last step, the node's own when none
+    //flowed in. what reaches an infinite node (an engine), whose own composition never changes
+    void GetNodeInflowFractions(int node, Real* fractions) const;
+
+    //the species masses of a lumped pipe, the rest of its state is in its PipeFidelityState
+    Real* GetLumpedSpeciesMasses(int pipe) { return m_lumpedSpeciesMasses.data() + (size_t)pipe * m_species.size(); }
+    const Real* GetLumpedSpeciesMasses(int pipe) const { return m_lumpedSpeciesMasses.data() + (size_t)pipe * m_species.size(); }
+
+    //compiles the port tables and ghost states now rather than on the first step, so state written into the
+    //pipes and nodes afterwards (a restored checkpoint) is exactly what the first step starts from
+    void Prepare() {
+        if (!m_compiled) {
+            Compile();
+        }
+    }
+
+    int GetPipeCount() const { return (int)m_pipes.size(); }
+    int GetNodeCount() const { return (int)m_nodes.size(); }
+    Simulation& GetPipe(int pipe) { return *m_pipes[pipe]; }
+    const Simulation& GetPipe(int pipe) const { return *m_pipes[pipe]; }
+    Real GetArea(int pipe) const { return m_areas[pipe]; }
+    NetworkNode<Real>& GetNode(int node) { return m_nodes[node]; }
+    const NetworkNode<Real>& GetNode(int node) const { return m_nodes[node]; }
+
+    //resolved pipes the last step advanced, and whether a pipe sleeps (set to restore a saved network)
+    int GetActivePipeCount() const { return m_compiled ? (int)m_activePipes.size() : GetPipeCount(); }
+    const PipeSleepState<Real>& GetSleepState(int pipe) const { return m_sleepStates[pipe]; }
+    void SetSleepState(int pipe, const PipeSleepState<Real>& state) { m_sleepStates[pipe] = state; }
+
+    //switching to or from a lumped model transfers the pipe's state right away. the state of a lumped pipe is
+    //only held by its PipeFidelityState, its regions are left as they were when it was lumped
+    void SetFidelity(int pipe, PipeFidelity fidelity);
+    PipeFidelity GetFidelity(int pipe) const { return m_fidelityStates[pipe].fidelity; }
+    bool IsLumped(int pipe) const { return m_fidelityStates[pipe].lumped; }
+    int GetLumpedPipeCount() const;
+    const PipeFidelityState<Real>& GetFidelityState(int pipe) const { return m_fidelityStates[pipe]; }
+    void SetFidelityState(int pipe, const PipeFidelityState<Real>& state) { m_fidelityStates[pipe] = state; }
+
+    //the mean state of a lumped pipe
+    void GetLumpedState(int pipe, Real& density, Real& velocity, Real& pressure) const;
+
+    //gas held by the pipe interiors and the finite nodes
+    Real GetTotalMass() const;
+    Real GetTotalEnergy() const;
+
+    //advance with the CFL step of the whole network, or with a fixed step
+    void Step();
+    void Step(Real dt);
+};
+
+//the configuration used by the editor
+using PipeNetwork = BasicPipeNetwork<float, HLLFlux>;
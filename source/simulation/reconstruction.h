@@ -0,0 +1,114 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef RECONSTRUCTION_H
+#define RECONSTRUCTION_H
+
+#include "equation_of_state.h"
+#include "simd.h"
+
+#endif //RECONSTRUCTION_H
+
+//spatial order of BasicGasSimulation. the MUSCL variants reconstruct a limited linear profile of the primitives
+//inside each region, which makes the scheme second order in smooth flow while staying TVD at shocks
+enum Reconstruction {
+    PIECEWISE_CONSTANT,
+    MUSCL_MINMOD,
+    MUSCL_VAN_LEER,
+    MUSCL_MC
+};
+
+//slope limiters, a and b are the backward and forward differences around a region
+struct MinmodLimiter {
+    template<typename P>
+    static P Limit(P a, P b) {
+        P zero = 0.0;
+        P smaller = Select(LessEqual(Abs(a), Abs(b)), a, b);
+        return Select(LessEqual(a * b, zero), zero, smaller);
+    }
+};
+
+struct VanLeerLimiter {
+    template<typename P>
+    static P Limit(P a, P b) {
+        P zero = 0.0;
+        P product = a * b;
+        //the division is discarded wherever the product is not positive, so a zero denominator is harmless
+        P sum = Select(LessEqual(product, zero), P(1.0), a + b);
+        return Select(LessEqual(product, zero), zero, P(2.0) * product / sum);
+    }
+};
+
+//monotonized central
+struct MCLimiter {
+    template<typename P>
+    static P Limit(P a, P b) {
+        P zero = 0.0;
+        P magnitude = Min(Min(P(2.0) * Abs(a), P(2.0) * Abs(b)), P(0.5) * Abs(a + b));
+        P slope = Select(GreaterEqual(a, zero), magnitude, zero - magnitude);
+        return Select(LessEqual(a * b, zero), zero, slope);
+    }
+};
+
+//writes the left and right conservative states of every interface in [begin, end) from limited linear profiles
+//of the primitives. the interfaces touching the first and last region have no second neighbour and fall back
+//to piecewise constant states
+template<typename Limiter, typename Real, typename Eos>
+void ReconstructFaces(const Real* density, const Real* velocity, const Real* pressure, int n, int begin, int end, const Eos& eos,
+                      Real* leftDensity, Real* leftMomentum, Real* leftEnergy,
+                      Real* rightDensity, Real* rightMomentum, Real* rightEnergy) {
+    auto store = [&](auto rho, auto u, auto p, Real* outDensity, Real* outMomentum, Real* outEnergy, int i) {
+        using P = decltype(rho);
+        rho.Store(outDensity + i);
+        (rho * u).Store(outMomentum + i);
+        (eos.InternalEnergy(rho, p) + P(0.5) * rho * u * u).Store(outEnergy + i);
+    };
+
+    auto interface = [&](auto pack, int i) {
+        using P = decltype(pack);
+        P half = 0.5;
+
+        P rho0 = P::Load(density + i - 1), rho1 = P::Load(density + i), rho2 = P::Load(density + i + 1), rho3 = P::Load(density + i + 2);
+        P u0 = P::Load(velocity + i - 1), u1 = P::Load(velocity + i), u2 = P::Load(velocity + i + 1), u3 = P::Load(velocity + i + 2);
+        P p0 = P::Load(pressure + i - 1), p1 = P::Load(pressure + i), p2 = P::Load(pressure + i + 1), p3 = P::Load(pressure + i + 2);
+
+        store(rho1 + half * Limiter::Limit(rho1 - rho0, rho2 - rho1),
+              u1 + half * Limiter::Limit(u1 - u0, u2 - u1),
+              p1 + half * Limiter::Limit(p1 - p0, p2 - p1),
+              leftDensity, leftMomentum, leftEnergy, i);
+        store(rho2 - half * Limiter::Limit(rho2 - rho1, rho3 - rho2),
+              u2 - half * Limiter::Limit(u2 - u1, u3 - u2),
+              p2 - half * Limiter::Limit(p2 - p1, p3 - p2),
+              rightDensity, rightMomentum, rightEnergy, i);
+    };
+
+    auto constant = [&](int i) {
+        using P = ScalarPack<Real>;
+        store(P(density[i]), P(velocity[i]), P(pressure[i]), leftDensity, leftMomentum, leftEnergy, i);
+        store(P(density[i + 1]), P(velocity[i + 1]), P(pressure[i + 1]), rightDensity, rightMomentum, rightEnergy, i);
+    };
+
+    using Pack = SimdPack<Real>;
+    using Lane = ScalarPack<Real>;
+
+    int first = std::max(begin, 1);
+    int last = std::min(end, n - 2);
+    for (int i = begin; i < std::min(first, end); i++) {
+        constant(i);
+    }
+
+    int i = first;
+    for (; i + Pack::width <= last; i += Pack::width) {
+        interface(Pack(), i);
+    }
+    for (; i < last; i++) {
+        interface(Lane(), i);
+    }
+
+    for (i = std::max(last, first); i < end; i++) {
+        constant(i);
+    }
+}
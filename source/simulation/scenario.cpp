@@ -0,0 +1,591 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "scenario.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "telemetry.h"
+
+static int FindName(const std::vector<std::string>& names, const std::string& name) {
+    auto found = std::find(names.begin(), names.end(), name);
+    return found == names.end() ? -1 : (int)(found - names.begin());
+}
+
+static bool ParseMode(const std::string& text, SimulationMode& mode) {
+    if (text == "transient") {
+        mode = TRANSIENT;
+        return true;
+    }
+    if (text == "steady") {
+        mode = STEADY_STATE;
+        return true;
+    }
+    if (text == "quasisteady") {
+        mode = QUASI_STEADY;
+        return true;
+    }
+    return false;
+}
+
+static bool ParseFidelity(const std::string& text, PipeFidelity& fidelity) {
+    if (text == "resolved") {
+        fidelity = RESOLVED_FIDELITY;
+        return true;
+    }
+    if (text == "lumped") {
+        fidelity = LUMPED_FIDELITY;
+        return true;
+    }
+    if (text == "adaptive") {
+        fidelity = ADAPTIVE_FIDELITY;
+        return true;
+    }
+    return false;
+}
+
+//the optional "<key> <value>" pairs of a component or pipe, up to the end of the line or the stop word
+static bool ParseProperties(std::istringstream& line, const std::vector<std::string>& keys, std::vector<float*> values, const std::string& stopWord, std::string& error) {
+    std::string key;
+    while (line >> key) {
+        if (key == stopWord) {
+            return true;
+        }
+        int index = FindName(keys, key);
+        if (index == -1) {
+            error = "unknown property " + key;
+            return false;
+        }
+        if (!(line >> *values[index])) {
+            error = "missing value for " + key;
+            return false;
+        }
+    }
+    return stopWord.empty();
+}
+
+static bool ParseStatement(const std::string& keyword, std::istringstream& line, Scenario& scenario, std::string& error) {
+    NetworkLayout& layout = scenario.layout;
+
+    if (keyword == "ambient") {
+        return (bool)(line >> layout.ambientPressure >> layout.ambientDensity);
+    }
+    if (keyword == "resolution") {
+        return (bool)(line >> layout.pipeRegionSize) && layout.pipeRegionSize > 0.0f;
+    }
+    if (keyword == "sleep") {
+        return (bool)(line >> layout.sleepTolerance) && layout.sleepTolerance >= 0.0f;
+    }
+    if (keyword == "fidelity") {
+        std::string fidelity;
+        return (bool)(line >> fidelity) && ParseFidelity(fidelity, layout.fidelity);
+    }
+    if (keyword == "friction") {
+        return (bool)(line >> layout.frictionFactor) && layout.frictionFactor >= 0.0f;
+    }
+    if (keyword == "tick") {
+        return (bool)(line >> scenario.tickTime) && scenario.tickTime > 0.0;
+    }
+    if (keyword == "substeps") {
+        return (bool)(line >> scenario.maxSubSteps) && scenario.maxSubSteps > 0;
+    }
+    if (keyword == "duration") {
+        return (bool)(line >> scenario.duration);
+    }
+    if (keyword == "output") {
+        return (bool)(line >> scenario.outputInterval);
+    }
+    if (keyword == "mode") {
+        std::string mode;
+        return (bool)(line >> mode) && ParseMode(mode, scenario.mode);
+    }
+    if (keyword == "restore") {
+        return (bool)(line >> scenario.restorePath);
+    }
+    if (keyword == "checkpoint") {
+        return (bool)(line >> scenario.checkpointPath);
+    }
+    if (keyword == "telemetry") {
+        return (bool)(line >> scenario.telemetryPath);
+    }
+    if (keyword == "combustion") {
+        std::string table, interpolation;
+        if (!(line >> table)) {
+            return false;
+        }
+        scenario.combustionTablePath = table == "generated" ? "" : table;
+        if (!(line >> interpolation)) {
+            return true;
+        }
+        scenario.combustionInterpolation = interpolation == "bicubic" ? BICUBIC_INTERPOLATION : BILINEAR_INTERPOLATION;
+        return interpolation == "bicubic" || interpolation == "bilinear";
+    }
+
+    if (keyword == "species") {
+        std::string name;
+        Gas gas;
+        if (!(line >> name) || FindName(scenario.speciesNames, name) != -1) {
+            error = "missing or repeated species name";
+            return false;
+        }
+        if (!layout.components.empty()) {
+            error = "species have to come before the components";
+            return false;
+        }
+        //the species are passive, a name is all they take
+        if (!ParseProperties(line, {}, {}, "", error)) {
+            return false;
+        }
+        layout.species.push_back(gas);
+        scenario.speciesNames.push_back(name);
+        return true;
+    }
+
+    if (keyword == "tank" || keyword == "pump" || keyword == "engine") {
+        std::string name;
+        if (!(line >> name) || FindName(scenario.componentNames, name) != -1) {
+            error = "missing or repeated component name";
+            return false;
+        }
+        ComponentLayout component;
+        bool parsed;
+        size_t speciesCount = layout.species.size();
+        layout.componentMassFractions.resize((layout.components.size() + 1) * speciesCount, 0.0f);
+        if (keyword == "tank") {
+            //the species names give the mass fractions of the tank's gas
+            component.type = TANK_COMPONENT;
+            component.outletPressure = 10.0f;
+            std::vector<std::string> keys = {"volume", "amount", "pressure"};
+            std::vector<float*> values = {&component.volume, &component.storedAmount, &component.outletPressure};
+            for (size_t k = 0; k < speciesCount; k++) {
+                keys.push_back(scenario.speciesNames[k]);
+                values.push_back(&layout.componentMassFractions[layout.components.size() * speciesCount + k]);
+            }
+            parsed = ParseProperties(line, keys, values, "", error);
+        }
+        else if (keyword == "pump") {
+            component.type = PUMP_COMPONENT;
+            component.inletPressure = -5.0f;
+            component.outletPressure = 5.0f;
+            parsed = ParseProperties(line, {"inlet", "outlet", "maxflow"}, {&component.inletPressure, &component.outletPressure, &component.maxMassFlowRate}, "", error);
+        }
+        else {
+            component.type = ENGINE_COMPONENT;
+            component.inletPressure = -0.5f;
+            parsed = ParseProperties(line, {"pressure", "mixture", "throat", "volume"}, {&component.inletPressure, &component.mixtureRatio, &component.throatArea, &component.volume}, "", error);
+        }
+        layout.components.push_back(component);
+        scenario.componentNames.push_back(name);
+        return parsed;
+    }
+
+    if (keyword == "pipe") {
+        std::string name;
+        if (!(line >> name) || FindName(scenario.pipeNames, name) != -1) {
+            error = "missing or repeated pipe name";
+            return false;
+        }
+        PipeLayout pipe;
+        float bevel = 0.0f;
+        if (!ParseProperties(line, {"radius", "density", "pressure", "velocity", "bevel"}, {&pipe.radius, &pipe.density, &pipe.pressure, &pipe.velocity, &bevel}, "path", error)) {
+            if (error.empty()) {
+                error = "pipe without a path";
+            }
+            return false;
+        }
+        std::vector<glm::vec3> points;
+        glm::vec3 point;
+        while (line >> point.x >> point.y >> point.z) {
+            points.push_back(point);
+        }
+        if (points.size() < 2 || !line.eof()) {
+            error = "a path needs at least two points of three coordinates";
+            return false;
+        }
+        pipe.length = 0.0f;
+        for (size_t i = 0; i + 1 < points.size(); i++) {
+            glm::vec3 segment = points[i + 1] - points[i];
+            pipe.length += std::sqrt(segment.x * segment.x + segment.y * segment.y + segment.z * segment.z);
+        }
+        pipe.start = points.front();
+        pipe.end = points.back();
+        AddPathBends((int)layout.pipes.size(), points, std::vector<float>(points.size(), bevel), layout.bends);
+        layout.pipes.push_back(pipe);
+        scenario.pipeNames.push_back(name);
+        return true;
+    }
+
+    if (keyword == "connect") {
+        std::string pipeName, end, componentName, outlet;
+        if (!(line >> pipeName >> end >> componentName) || (end != "start" && end != "end")) {
+            return false;
+        }
+        PortLayout port;
+        port.pipe = FindName(scenario.pipeNames, pipeName);
+        port.component = FindName(scenario.componentNames, componentName);
+        port.end = end == "start" ? PIPE_START : PIPE_END;
+        port.outlet = (bool)(line >> outlet) && outlet == "outlet";
+        if (port.pipe == -1 || port.component == -1) {
+            error = "unknown pipe or component";
+            return false;
+        }
+        for (const PortLayout& other : layout.ports) {
+            if (other.pipe == port.pipe && other.end == port.end) {
+                error = "pipe end connected twice";
+                return false;
+            }
+        }
+        layout.ports.push_back(port);
+        return true;
+    }
+
+    if (keyword == "at") {
+        ScenarioEvent event;
+        std::string action;
+        if (!(line >> event.time >> action)) {
+            return false;
+        }
+        if (action == "mode") {
+            std::string mode;
+            event.type = SET_SIMULATION_MODE;
+            scenario.events.push_back(event);
+            return (bool)(line >> mode) && ParseMode(mode, scenario.events.back().mode);
+        }
+        if (action == "fidelity") {
+            std::string pipeName, fidelity;
+            if (!(line >> pipeName >> fidelity) || !ParseFidelity(fidelity, event.fidelity)) {
+                return false;
+            }
+            event.type = SET_PIPE_FIDELITY;
+            event.pipe = pipeName == "all" ? -1 : FindName(scenario.pipeNames, pipeName);
+            if (pipeName != "all" && event.pipe == -1) {
+                error = "unknown pipe " + pipeName;
+                return false;
+            }
+            scenario.events.push_back(event);
+            return true;
+        }
+        std::string componentName, field;
+        if (action != "set" || !(line >> componentName >> field >> event.value)) {
+            return false;
+        }
+        event.component = FindName(scenario.componentNames, componentName);
+        if (event.component == -1) {
+            error = "unknown component " + componentName;
+            return false;
+        }
+        //the pressure of a tank is its outlet, of an engine its chamber (the inlet)
+        NetworkComponentType type = layout.components[event.component].type;
+        if (field == "inlet" || (field == "pressure" && type == ENGINE_COMPONENT)) {
+            event.type = SET_INLET_PRESSURE;
+        }
+        else if (field == "outlet" || (field == "pressure" && type == TANK_COMPONENT)) {
+            event.type = SET_OUTLET_PRESSURE;
+        }
+        else {
+            error = "unknown set point " + field;
+            return false;
+        }
+        scenario.events.push_back(event);
+        return true;
+    }
+
+    error = "unknown statement " + keyword;
+    return false;
+}
+
+bool LoadScenario(const std::string& path, Scenario& scenario, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "unable to open " + path;
+        return false;
+    }
+
+    scenario = Scenario();
+    std::string text;
+    for (int lineNumber = 1; std::getline(file, text); lineNumber++) {
+        text = text.substr(0, text.find('#'));
+        std::istringstream line(text);
+        std::string keyword;
+        if (!(line >> keyword)) {
+            continue;
+        }
+        std::string message;
+        if (!ParseStatement(keyword, line, scenario, message)) {
+            error = path + ":" + std::to_string(lineNumber) + ": " + (message.empty() ? "malformed " + keyword : message);
+            return false;
+        }
+    }
+
+    std::stable_sort(scenario.events.begin(), scenario.events.end(), [](const ScenarioEvent& a, const ScenarioEvent& b) {
+        return a.time < b.time;
+    });
+
+    size_t slash = path.find_last_of("/\\");
+    for (std::string* filePath : {&scenario.restorePath, &scenario.checkpointPath, &scenario.telemetryPath, &scenario.combustionTablePath}) {
+        if (slash != std::string::npos && !filePath->empty() && filePath->front() != '/') {
+            *filePath = path.substr(0, slash + 1) + *filePath;
+        }
+    }
+    return true;
+}
+
+bool SetScenarioParameter(Scenario& scenario, const std::string& name, float value) {
+    NetworkLayout& layout = scenario.layout;
+    size_t dot = name.rfind('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    std::string object = name.substr(0, dot);
+    std::string property = name.substr(dot + 1);
+
+    if (object == "ambient" && property == "pressure") {
+        layout.ambientPressure = value;
+        return true;
+    }
+    if (object == "ambient" && property == "density") {
+        layout.ambientDensity = value;
+        return true;
+    }
+    if (object == "pipes" && property == "friction") {
+        layout.frictionFactor = value;
+        return true;
+    }
+    if (object == "gas" && property == "specificConstant") {
+        layout.ambientDensity = layout.ambientPressure / value;
+        return true;
+    }
+
+    int component = FindName(scenario.componentNames, object);
+    if (component != -1) {
+        ComponentLayout& layoutComponent = layout.components[component];
+        float* field = nullptr;
+        if (layoutComponent.type == TANK_COMPONENT) {
+            field = property == "volume" ? &layoutComponent.volume : property == "amount" ? &layoutComponent.storedAmount : property == "pressure" ? &layoutComponent.outletPressure : nullptr;
+            int species = FindName(scenario.speciesNames, property);
+            if (species != -1 && layout.componentMassFractions.size() == layout.components.size() * layout.species.size()) {
+                field = &layout.componentMassFractions[component * layout.species.size() + species];
+            }
+        }
+        else if (layoutComponent.type == PUMP_COMPONENT) {
+            field = property == "inlet" ? &layoutComponent.inletPressure : property == "outlet" ? &layoutComponent.outletPressure : property == "maxflow" ? &layoutComponent.maxMassFlowRate : nullptr;
+        }
+        else {
+            field = property == "pressure" ? &layoutComponent.inletPressure : property == "mixture" ? &layoutComponent.mixtureRatio : property == "throat" ? &layoutComponent.throatArea : property == "volume" ? &layoutComponent.volume : nullptr;
+        }
+        if (field) {
+            *field = value;
+        }
+        return field != nullptr;
+    }
+
+    int pipe = FindName(scenario.pipeNames, object);
+    if (pipe != -1) {
+        PipeLayout& layoutPipe = layout.pipes[pipe];
+        float* field = property == "radius" ? &layoutPipe.radius : property == "density" ? &layoutPipe.density : property == "pressure" ? &layoutPipe.pressure : property == "velocity" ? &layoutPipe.velocity : nullptr;
+        if (field) {
+            *field = value;
+        }
+        return field != nullptr;
+    }
+    return false;
+}
+
+static void WriteRow(std::ostream& output, double time, const SimulationSnapshot& snapshot) {
+    output << time;
+    for (float value : snapshot.tankStoredAmounts) {
+        output << "," << value;
+    }
+    size_t speciesCount = snapshot.engineMassFlowRates.empty() ? 0 : snapshot.engineMassFractions.size() / snapshot.engineMassFlowRates.size();
+    for (size_t i = 0; i < snapshot.engineMassFlowRates.size(); i++) {
+        output << "," << snapshot.engineMassFlowRates[i] << "," << snapshot.engineThrusts[i];
+        for (size_t k = 0; k < speciesCount; k++) {
+            output << "," << snapshot.engineMassFractions[i * speciesCount + k];
+        }
+    }
+    for (size_t i = 0; i < snapshot.pipePressures.size(); i++) {
+        output << "," << snapshot.pipePressures[i] << "," << snapshot.pipeMassFlowRates[i];
+    }
+    output << "\n";
+}
+
+//continues from the scenario's checkpoint, with the set points the scenario changed since it was written
+static bool RestoreScenario(const Scenario& scenario, NetworkSimulation& simulation, std::string& error) {
+    if (!simulation.LoadCheckpoint(scenario.restorePath, error)) {
+        return false;
+    }
+    const NetworkLayout& restored = simulation.GetLayout();
+    bool matches = restored.components.size() == scenario.layout.components.size() && restored.pipes.size() == scenario.layout.pipes.size() &&
+                   restored.species.size() == scenario.layout.species.size();
+    for (size_t i = 0; matches && i < restored.components.size(); i++) {
+        matches = restored.components[i].type == scenario.layout.components[i].type;
+    }
+    if (!matches) {
+        error = scenario.restorePath + ": the checkpoint's components, pipes and species are not the scenario's";
+        return false;
+    }
+
+    for (int i = 0; i < (int)restored.components.size(); i++) {
+        const ComponentLayout& component = scenario.layout.components[i];
+        if (component.inletPressure != restored.components[i].inletPressure) {
+            simulation.SetInletPressure(i, component.inletPressure);
+        }
+        if (component.outletPressure != restored.components[i].outletPressure) {
+            simulation.SetOutletPressure(i, component.outletPressure);
+        }
+    }
+    if (scenario.layout.fidelity != restored.fidelity) {
+        simulation.SetPipeFidelity(-1, scenario.layout.fidelity);
+    }
+    return true;
+}
+
+ScenarioResult RunScenario(const Scenario& scenario, ThreadPool* threadPool, std::ostream* output) {
+    ScenarioResult result;
+    NetworkSimulation simulation;
+    if (scenario.restorePath.empty()) {
+        simulation.Compile(scenario.layout);
+        simulation.mode = scenario.mode;
+    }
+    else if (!RestoreScenario(scenario, simulation, result.error)) {
+        return result;
+    }
+    simulation.SetThreadPool(threadPool);
+
+    //only engines with a throat need a table, the generated one takes a moment to fill
+    CombustionTable combustion;
+    combustion.interpolation = scenario.combustionInterpolation;
+    const std::vector<ComponentLayout>& components = simulation.GetLayout().components;
+    if (std::any_of(components.begin(), components.end(), [](const ComponentLayout& component) { return component.throatArea > 0.0f; })) {
+        if (scenario.combustionTablePath.empty()) {
+            combustion.Generate();
+        }
+        else if (!combustion.Load(scenario.combustionTablePath, result.error)) {
+            return result;
+        }
+        simulation.SetCombustionTable(&combustion);
+    }
+
+    TelemetryWriter telemetry;
+    if (!scenario.telemetryPath.empty()) {
+        if (!telemetry.Open(scenario.telemetryPath, simulation.GetTelemetryChannels(scenario.componentNames, scenario.pipeNames, scenario.speciesNames), result.error)) {
+            return result;
+        }
+        simulation.SetTelemetry(&telemetry);
+    }
+
+    SimulationSnapshot& snapshot = result.finalState;
+    simulation.WriteSnapshot(snapshot);
+    result.engineDeliveredMasses.assign(snapshot.engineMassFlowRates.size(), 0.0);
+    std::vector<float> previousFlows = snapshot.engineMassFlowRates;
+    double startTime = simulation.GetTime();
+    double time = startTime;
+    double previousSample = time;
+    if (output) {
+        *output << "time";
+        for (size_t i = 0; i < scenario.layout.components.size(); i++) {
+            if (scenario.layout.components[i].type == TANK_COMPONENT) {
+                *output << "," << scenario.componentNames[i] << ".storedAmount";
+            }
+        }
+        for (size_t i = 0; i < scenario.layout.components.size(); i++) {
+            if (scenario.layout.components[i].type == ENGINE_COMPONENT) {
+                *output << "," << scenario.componentNames[i] << ".massFlowRate," << scenario.componentNames[i] << ".thrust";
+                for (const std::string& species : scenario.speciesNames) {
+                    *output << "," << scenario.componentNames[i] << "." << species;
+                }
+            }
+        }
+        for (const std::string& name : scenario.pipeNames) {
+            *output << "," << name << ".pressure," << name << ".massFlowRate";
+        }
+        *output << "\n";
+        WriteRow(*output, time, snapshot);
+    }
+
+    //ticks are cut short to land exactly on events, outputs and the end. a restored run picks the output times
+    //up where the saved run would have been, so both write the same rows
+    auto start = std::chrono::steady_clock::now();
+    double nextOutput = scenario.outputInterval;
+    double epsilon = 1e-9 * std::max(scenario.duration, 1.0);
+    while (scenario.outputInterval > 0.0 && nextOutput < time + epsilon) {
+        nextOutput += scenario.outputInterval;
+    }
+    double activePipes = 0.0;
+    double lumpedPipes = 0.0;
+    size_t nextEvent = 0;
+    while (nextEvent < scenario.events.size() && scenario.events[nextEvent].time < time - epsilon) {
+        nextEvent++;
+    }
+    while (time < scenario.duration - epsilon) {
+        for (; nextEvent < scenario.events.size() && scenario.events[nextEvent].time <= time + epsilon; nextEvent++) {
+            const ScenarioEvent& event = scenario.events[nextEvent];
+            if (event.type == SET_INLET_PRESSURE) {
+                simulation.SetInletPressure(event.component, event.value);
+            }
+            else if (event.type == SET_OUTLET_PRESSURE) {
+                simulation.SetOutletPressure(event.component, event.value);
+            }
+            else if (event.type == SET_PIPE_FIDELITY) {
+                simulation.SetPipeFidelity(event.pipe, event.fidelity);
+            }
+            else {
+                simulation.mode = event.mode;
+            }
+        }
+
+        double step = std::min(scenario.tickTime, scenario.duration - time);
+        if (nextEvent < scenario.events.size()) {
+            step = std::min(step, scenario.events[nextEvent].time - time);
+        }
+        if (scenario.outputInterval > 0.0) {
+            step = std::min(step, nextOutput - time);
+        }
+        simulation.Advance(step, scenario.maxSubSteps);
+        time += step;
+        result.ticks++;
+        activePipes += simulation.GetNetwork().GetActivePipeCount();
+        lumpedPipes += simulation.GetNetwork().GetLumpedPipeCount();
+
+        if (scenario.outputInterval <= 0.0 || time >= nextOutput - epsilon || time >= scenario.duration - epsilon) {
+            simulation.WriteSnapshot(snapshot);
+            for (size_t i = 0; i < snapshot.engineMassFlowRates.size(); i++) {
+                result.engineDeliveredMasses[i] += 0.5 * (previousFlows[i] + snapshot.engineMassFlowRates[i]) * (time - previousSample);
+                previousFlows[i] = snapshot.engineMassFlowRates[i];
+            }
+            for (float pressure : snapshot.pipePressures) {
+                result.peakPipePressure = std::max(result.peakPipePressure, pressure);
+            }
+            previousSample = time;
+
+            if (output) {
+                WriteRow(*output, time, snapshot);
+            }
+            nextOutput += scenario.outputInterval;
+        }
+    }
+
+    result.simulatedTime = time - startTime;
+    if (result.ticks > 0 && simulation.GetPipeCount() > 0) {
+        result.activePipeFraction = activePipes / ((double)result.ticks * simulation.GetPipeCount());
+        result.lumpedPipeFraction = lumpedPipes / ((double)result.ticks * simulation.GetPipeCount());
+    }
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (telemetry.IsOpen()) {
+        simulation.SetTelemetry(nullptr);
+        if (!telemetry.Close()) {
+            result.error = "unable to write " + scenario.telemetryPath;
+        }
+        result.telemetryFrames = telemetry.GetRecordedFrames();
+        result.droppedTelemetryFrames = telemetry.GetDroppedFrames();
+    }
+    if (!scenario.checkpointPath.empty()) {
+        simulation.SaveCheckpoint(scenario.checkpointPath, result.error);
+    }
+    return result;
+}
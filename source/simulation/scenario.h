@@ -0,0 +1,123 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "network_simulation.h"
+
+#endif //SCENARIO_H
+
+enum ScenarioEventType {
+    SET_INLET_PRESSURE,
+    SET_OUTLET_PRESSURE,
+    SET_SIMULATION_MODE,
+    SET_PIPE_FIDELITY
+};
+
+struct ScenarioEvent {
+    double time = 0.0;
+    ScenarioEventType type = SET_INLET_PRESSURE;
+    int component = 0;
+    float value = 0.0f;
+    SimulationMode mode = TRANSIENT;
+    int pipe = -1;          //-1 for every pipe
+    PipeFidelity fidelity = RESOLVED_FIDELITY;
+};
+
+//a feed system and what happens to it, loaded from a text file with one statement per line ('#' starts a
+//comment, pressures are gauge pressures like in the editor):
+//
+//  ambient <pressure> <density>
+//  resolution <region size>
+//  sleep <tolerance>               residual below which pipes at rest are not stepped, 0 (the default) never
+//  fidelity resolved|lumped|adaptive   how the pipes are modelled (PipeNetwork), resolved by default
+//  friction <factor>               darcy friction factor of the pipe walls, 0 (the default) frictionless pipes
+//  tick <time>                     simulated time between event checks
+//  substeps <count>                most CFL sub steps per tick
+//  duration <time>
+//  output <interval>               time between result rows, 0 writes one per tick
+//  mode transient|steady|quasisteady
+//  species <name>                  a passive gas the pipes carry, before any component
+//  tank <name> [volume <v>] [amount <m>] [pressure <p>] [<species> <fraction> ...]
+//  pump <name> [inlet <p>] [outlet <p>] [maxflow <m>]
+//  engine <name> [pressure <p>] [mixture <ratio>] [throat <area>] [volume <v>]
+//  pipe <name> [radius <r>] [density <d>] [pressure <p>] [velocity <u>] [bevel <r>] path <x y z> <x y z> ...
+//  connect <pipe> start|end <component> [outlet]
+//  at <time> set <component> inlet|outlet|pressure <value>
+//  at <time> mode transient|steady|quasisteady
+//  at <time> fidelity <pipe>|all resolved|lumped|adaptive
+//  restore <path>                  start from a checkpoint instead of the initial state
+//  checkpoint <path>               write a checkpoint when the run ends
+//  telemetry <path>                record every pipe and component at every sub step (telemetry.h)
+//  combustion <path>|generated [bilinear|bicubic]  the table engines with a throat burn by (combustion_table.h)
+//
+//pipe ends that meet and are not connected to a component become junctions, like in the editor. an engine
+//with a throat burns what it is fed, its pressure is then where the chamber starts (NetworkSimulation), with
+//the generated combustion table unless a table file is given. checkpoint, telemetry and table paths are
+//relative to the scenario file. the corners of a pipe's path are bends, rounded by its bevel like the editor
+//rounds a control point's (sharp without one), which lose pressure once the pipes have friction. with species
+//everything starts out as the first one, a tank as the fractions it is given (normalised by their sum), and the
+//results and telemetry carry the composition of what reaches each engine.
+//
+//a restored run continues at the checkpoint's time with the checkpoint's layout, state and mode, the events
+//before that time are taken to have happened already. set points the scenario gives differently from the
+//scenario the checkpoint was written by are applied when it starts, so what-if runs fork from one warm state
+//by changing a pressure in the file (or with a sweep), and a changed fidelity is applied to every pipe the
+//same way. the components, pipes and species have to be the same
+struct Scenario {
+    NetworkLayout layout;
+    std::vector<std::string> componentNames;
+    std::vector<std::string> pipeNames;
+    std::vector<std::string> speciesNames;
+    std::vector<ScenarioEvent> events;      //in time order
+
+    SimulationMode mode = TRANSIENT;
+    double duration = 1.0;
+    double tickTime = 1.0 / 60.0;
+    double outputInterval = 0.0;
+    int maxSubSteps = 64;
+
+    std::string restorePath;
+    std::string checkpointPath;
+    std::string telemetryPath;
+    std::string combustionTablePath;        //empty for the generated table
+    CombustionInterpolation combustionInterpolation = BILINEAR_INTERPOLATION;
+};
+
+//false with a message naming the line when the file cannot be read or has an error
+bool LoadScenario(const std::string& path, Scenario& scenario, std::string& error);
+
+//sets one number of the scenario by name, "<component or pipe>.<property>" with the property names of the file
+//format (a species name for a tank's fraction of it), or ambient.pressure, ambient.density, pipes.friction and
+//gas.specificConstant (the gas constant of the working gas, which sets the ambient density at the simulation's
+//unit temperature). false for an unknown name
+bool SetScenarioParameter(Scenario& scenario, const std::string& name, float value);
+
+struct ScenarioResult {
+    double simulatedTime = 0.0;     //by this run, a restored run started at the checkpoint's time
+    double wallTime = 0.0;
+    int ticks = 0;
+    SimulationSnapshot finalState;
+
+    //sampled every output interval: the mass each engine took in and the highest pipe pressure
+    std::vector<double> engineDeliveredMasses;
+    float peakPipePressure = 0.0f;
+    double activePipeFraction = 1.0;    //of the pipes stepped resolved, averaged over the ticks
+    double lumpedPipeFraction = 0.0;
+
+    std::string error;      //set when the checkpoint could not be restored or written, or telemetry not recorded
+    unsigned long long telemetryFrames = 0;
+    unsigned long long droppedTelemetryFrames = 0;
+};
+
+//runs the scenario as fast as it goes. with an output stream, writes a csv row of the tanks, engines (mass flow
+//rate, thrust and the mass fraction of every species) and pipes every output interval (and at the start)
+ScenarioResult RunScenario(const Scenario& scenario, ThreadPool* threadPool, std::ostream* output);
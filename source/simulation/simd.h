@@ -0,0 +1,333 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RES_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RES_SIMD_SSE
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define RES_SIMD_NEON
+#endif
+
+#endif //SIMD_H
+
+//thin wrappers over the widest float/double vectors the build targets. every kernel in the simulation is written
+//against this interface once, and instantiated with either the native pack or the single lane fallback below
+//(which is also what handles the tail of each array)
+
+template<typename T>
+struct ScalarPack {
+    static constexpr int width = 1;
+    T v;
+
+    ScalarPack() = default;
+    ScalarPack(T value) : v(value) {};
+
+    static ScalarPack Load(const T* p) { return {*p}; }
+    void Store(T* p) const { *p = v; }
+
+    friend ScalarPack operator+(ScalarPack a, ScalarPack b) { return {a.v + b.v}; }
+    friend ScalarPack operator-(ScalarPack a, ScalarPack b) { return {a.v - b.v}; }
+    friend ScalarPack operator*(ScalarPack a, ScalarPack b) { return {a.v * b.v}; }
+    friend ScalarPack operator/(ScalarPack a, ScalarPack b) { return {a.v / b.v}; }
+
+    //masks are stored as packs so a single select works for every backend
+    friend ScalarPack GreaterEqual(ScalarPack a, ScalarPack b) { return {a.v >= b.v ? T(1) : T(0)}; }
+    friend ScalarPack LessEqual(ScalarPack a, ScalarPack b) { return {a.v <= b.v ? T(1) : T(0)}; }
+    friend ScalarPack Select(ScalarPack mask, ScalarPack a, ScalarPack b) { return {mask.v != T(0) ? a.v : b.v}; }
+
+    friend ScalarPack Sqrt(ScalarPack a) { return {std::sqrt(a.v)}; }
+    friend ScalarPack Abs(ScalarPack a) { return {std::abs(a.v)}; }
+    friend ScalarPack Min(ScalarPack a, ScalarPack b) { return {std::min(a.v, b.v)}; }
+    friend ScalarPack Max(ScalarPack a, ScalarPack b) { return {std::max(a.v, b.v)}; }
+    friend T ReduceMax(ScalarPack a) { return a.v; }
+};
+
+//maps a scalar type to its native pack, falling back to a single lane when the target has no vector unit
+template<typename T>
+struct SimdTraits {
+    using Pack = ScalarPack<T>;
+};
+
+template<typename T>
+using SimdPack = typename SimdTraits<T>::Pack;
+
+#if defined(RES_SIMD_AVX)
+
+struct PackF32 {
+    static constexpr int width = 8;
+    __m256 v;
+
+    PackF32() = default;
+    PackF32(__m256 value) : v(value) {};
+    PackF32(float value) : v(_mm256_set1_ps(value)) {};
+
+    static PackF32 Load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    void Store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    friend PackF32 operator+(PackF32 a, PackF32 b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend PackF32 operator-(PackF32 a, PackF32 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend PackF32 operator*(PackF32 a, PackF32 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend PackF32 operator/(PackF32 a, PackF32 b) { return {_mm256_div_ps(a.v, b.v)}; }
+
+    friend PackF32 GreaterEqual(PackF32 a, PackF32 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+    friend PackF32 LessEqual(PackF32 a, PackF32 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+    friend PackF32 Select(PackF32 mask, PackF32 a, PackF32 b) { return {_mm256_blendv_ps(b.v, a.v, mask.v)}; }
+
+    friend PackF32 Sqrt(PackF32 a) { return {_mm256_sqrt_ps(a.v)}; }
+    friend PackF32 Abs(PackF32 a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+    friend PackF32 Min(PackF32 a, PackF32 b) { return {_mm256_min_ps(a.v, b.v)}; }
+    friend PackF32 Max(PackF32 a, PackF32 b) { return {_mm256_max_ps(a.v, b.v)}; }
+    friend float ReduceMax(PackF32 a) {
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+};
+
+struct PackF64 {
+    static constexpr int width = 4;
+    __m256d v;
+
+    PackF64() = default;
+    PackF64(__m256d value) : v(value) {};
+    PackF64(double value) : v(_mm256_set1_pd(value)) {};
+
+    static PackF64 Load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    void Store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    friend PackF64 operator+(PackF64 a, PackF64 b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend PackF64 operator-(PackF64 a, PackF64 b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend PackF64 operator*(PackF64 a, PackF64 b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend PackF64 operator/(PackF64 a, PackF64 b) { return {_mm256_div_pd(a.v, b.v)}; }
+
+    friend PackF64 GreaterEqual(PackF64 a, PackF64 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)}; }
+    friend PackF64 LessEqual(PackF64 a, PackF64 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)}; }
+    friend PackF64 Select(PackF64 mask, PackF64 a, PackF64 b) { return {_mm256_blendv_pd(b.v, a.v, mask.v)}; }
+
+    friend PackF64 Sqrt(PackF64 a) { return {_mm256_sqrt_pd(a.v)}; }
+    friend PackF64 Abs(PackF64 a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+    friend PackF64 Min(PackF64 a, PackF64 b) { return {_mm256_min_pd(a.v, b.v)}; }
+    friend PackF64 Max(PackF64 a, PackF64 b) { return {_mm256_max_pd(a.v, b.v)}; }
+    friend double ReduceMax(PackF64 a) {
+        __m128d m = _mm_max_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+        m = _mm_max_sd(m, _mm_unpackhi_pd(m, m));
+        return _mm_cvtsd_f64(m);
+    }
+};
+
+#elif defined(RES_SIMD_SSE)
+
+struct PackF32 {
+    static constexpr int width = 4;
+    __m128 v;
+
+    PackF32() = default;
+    PackF32(__m128 value) : v(value) {};
+    PackF32(float value) : v(_mm_set1_ps(value)) {};
+
+    static PackF32 Load(const float* p) { return {_mm_loadu_ps(p)}; }
+    void Store(float* p) const { _mm_storeu_ps(p, v); }
+
+    friend PackF32 operator+(PackF32 a, PackF32 b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend PackF32 operator-(PackF32 a, PackF32 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend PackF32 operator*(PackF32 a, PackF32 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend PackF32 operator/(PackF32 a, PackF32 b) { return {_mm_div_ps(a.v, b.v)}; }
+
+    friend PackF32 GreaterEqual(PackF32 a, PackF32 b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+    friend PackF32 LessEqual(PackF32 a, PackF32 b) { return {_mm_cmple_ps(a.v, b.v)}; }
+    friend PackF32 Select(PackF32 mask, PackF32 a, PackF32 b) { return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+
+    friend PackF32 Sqrt(PackF32 a) { return {_mm_sqrt_ps(a.v)}; }
+    friend PackF32 Abs(PackF32 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+    friend PackF32 Min(PackF32 a, PackF32 b) { return {_mm_min_ps(a.v, b.v)}; }
+    friend PackF32 Max(PackF32 a, PackF32 b) { return {_mm_max_ps(a.v, b.v)}; }
+    friend float ReduceMax(PackF32 a) {
+        __m128 m = _mm_max_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+};
+
+struct PackF64 {
+    static constexpr int width = 2;
+    __m128d v;
+
+    PackF64() = default;
+    PackF64(__m128d value) : v(value) {};
+    PackF64(double value) : v(_mm_set1_pd(value)) {};
+
+    static PackF64 Load(const double* p) { return {_mm_loadu_pd(p)}; }
+    void Store(double* p) const { _mm_storeu_pd(p, v); }
+
+    friend PackF64 operator+(PackF64 a, PackF64 b) { return {_mm_add_pd(a.v, b.v)}; }
+    friend PackF64 operator-(PackF64 a, PackF64 b) { return {_mm_sub_pd(a.v, b.v)}; }
+    friend PackF64 operator*(PackF64 a, PackF64 b) { return {_mm_mul_pd(a.v, b.v)}; }
+    friend PackF64 operator/(PackF64 a, PackF64 b) { return {_mm_div_pd(a.v, b.v)}; }
+
+    friend PackF64 GreaterEqual(PackF64 a, PackF64 b) { return {_mm_cmpge_pd(a.v, b.v)}; }
+    friend PackF64 LessEqual(PackF64 a, PackF64 b) { return {_mm_cmple_pd(a.v, b.v)}; }
+    friend PackF64 Select(PackF64 mask, PackF64 a, PackF64 b) { return {_mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v))}; }
+
+    friend PackF64 Sqrt(PackF64 a) { return {_mm_sqrt_pd(a.v)}; }
+    friend PackF64 Abs(PackF64 a) { return {_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)}; }
+    friend PackF64 Min(PackF64 a, PackF64 b) { return {_mm_min_pd(a.v, b.v)}; }
+    friend PackF64 Max(PackF64 a, PackF64 b) { return {_mm_max_pd(a.v, b.v)}; }
+    friend double ReduceMax(PackF64 a) { return _mm_cvtsd_f64(_mm_max_sd(a.v, _mm_unpackhi_pd(a.v, a.v))); }
+};
+
+#elif defined(RES_SIMD_NEON)
+
+struct PackF32 {
+    static constexpr int width = 4;
+    float32x4_t v;
+
+    PackF32() = default;
+    PackF32(float32x4_t value) : v(value) {};
+    PackF32(float value) : v(vdupq_n_f32(value)) {};
+
+    static PackF32 Load(const float* p) { return {vld1q_f32(p)}; }
+    void Store(float* p) const { vst1q_f32(p, v); }
+
+    friend PackF32 operator+(PackF32 a, PackF32 b) { return {vaddq_f32(a.v, b.v)}; }
+    friend PackF32 operator-(PackF32 a, PackF32 b) { return {vsubq_f32(a.v, b.v)}; }
+    friend PackF32 operator*(PackF32 a, PackF32 b) { return {vmulq_f32(a.v, b.v)}; }
+    friend PackF32 operator/(PackF32 a, PackF32 b) { return {vdivq_f32(a.v, b.v)}; }
+
+    friend PackF32 GreaterEqual(PackF32 a, PackF32 b) { return {vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v))}; }
+    friend PackF32 LessEqual(PackF32 a, PackF32 b) { return {vreinterpretq_f32_u32(vcleq_f32(a.v, b.v))}; }
+    friend PackF32 Select(PackF32 mask, PackF32 a, PackF32 b) { return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)}; }
+
+    friend PackF32 Sqrt(PackF32 a) { return {vsqrtq_f32(a.v)}; }
+    friend PackF32 Abs(PackF32 a) { return {vabsq_f32(a.v)}; }
+    friend PackF32 Min(PackF32 a, PackF32 b) { return {vminq_f32(a.v, b.v)}; }
+    friend PackF32 Max(PackF32 a, PackF32 b) { return {vmaxq_f32(a.v, b.v)}; }
+    friend float ReduceMax(PackF32 a) { return vmaxvq_f32(a.v); }
+};
+
+struct PackF64 {
+    static constexpr int width = 2;
+    float64x2_t v;
+
+    PackF64() = default;
+    PackF64(float64x2_t value) : v(value) {};
+    PackF64(double value) : v(vdupq_n_f64(value)) {};
+
+    static PackF64 Load(const double* p) { return {vld1q_f64(p)}; }
+    void Store(double* p) const { vst1q_f64(p, v); }
+
+    friend PackF64 operator+(PackF64 a, PackF64 b) { return {vaddq_f64(a.v, b.v)}; }
+    friend PackF64 operator-(PackF64 a, PackF64 b) { return {vsubq_f64(a.v, b.v)}; }
+    friend PackF64 operator*(PackF64 a, PackF64 b) { return {vmulq_f64(a.v, b.v)}; }
+    friend PackF64 operator/(PackF64 a, PackF64 b) { return {vdivq_f64(a.v, b.v)}; }
+
+    friend PackF64 GreaterEqual(PackF64 a, PackF64 b) { return {vreinterpretq_f64_u64(vcgeq_f64(a.v, b.v))}; }
+    friend PackF64 LessEqual(PackF64 a, PackF64 b) { return {vreinterpretq_f64_u64(vcleq_f64(a.v, b.v))}; }
+    friend PackF64 Select(PackF64 mask, PackF64 a, PackF64 b) { return {vbslq_f64(vreinterpretq_u64_f64(mask.v), a.v, b.v)}; }
+
+    friend PackF64 Sqrt(PackF64 a) { return {vsqrtq_f64(a.v)}; }
+    friend PackF64 Abs(PackF64 a) { return {vabsq_f64(a.v)}; }
+    friend PackF64 Min(PackF64 a, PackF64 b) { return {vminq_f64(a.v, b.v)}; }
+    friend PackF64 Max(PackF64 a, PackF64 b) { return {vmaxq_f64(a.v, b.v)}; }
+    friend double ReduceMax(PackF64 a) { return vmaxvq_f64(a.v); }
+};
+
+#endif
+
+#if defined(RES_SIMD_AVX) || defined(RES_SIMD_SSE) || defined(RES_SIMD_NEON)
+
+template<>
+struct SimdTraits<float> {
+    using Pack = PackF32;
+};
+
+template<>
+struct SimdTraits<double> {
+    using Pack = PackF64;
+};
+
+#endif
+
+//linear interpolation in uniformly spaced tables at fractional positions (index + fraction), which have to be
+//clamped to [0, last point] with the table holding one more entry past it. two tables sampled on the same grid
+//can be read with the index worked out once. a lane at a time on the fallback, two gathers per table on AVX2
+template<typename P, typename T>
+P InterpolateTable(const T* table, P position) {
+    T lanes[P::width];
+    position.Store(lanes);
+    for (int i = 0; i < P::width; i++) {
+        int index = lanes[i] >= T(0) ? (int)lanes[i] : 0;
+        lanes[i] = table[index] + (lanes[i] - (T)index) * (table[index + 1] - table[index]);
+    }
+    return P::Load(lanes);
+}
+
+template<typename P, typename T>
+void InterpolateTables(const T* first, const T* second, P position, P& firstValue, P& secondValue) {
+    T lanes[P::width], values[P::width];
+    position.Store(lanes);
+    for (int i = 0; i < P::width; i++) {
+        int index = lanes[i] >= T(0) ? (int)lanes[i] : 0;
+        T fraction = lanes[i] - (T)index;
+        lanes[i] = first[index] + fraction * (first[index + 1] - first[index]);
+        values[i] = second[index] + fraction * (second[index + 1] - second[index]);
+    }
+    firstValue = P::Load(lanes);
+    secondValue = P::Load(values);
+}
+
+#if defined(RES_SIMD_AVX) && defined(__AVX2__)
+
+inline PackF32 GatherInterpolate(const float* table, __m256i index, __m256 fraction) {
+    __m256 a = _mm256_i32gather_ps(table, index, 4);
+    __m256 b = _mm256_i32gather_ps(table + 1, index, 4);
+    return {_mm256_add_ps(a, _mm256_mul_ps(fraction, _mm256_sub_ps(b, a)))};
+}
+
+inline PackF64 GatherInterpolate(const double* table, __m128i index, __m256d fraction) {
+    //the masked form with a zero source and every lane on, the plain one leaves its source undefined and gcc
+    //warns about it at every inlined call
+    __m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    __m256d a = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table, index, mask, 8);
+    __m256d b = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table + 1, index, mask, 8);
+    return {_mm256_add_pd(a, _mm256_mul_pd(fraction, _mm256_sub_pd(b, a)))};
+}
+
+inline PackF32 InterpolateTable(const float* table, PackF32 position) {
+    __m256i index = _mm256_cvttps_epi32(position.v);
+    return GatherInterpolate(table, index, _mm256_sub_ps(position.v, _mm256_cvtepi32_ps(index)));
+}
+
+inline PackF64 InterpolateTable(const double* table, PackF64 position) {
+    __m128i index = _mm256_cvttpd_epi32(position.v);
+    return GatherInterpolate(table, index, _mm256_sub_pd(position.v, _mm256_cvtepi32_pd(index)));
+}
+
+inline void InterpolateTables(const float* first, const float* second, PackF32 position, PackF32& firstValue, PackF32& secondValue) {
+    __m256i index = _mm256_cvttps_epi32(position.v);
+    __m256 fraction = _mm256_sub_ps(position.v, _mm256_cvtepi32_ps(index));
+    firstValue = GatherInterpolate(first, index, fraction);
+    secondValue = GatherInterpolate(second, index, fraction);
+}
+
+inline void InterpolateTables(const double* first, const double* second, PackF64 position, PackF64& firstValue, PackF64& secondValue) {
+    __m128i index = _mm256_cvttpd_epi32(position.v);
+    __m256d fraction = _mm256_sub_pd(position.v, _mm256_cvtepi32_pd(index));
+    firstValue = GatherInterpolate(first, index, fraction);
+    secondValue = GatherInterpolate(second, index, fraction);
+}
+
+#endif
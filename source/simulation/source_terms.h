@@ -0,0 +1,76 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef SOURCE_TERMS_H
+#define SOURCE_TERMS_H
+
+#include "equation_of_state.h"
+#include "simd.h"
+
+#endif //SOURCE_TERMS_H
+
+//the source terms of quasi-1D pipe flow, which BasicGasSimulation splits from the flux update (half of the step
+//on either side of it, Strang splitting). each region is independent of its neighbours, so the kernel streams
+//whole packs of regions like the flux kernels, with the gas as an equation of state policy (equation_of_state.h).
+//over a step dt every region in [begin, end) takes, in order:
+//  the area change, -(dA/dx / A) (rho u, rho u^2, u (E + p)), explicitly
+//  the wall friction and fitting losses, d(rho u)/dt = -k rho u |u|, integrated exactly at its density. the
+//  kinetic energy they take is dissipated into the gas, so the total energy is left alone
+//  heat exchanged with walls at wallTemperature (p / rho units) at the rate h |u| cp / cv, implicitly so it
+//  settles at the wall temperature instead of overshooting it. a wall temperature of 0 keeps the walls adiabatic
+//and the primitives of the result are written along with it, saving the sweep to update them
+template<typename Real, typename Eos>
+void ApplySourceTerms(Real* density, Real* momentum, Real* energy, Real* velocity, Real* pressure,
+                      const Real* areaGradient, const Real* lossCoefficient, const Real* heatTransferCoefficient,
+                      Real wallTemperature, int begin, int end, Real dt, const Eos& eos) {
+    bool heatTransfer = wallTemperature > Real(0);
+    auto region = [&](auto pack, int i) {
+        using P = decltype(pack);
+        P one = Real(1);
+        P half = Real(0.5);
+        P rho = P::Load(density + i);
+        P m = P::Load(momentum + i);
+        P E = P::Load(energy + i);
+        P u = m / rho;
+        P p = eos.Pressure(rho, E - half * m * u);
+
+        P area = P(dt) * P::Load(areaGradient + i);
+        rho = rho - area * m;
+        E = E - area * u * (E + p);
+        m = m - area * m * u;
+
+        m = m / (one + P(dt) * P::Load(lossCoefficient + i) * Abs(m) / rho);
+
+        u = m / rho;
+        P kineticEnergy = half * m * u;
+        p = eos.Pressure(rho, E - kineticEnergy);
+        if (heatTransfer) {
+            P temperature = eos.Temperature(rho, p);
+            P rate = P(dt) * P::Load(heatTransferCoefficient + i) * Abs(u) * eos.EnergyGamma(rho, E - kineticEnergy, p);
+            P relaxed = (temperature + rate * P(wallTemperature)) / (one + rate);
+            //at a fixed density the pressure of either gas is proportional to the temperature
+            E = eos.InternalEnergy(rho, p * relaxed / temperature) + kineticEnergy;
+            p = eos.Pressure(rho, E - kineticEnergy);
+        }
+
+        rho.Store(density + i);
+        m.Store(momentum + i);
+        E.Store(energy + i);
+        u.Store(velocity + i);
+        p.Store(pressure + i);
+    };
+
+    using Pack = SimdPack<Real>;
+    using Lane = ScalarPack<Real>;
+
+    int i = begin;
+    for (; i + Pack::width <= end; i += Pack::width) {
+        region(Pack(), i);
+    }
+    for (; i < end; i++) {
+        region(Lane(), i);
+    }
+}
@@ -0,0 +1,529 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "steady_network.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+int SteadyNetworkSolver::AddNode(double pressure, bool fixed) {
+    m_pressures.push_back(pressure);
+    m_temperatures.push_back(gasConstantTemperature);
+    m_fixed.push_back(fixed);
+    m_compiled = false;
+    return (int)m_pressures.size() - 1;
+}
+
+int SteadyNetworkSolver::AddPipe(int from, int to, double length, double diameter, double frictionFactor, double fittingLoss) {
+    m_types.push_back(PIPE_EDGE);
+    m_from.push_back(from);
+    m_to.push_back(to);
+    m_lengths.push_back(length);
+    m_diameters.push_back(diameter);
+    m_frictionFactors.push_back(frictionFactor);
+    m_fittingLosses.push_back(fittingLoss);
+    m_shutoffRises.push_back(0.0);
+    m_maxMassFlowRates.push_back(0.0);
+    m_designDensities.push_back(0.0);
+    m_massFlowRates.push_back(0.0);
+    m_compiled = false;
+    return (int)m_types.size() - 1;
+}
+
+int SteadyNetworkSolver::AddPump(int inlet, int outlet, double shutoffRise, double maxMassFlowRate, double designDensity) {
+    m_types.push_back(PUMP_EDGE);
+    m_from.push_back(inlet);
+    m_to.push_back(outlet);
+    m_lengths.push_back(0.0);
+    m_diameters.push_back(0.0);
+    m_frictionFactors.push_back(0.0);
+    m_fittingLosses.push_back(0.0);
+    m_shutoffRises.push_back(shutoffRise);
+    m_maxMassFlowRates.push_back(maxMassFlowRate);
+    m_designDensities.push_back(designDensity);
+    m_massFlowRates.push_back(0.0);
+    m_compiled = false;
+    return (int)m_types.size() - 1;
+}
+
+void SteadyNetworkSolver::Compile() {
+    int nodeCount = GetNodeCount();
+    int edgeCount = GetEdgeCount();
+
+    //a free node only has a defined pressure when its part of the graph reaches a fixed node
+    std::vector<int> parents(nodeCount);
+    std::iota(parents.begin(), parents.end(), 0);
+    auto find = [&parents](int node) {
+        while (parents[node] != node) {
+            parents[node] = parents[parents[node]];
+            node = parents[node];
+        }
+        return node;
+    };
+    for (int e = 0; e < edgeCount; e++) {
+        parents[find(m_from[e])] = find(m_to[e]);
+    }
+    std::vector<bool> anchored(nodeCount, false);
+    for (int n = 0; n < nodeCount; n++) {
+        if (m_fixed[n]) {
+            anchored[find(n)] = true;
+        }
+    }
+
+    m_unknowns.assign(nodeCount, -1);
+    int unknownCount = 0;
+    for (int n = 0; n < nodeCount; n++) {
+        if (!m_fixed[n] && anchored[find(n)]) {
+            m_unknowns[n] = unknownCount++;
+        }
+    }
+
+    //one off diagonal entry per edge end, parallel edges simply get an entry each
+    m_rowStarts.assign(unknownCount + 1, 0);
+    for (int e = 0; e < edgeCount; e++) {
+        int a = m_unknowns[m_from[e]], b = m_unknowns[m_to[e]];
+        if (a >= 0 && b >= 0) {
+            m_rowStarts[a + 1]++;
+            m_rowStarts[b + 1]++;
+        }
+    }
+    for (int row = 0; row < unknownCount; row++) {
+        m_rowStarts[row + 1] += m_rowStarts[row];
+    }
+
+    std::vector<int> fill(m_rowStarts.begin(), m_rowStarts.end() - 1);
+    m_columns.resize(m_rowStarts[unknownCount]);
+    m_values.resize(m_rowStarts[unknownCount]);
+    m_edgeEntries.assign(2 * edgeCount, -1);
+    for (int e = 0; e < edgeCount; e++) {
+        int a = m_unknowns[m_from[e]], b = m_unknowns[m_to[e]];
+        if (a >= 0 && b >= 0) {
+            m_edgeEntries[2 * e] = fill[a];
+            m_columns[fill[a]++] = b;
+            m_edgeEntries[2 * e + 1] = fill[b];
+            m_columns[fill[b]++] = a;
+        }
+    }
+
+    m_diagonal.resize(unknownCount);
+    m_rhs.resize(unknownCount);
+    m_solution.resize(unknownCount);
+    m_residual.resize(unknownCount);
+    m_direction.resize(unknownCount);
+    m_preconditioned.resize(unknownCount);
+    m_product.resize(unknownCount);
+    m_conductances.resize(edgeCount);
+    m_offsets.resize(edgeCount);
+    m_nodeInflows.resize(nodeCount);
+    m_nodeInflowTemperatures.resize(nodeCount);
+    m_compiled = true;
+}
+
+double SteadyNetworkSolver::GetArrivalTemperature(int edge) const {
+    int from = m_from[edge], to = m_to[edge];
+    double temperature = m_massFlowRates[edge] < 0.0 ? m_temperatures[to] : m_temperatures[from];
+    if (m_types[edge] == PUMP_EDGE) {
+        if (m_massFlowRates[edge] < 0.0) {
+            return temperature;
+        }
+        double ratio = std::max(m_pressures[to], 1e-6) / std::max(m_pressures[from], 1e-6);
+        return temperature * std::pow(ratio, (gamma - 1.0) / gamma);
+    }
+    //the transient walls heat the gas at the rate h |u| cp (T_wall - T) with h = f / (2 D), which carried along
+    //the pipe moves the total enthalpy by a fixed fraction of the difference over its length whatever the flow
+    if (wallTemperature > 0.0 && m_frictionFactors[edge] > 0.0) {
+        double transfer = m_frictionFactors[edge] * m_lengths[edge] / (2.0 * m_diameters[edge]);
+        temperature = wallTemperature + (temperature - wallTemperature) * std::exp(-transfer);
+    }
+    return temperature;
+}
+
+void SteadyNetworkSolver::UpdateTemperatures() {
+    //carried downstream by the current flows, a pass per node along the longest path it takes to settle
+    int nodeCount = GetNodeCount();
+    for (int pass = 0; pass < nodeCount; pass++) {
+        std::fill(m_nodeInflows.begin(), m_nodeInflows.end(), 0.0);
+        std::fill(m_nodeInflowTemperatures.begin(), m_nodeInflowTemperatures.end(), 0.0);
+        for (int e = 0; e < GetEdgeCount(); e++) {
+            double m = m_massFlowRates[e];
+            int node = m >= 0.0 ? m_to[e] : m_from[e];
+            m_nodeInflows[node] += std::abs(m);
+            m_nodeInflowTemperatures[node] += std::abs(m) * GetArrivalTemperature(e);
+        }
+
+        bool settled = true;
+        for (int n = 0; n < nodeCount; n++) {
+            if (m_fixed[n] || !(m_nodeInflows[n] > 0.0)) {
+                continue;
+            }
+            double temperature = m_nodeInflowTemperatures[n] / m_nodeInflows[n];
+            settled = settled && std::abs(temperature - m_temperatures[n]) <= 1e-12 * temperature;
+            m_temperatures[n] = temperature;
+        }
+        if (settled) {
+            break;
+        }
+    }
+}
+
+void SteadyNetworkSolver::EvaluateEdge(int edge, double& drop, double& derivative) const {
+    //in squared pressures: drop and derivative are those of p_from^2 - p_to^2 against the flow
+    double m = m_massFlowRates[edge];
+    //an overshooting newton step can leave an end below zero, it is then taken at a small positive pressure
+    double from = std::max(m_pressures[m_from[edge]], 1e-6), to = std::max(m_pressures[m_to[edge]], 1e-6);
+
+    if (m_types[edge] == PUMP_EDGE) {
+        //the head curve continues through zero, so reverse flow meets a rising resistance. the slope is kept
+        //away from zero, newton then takes a few more steps near shutoff instead of dividing by nothing
+        double maxFlow = m_maxMassFlowRates[edge];
+        bool scaled = m_designDensities[edge] > 0.0;
+        double shutoffRise = m_shutoffRises[edge] * (scaled ? from / (m_temperatures[m_from[edge]] * m_designDensities[edge]) : 1.0);
+        double rise = shutoffRise * (1.0 - m * std::abs(m) / (maxFlow * maxFlow));
+        double slope = std::max(2.0 * shutoffRise * std::abs(m) / (maxFlow * maxFlow), 1e-2 * shutoffRise / maxFlow);
+
+        //the rise is between the pressures, p_to - p_from = rise, which is p_to + p_from times it in squared
+        //pressures. the weight it is taken at is what a change of the free end's squared pressure moves the
+        //pressure difference by: exact newton against a fixed end, lagged between two free ones
+        double weight = from + to;
+        if (m_fixed[m_from[edge]] && !m_fixed[m_to[edge]]) {
+            weight = 2.0 * to;
+        }
+        else if (m_fixed[m_to[edge]] && !m_fixed[m_from[edge]]) {
+            weight = 2.0 * from / (1.0 + (scaled ? rise / from : 0.0));
+        }
+        drop = from * from - to * to + weight * (to - from - rise);
+        derivative = weight * slope;
+        return;
+    }
+
+    double diameter = m_diameters[edge];
+    double length = m_lengths[edge];
+    double area = 0.25 * M_PI * diameter * diameter;
+
+    //the gas leaves the higher pressure end's plenum with the isentropic flow of the pressure ratio r. written as
+    //a loss of K dynamic pressures at the density that carries it, (p_up^2 - p_down^2) psi(r) = K R T m^2 / (2 A^2)
+    //with psi = phi / (1 + r), and phi the ratio of the isentropic flow to the incompressible flow of the same
+    //ratio. psi only runs from 1/2 at rest to about 1/3 at choking, so the law is close to that of a liquid in
+    //the squared pressures, which is what newton steps in
+    bool forward = from >= to;
+    double total = std::max(from, to);
+    double temperature = m_temperatures[forward ? m_from[edge] : m_to[edge]];
+    if (wallTemperature > 0.0 && m_frictionFactors[edge] > 0.0) {
+        //the gas cools (or heats) towards the walls along the way, the losses are taken at its mean temperature
+        double transfer = m_frictionFactors[edge] * m_lengths[edge] / (2.0 * diameter);
+        temperature = wallTemperature + (temperature - wallTemperature) * (1.0 - std::exp(-transfer)) / transfer;
+    }
+    double critical = std::pow(2.0 / (gamma + 1.0), gamma / (gamma - 1.0));
+    double ratio = std::max(std::min(from, to) / total, critical);
+    double phi = 1.0 - 1.5 * (1.0 - ratio) / gamma;
+    if (ratio < 1.0 - 1e-4) {
+        double k = gamma / (gamma - 1.0);
+        phi = k * (std::pow(ratio, 2.0 / gamma) - std::pow(ratio, (gamma + 1.0) / gamma)) / (1.0 - ratio);
+    }
+    double scale = temperature * (1.0 + ratio) / phi;
+
+    //the exit and the fittings lose K dynamic pressures whatever the reynolds number. only the exit loss is taken
+    //at the density of the isentropic flow, the fittings and friction lose along the pipe at its own density
+    //like in isothermal pipe flow, p_a^2 - p_b^2 = K R T m^2 / A^2, which is psi = 1/2 at every ratio
+    double along = 2.0 * phi / (1.0 + ratio);
+    double fitting = (1.0 + along * m_fittingLosses[edge]) / (2.0 * area * area);
+
+    double friction = m_frictionFactors[edge];
+    double slope = 0.0;
+    bool laminar = false;
+    if (friction < 0.0) {
+        //the larger of the laminar and Swamee-Jain friction factors, continuous through the transition (near Re
+        //1000 for smooth pipes). far below its range Swamee-Jain has a pole, so it is not looked at under Re 500.
+        //Swamee-Jain falls slowly with Re (slope is Re df/dRe), its slope is part of the derivative so newton
+        //keeps its quadratic rate
+        double reynolds = std::abs(m) * diameter / (area * viscosity);
+        double turbulent = 0.0;
+        if (reynolds > 500.0) {
+            double viscousTerm = 5.74 / std::pow(reynolds, 0.9);
+            double logTerm = std::log10(roughness / (3.7 * diameter) + viscousTerm);
+            turbulent = 0.25 / (logTerm * logTerm);
+            slope = 0.5 / (logTerm * logTerm * logTerm) * 0.9 * viscousTerm / ((roughness / (3.7 * diameter) + viscousTerm) * std::log(10.0));
+        }
+        laminar = reynolds <= 500.0 || 64.0 / reynolds >= turbulent;
+        friction = laminar ? 64.0 / std::max(reynolds, 1e-30) : turbulent;
+    }
+
+    double coefficient = along * length / (diameter * 2.0 * area * area);
+    if (laminar) {
+        double resistance = along * 32.0 * viscosity * length / (area * diameter * diameter);
+        drop = scale * (resistance * m + fitting * m * std::abs(m));
+        derivative = scale * (resistance + 2.0 * fitting * std::abs(m));
+    }
+    else {
+        //a quadratic loss has no slope at rest, below a thousandth of the flow scale of the pipe it is rounded
+        //off to a linear one so newton can start from there
+        double rounding = 1e-3 * area * total / std::sqrt(temperature);
+        double magnitude = std::sqrt(m * m + rounding * rounding);
+        drop = scale * (coefficient * friction + fitting) * m * magnitude;
+        derivative = scale * ((coefficient * friction + fitting) * (magnitude + m * m / magnitude) + coefficient * std::abs(m) * slope);
+    }
+
+    //choked, the flow is that of the critical ratio, proportional to the upstream pressure and no longer moved
+    //by the downstream one. the drop is what the ends hold plus the slope of that flow against the upstream
+    //squared pressure, taken for the difference: exact newton into a fixed pressure (an engine chamber), lagged
+    //into a free one
+    if (std::min(from, to) < critical * total) {
+        double squaredDrop = total * total * (1.0 - critical * critical);
+        double chokedFlow = std::sqrt(squaredDrop / (scale * (coefficient * friction + fitting))) * (forward ? 1.0 : -1.0);
+        derivative = 2.0 * total * total / std::abs(chokedFlow);
+        if (m_fixed[forward ? m_from[edge] : m_to[edge]]) {
+            derivative *= 1e6;
+        }
+        drop = from * from - to * to + derivative * (m - chokedFlow);
+    }
+}
+
+int SteadyNetworkSolver::SolveLinearSystem(double tolerance) {
+    int n = (int)m_rhs.size();
+    auto multiply = [&](const std::vector<double>& x, std::vector<double>& y) {
+        for (int row = 0; row < n; row++) {
+            double sum = m_diagonal[row] * x[row];
+            for (int k = m_rowStarts[row]; k < m_rowStarts[row + 1]; k++) {
+                sum += m_values[k] * x[m_columns[k]];
+            }
+            y[row] = sum;
+        }
+    };
+
+    //the current pressures are the initial guess
+    multiply(m_solution, m_product);
+    double initialNorm = 0.0;
+    double rz = 0.0;
+    for (int i = 0; i < n; i++) {
+        m_residual[i] = m_rhs[i] - m_product[i];
+        m_preconditioned[i] = m_residual[i] / m_diagonal[i];
+        m_direction[i] = m_preconditioned[i];
+        rz += m_residual[i] * m_preconditioned[i];
+        initialNorm = std::max(initialNorm, std::abs(m_residual[i]));
+    }
+
+    int iteration = 0;
+    for (; iteration < 2 * n + 20; iteration++) {
+        double residualNorm = 0.0;
+        for (int i = 0; i < n; i++) {
+            residualNorm = std::max(residualNorm, std::abs(m_residual[i]));
+        }
+        if (residualNorm <= std::max(tolerance, 1e-14 * initialNorm) || rz == 0.0) {
+            break;
+        }
+
+        multiply(m_direction, m_product);
+        double dAd = 0.0;
+        for (int i = 0; i < n; i++) {
+            dAd += m_direction[i] * m_product[i];
+        }
+        double alpha = rz / dAd;
+
+        double nextRz = 0.0;
+        for (int i = 0; i < n; i++) {
+            m_solution[i] += alpha * m_direction[i];
+            m_residual[i] -= alpha * m_product[i];
+            m_preconditioned[i] = m_residual[i] / m_diagonal[i];
+            nextRz += m_residual[i] * m_preconditioned[i];
+        }
+        double beta = nextRz / rz;
+        rz = nextRz;
+        for (int i = 0; i < n; i++) {
+            m_direction[i] = m_preconditioned[i] + beta * m_direction[i];
+        }
+    }
+    return iteration;
+}
+
+double SteadyNetworkSolver::Linearise(double& flowScale) {
+    //m(p) = offset + conductance (p_from - p_to) around the current flows, and how far the flows are from
+    //satisfying their pressure drop, in units of flow
+    UpdateTemperatures();
+    double flowError = 0.0;
+    flowScale = 1e-30;
+    for (int e = 0; e < GetEdgeCount(); e++) {
+        double drop, derivative;
+        EvaluateEdge(e, drop, derivative);
+        double conductance = 1.0 / derivative;
+        m_conductances[e] = conductance;
+        m_offsets[e] = m_massFlowRates[e] - drop * conductance;
+
+        if (m_fixed[m_from[e]] || m_unknowns[m_from[e]] >= 0) {
+            double mismatch = (GetSquaredPressure(m_from[e]) - GetSquaredPressure(m_to[e]) - drop) * conductance;
+            if (!(std::abs(mismatch) <= flowError)) {
+                flowError = std::abs(mismatch);     //also takes a nan, std::max would drop it
+            }
+            flowScale = std::max(flowScale, std::abs(m_massFlowRates[e]));
+        }
+    }
+
+    //and how far the free nodes are from balancing, after a step that was limited
+    std::fill(m_nodeInflows.begin(), m_nodeInflows.end(), 0.0);
+    for (int e = 0; e < GetEdgeCount(); e++) {
+        m_nodeInflows[m_to[e]] += m_massFlowRates[e];
+        m_nodeInflows[m_from[e]] -= m_massFlowRates[e];
+    }
+    for (int node = 0; node < GetNodeCount(); node++) {
+        if (m_unknowns[node] >= 0 && !(std::abs(m_nodeInflows[node]) <= flowError)) {
+            flowError = std::abs(m_nodeInflows[node]);
+        }
+    }
+    return std::isfinite(flowError) ? flowError : std::numeric_limits<double>::infinity();
+}
+
+SteadySolveResult SteadyNetworkSolver::Solve() {
+    if (!m_compiled) {
+        Compile();
+    }
+    int edgeCount = GetEdgeCount();
+    int nodeCount = GetNodeCount();
+
+    //edges of parts without a fixed pressure carry nothing
+    for (int e = 0; e < edgeCount; e++) {
+        if (!m_fixed[m_from[e]] && m_unknowns[m_from[e]] < 0) {
+            m_massFlowRates[e] = 0.0;
+        }
+    }
+
+    double highestPressure = 0.0;
+    for (int node = 0; node < nodeCount; node++) {
+        if (m_fixed[node]) {
+            highestPressure = std::max(highestPressure, GetSquaredPressure(node));
+        }
+    }
+
+    m_startPressures = m_pressures;
+    m_startFlows = m_massFlowRates;
+    m_startTemperatures = m_temperatures;
+
+    SteadySolveResult result;
+    double flowScale;
+    double flowError = Linearise(flowScale);
+    for (; result.iterations < maxIterations && flowError > tolerance * flowScale; result.iterations++) {
+        //mass balance of every free node with the flows eliminated
+        std::fill(m_diagonal.begin(), m_diagonal.end(), 0.0);
+        std::fill(m_rhs.begin(), m_rhs.end(), 0.0);
+        for (int e = 0; e < edgeCount; e++) {
+            int a = m_unknowns[m_from[e]], b = m_unknowns[m_to[e]];
+            double g = m_conductances[e], c = m_offsets[e];
+            if (a >= 0) {
+                m_diagonal[a] += g;
+                m_rhs[a] -= c;
+                if (b >= 0) {
+                    m_values[m_edgeEntries[2 * e]] = -g;
+                }
+                else {
+                    m_rhs[a] += g * GetSquaredPressure(m_to[e]);
+                }
+            }
+            if (b >= 0) {
+                m_diagonal[b] += g;
+                m_rhs[b] += c;
+                if (a >= 0) {
+                    m_values[m_edgeEntries[2 * e + 1]] = -g;
+                }
+                else {
+                    m_rhs[b] += g * GetSquaredPressure(m_from[e]);
+                }
+            }
+        }
+
+        for (int node = 0; node < nodeCount; node++) {
+            if (m_unknowns[node] >= 0) {
+                m_solution[m_unknowns[node]] = GetSquaredPressure(node);
+            }
+        }
+        //the mass balance is solved well below the tolerance on the flows. a balance left off by the linear
+        //solve would not be seen by the flow error and is never made up by the later steps
+        result.linearIterations += SolveLinearSystem(1e-3 * tolerance * flowScale);
+
+        //the full step, halved while it blows the error up (far from the solution, where pipes switch between
+        //laminar and turbulent or choke). the lagged temperatures keep the error from falling every step even when
+        //converging, so only a clear increase counts. the step is also cut back so that no pressure is taken more
+        //than a factor of 4 away (squared, 2 in pressure), or up by more than a hundredth of the highest fixed one
+        //from near vacuum: the flows of a cold start are far off and so are the pressures newton extrapolates from
+        //them, but what a gas flow owes to the level of its pressures (densities, pumps, compression) only holds
+        //near the current ones. the mass balance is linear, so every partial step still conserves mass
+        double fraction = 1.0;
+        for (int node = 0; node < nodeCount; node++) {
+            int unknown = m_unknowns[node];
+            if (unknown >= 0) {
+                double current = GetSquaredPressure(node), next = m_solution[unknown];
+                double ceiling = 4.0 * std::max(current, 1e-2 * highestPressure);
+                if (next < 0.25 * current) {
+                    fraction = std::min(fraction, 0.75 * current / (current - next));
+                }
+                else if (next > ceiling) {
+                    fraction = std::min(fraction, (ceiling - current) / (next - current));
+                }
+            }
+        }
+
+        m_previousPressures = m_pressures;
+        m_previousFlows = m_massFlowRates;
+        for (int e = 0; e < edgeCount; e++) {
+            int from = m_unknowns[m_from[e]], to = m_unknowns[m_to[e]];
+            if (m_fixed[m_from[e]] || from >= 0) {
+                double squaredFrom = from >= 0 ? m_solution[from] : GetSquaredPressure(m_from[e]);
+                double squaredTo = to >= 0 ? m_solution[to] : GetSquaredPressure(m_to[e]);
+                double flow = m_offsets[e] + m_conductances[e] * (squaredFrom - squaredTo);
+                m_massFlowRates[e] += fraction * (flow - m_massFlowRates[e]);
+            }
+        }
+        for (int node = 0; node < nodeCount; node++) {
+            if (m_unknowns[node] >= 0) {
+                double squared = GetSquaredPressure(node);
+                m_pressures[node] = std::sqrt(std::max(squared + fraction * (m_solution[m_unknowns[node]] - squared), 1e-12));
+            }
+        }
+
+        double previousError = flowError;
+        flowError = Linearise(flowScale);
+        for (int halving = 0; halving < 10 && flowError > 4.0 * previousError; halving++) {
+            for (int node = 0; node < nodeCount; node++) {
+                m_pressures[node] = 0.5 * (m_pressures[node] + m_previousPressures[node]);
+            }
+            for (int e = 0; e < edgeCount; e++) {
+                m_massFlowRates[e] = 0.5 * (m_massFlowRates[e] + m_previousFlows[e]);
+            }
+            flowError = Linearise(flowScale);
+        }
+    }
+
+    result.converged = flowError <= tolerance * flowScale;
+    result.residual = flowError;
+    if (!result.converged) {
+        m_pressures.swap(m_startPressures);
+        m_massFlowRates.swap(m_startFlows);
+        m_temperatures.swap(m_startTemperatures);
+    }
+    return result;
+}
+
+double SteadyNetworkSolver::GetNodeInflow(int node) const {
+    double inflow = 0.0;
+    for (int e = 0; e < GetEdgeCount(); e++) {
+        if (m_to[e] == node) {
+            inflow += m_massFlowRates[e];
+        }
+        if (m_from[e] == node) {
+            inflow -= m_massFlowRates[e];
+        }
+    }
+    return inflow;
+}
+
+double SteadyNetworkSolver::GetInflowTemperature(int node) const {
+    double inflow = 0.0, enthalpy = 0.0;
+    for (int e = 0; e < GetEdgeCount(); e++) {
+        double m = m_massFlowRates[e];
+        if ((m > 0.0 && m_to[e] == node) || (m < 0.0 && m_from[e] == node)) {
+            inflow += std::abs(m);
+            enthalpy += std::abs(m) * GetArrivalTemperature(e);
+        }
+    }
+    return inflow > 0.0 ? enthalpy / inflow : m_temperatures[node];
+}
@@ -0,0 +1,127 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef STEADY_NETWORK_H
+#define STEADY_NETWORK_H
+
+#include <vector>
+
+#endif //STEADY_NETWORK_H
+
+enum SteadyEdgeType {
+    PIPE_EDGE,
+    PUMP_EDGE
+};
+
+struct SteadySolveResult {
+    bool converged = false;
+    int iterations = 0;
+    int linearIterations = 0;   //conjugate gradient iterations over all newton steps
+    double residual = 0.0;      //largest flow error of an edge against its pressure drop
+};
+
+//operating point of a pipe network, without the transient. pipes and pumps are the edges of a graph whose nodes
+//are either held at a fixed pressure (tanks, engine chambers) or free (junctions, pump sides, closed ends).
+//the mass flows of the edges and the free pressures are solved together with newton's method in the global
+//gradient form: every step eliminates the flows and leaves a symmetric positive definite, laplacian-like
+//system in the squared free pressures, solved with jacobi preconditioned conjugate gradients on a sparse matrix
+//whose structure is built once per graph. a gas pipe's drop is close to quadratic in the flow in squared
+//pressures, like a liquid pipe's in pressures, which keeps newton's steps long from a cold start.
+//
+//the nodes are plenums like in PipeNetwork: gas flows into a pipe from the total state of its upstream node and
+//leaves it at the static pressure of the downstream one, dumping its dynamic pressure there. a pipe loses
+//K rho u^2 / 2 at its end pressure ratio, with K one exit loss plus its fittings (the bends of the layout) and
+//Darcy-Weisbach friction f L / D, and the density the one that makes a frictionless pipe carry the isentropic flow of the ratio. below
+//the critical ratio the pipe is choked and carries the flow of the critical ratio whatever is downstream. the
+//friction factor is fixed per pipe like the transient pipes take it, or taken from the reynolds number:
+//laminar below Re 2300 and the Swamee-Jain approximation of Colebrook above it. pumps follow the head curve
+//rise = shutoffRise (1 - (m / maxFlow)^2), scaled by the density they are fed like the transient pumps.
+//fixed nodes have the temperature they are given, free ones the mixed temperature of the gas flowing into
+//them, compressed isentropically by pumps and exchanging heat with the walls of pipes with friction like the
+//transient pipes (adiabatic without a wall temperature). what a gas flow owes to the level of its pressures
+//rather than their difference (the densities, the temperatures, the density a pump is fed) lags a newton step
+//behind the pressures
+class SteadyNetworkSolver {
+    //nodes
+    std::vector<double> m_pressures;
+    std::vector<double> m_temperatures;     //R T
+    std::vector<bool> m_fixed;
+
+    //edges
+    std::vector<SteadyEdgeType> m_types;
+    std::vector<int> m_from;
+    std::vector<int> m_to;
+    std::vector<double> m_lengths;
+    std::vector<double> m_diameters;
+    std::vector<double> m_frictionFactors;
+    std::vector<double> m_fittingLosses;
+    std::vector<double> m_shutoffRises;
+    std::vector<double> m_maxMassFlowRates;
+    std::vector<double> m_designDensities;
+    std::vector<double> m_massFlowRates;
+
+    //free node numbering and the sparse pressure system (compressed rows, diagonal stored separately)
+    bool m_compiled = false;
+    std::vector<int> m_unknowns;        //per node, -1 when fixed or cut off from every fixed node
+    std::vector<int> m_rowStarts;
+    std::vector<int> m_columns;
+    std::vector<int> m_edgeEntries;     //per edge, the two off diagonal entries (from row, to row), -1 if none
+    std::vector<double> m_values;
+    std::vector<double> m_diagonal;
+    std::vector<double> m_rhs;
+    std::vector<double> m_solution;
+    std::vector<double> m_residual, m_direction, m_preconditioned, m_product;
+    std::vector<double> m_conductances, m_offsets;
+    std::vector<double> m_previousPressures, m_previousFlows;
+    std::vector<double> m_startPressures, m_startFlows, m_startTemperatures;
+    std::vector<double> m_nodeInflows, m_nodeInflowTemperatures;
+
+    void Compile();
+    double GetArrivalTemperature(int edge) const;
+    void UpdateTemperatures();
+    double GetSquaredPressure(int node) const { return m_pressures[node] * m_pressures[node]; }
+    void EvaluateEdge(int edge, double& drop, double& derivative) const;
+    double Linearise(double& flowScale);
+    int SolveLinearSystem(double tolerance);
+
+public:
+    double gamma = 1.4;
+    double viscosity = 1.8e-5;          //of pipes whose friction factor is taken from the reynolds number
+    double roughness = 1.5e-6;          //absolute wall roughness
+    double gasConstantTemperature = 1.0;  //p / rho of the gas nodes are added with
+    double wallTemperature = 0.0;       //R T of the walls of pipes with a fixed friction factor, 0 for adiabatic walls
+
+    double tolerance = 1e-8;            //on the flow error, relative to the largest edge flow
+    int maxIterations = 50;
+
+    int AddNode(double pressure, bool fixed);
+    //the darcy friction factor of the walls, 0 for a frictionless pipe and negative to take it from the reynolds
+    //number. the fitting loss is the summed loss coefficient of the bends and fittings along the pipe
+    int AddPipe(int from, int to, double length, double diameter, double frictionFactor, double fittingLoss = 0.0);
+    //the rise is the shutoff rise at the design density, 0 for a rise that does not scale with the density
+    int AddPump(int inlet, int outlet, double shutoffRise, double maxMassFlowRate, double designDensity = 0.0);
+
+    //the last solution is the starting point of the next solve, so repeated solves of a slowly changing layout
+    //take a step or two. a solve that does not converge leaves the network where it started, so it does not
+    //spoil the next one
+    SteadySolveResult Solve();
+
+    int GetNodeCount() const { return (int)m_pressures.size(); }
+    int GetEdgeCount() const { return (int)m_types.size(); }
+    double GetPressure(int node) const { return m_pressures[node]; }
+    void SetPressure(int node, double pressure) { m_pressures[node] = pressure; }
+    //R T of the gas in a node, set for fixed nodes, solved for free ones
+    double GetTemperature(int node) const { return m_temperatures[node]; }
+    void SetTemperature(int node, double temperature) { m_temperatures[node] = temperature; }
+    void SetPumpRise(int edge, double shutoffRise) { m_shutoffRises[edge] = shutoffRise; }
+    double GetMassFlowRate(int edge) const { return m_massFlowRates[edge]; }
+    void SetMassFlowRate(int edge, double massFlowRate) { m_massFlowRates[edge] = massFlowRate; }
+
+    //net mass flow into a node from its edges, and the mixed R T of the gas flowing in (the node's own when
+    //nothing does)
+    double GetNodeInflow(int node) const;
+    double GetInflowTemperature(int node) const;
+};
@@ -0,0 +1,196 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "sweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#include "../core/thread_pool.h"
+
+bool LoadSweep(const std::string& path, Sweep& sweep, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "unable to open " + path;
+        return false;
+    }
+
+    sweep = Sweep();
+    bool hasScenario = false;
+    std::string text;
+    for (int lineNumber = 1; std::getline(file, text); lineNumber++) {
+        text = text.substr(0, text.find('#'));
+        std::istringstream line(text);
+        std::string keyword;
+        if (!(line >> keyword)) {
+            continue;
+        }
+
+        std::string message;
+        bool parsed = false;
+        if (keyword == "scenario") {
+            std::string scenarioPath;
+            if (line >> scenarioPath) {
+                size_t slash = path.find_last_of("/\\");
+                if (slash != std::string::npos && scenarioPath.front() != '/') {
+                    scenarioPath = path.substr(0, slash + 1) + scenarioPath;
+                }
+                parsed = LoadScenario(scenarioPath, sweep.scenario, message);
+                hasScenario = parsed;
+            }
+        }
+        else if (keyword == "cases") {
+            parsed = (bool)(line >> sweep.caseCount) && sweep.caseCount > 0;
+        }
+        else if (keyword == "sampling") {
+            std::string sampling;
+            parsed = (bool)(line >> sampling) && (sampling == "latin" || sampling == "montecarlo");
+            sweep.sampling = sampling == "latin" ? LATIN_HYPERCUBE : MONTE_CARLO;
+        }
+        else if (keyword == "seed") {
+            parsed = (bool)(line >> sweep.seed);
+        }
+        else if (keyword == "vary") {
+            SweepParameter parameter;
+            std::string scale;
+            parsed = (bool)(line >> parameter.name >> parameter.low >> parameter.high);
+            parameter.logarithmic = (bool)(line >> scale) && scale == "log";
+            if (parsed && parameter.logarithmic && !(parameter.low > 0.0 && parameter.high > 0.0)) {
+                message = "a logarithmic range must be positive";
+                parsed = false;
+            }
+
+            //names are checked against the scenario now rather than failing every case later
+            Scenario check = sweep.scenario;
+            if (parsed && (!hasScenario || !SetScenarioParameter(check, parameter.name, (float)parameter.low))) {
+                message = "unknown parameter " + parameter.name + (hasScenario ? "" : " (no scenario before it)");
+                parsed = false;
+            }
+            sweep.parameters.push_back(parameter);
+        }
+        else {
+            message = "unknown statement " + keyword;
+        }
+
+        if (!parsed) {
+            error = path + ":" + std::to_string(lineNumber) + ": " + (message.empty() ? "malformed " + keyword : message);
+            return false;
+        }
+    }
+
+    if (!hasScenario) {
+        error = path + ": no scenario";
+        return false;
+    }
+    return true;
+}
+
+std::vector<double> SampleSweep(const Sweep& sweep) {
+    int cases = sweep.caseCount;
+    int dimensions = (int)sweep.parameters.size();
+    std::mt19937_64 random(sweep.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    //points in the unit cube first, one column per parameter
+    std::vector<double> samples(cases * dimensions);
+    std::vector<int> strata(cases);
+    for (int d = 0; d < dimensions; d++) {
+        if (sweep.sampling == LATIN_HYPERCUBE) {
+            std::iota(strata.begin(), strata.end(), 0);
+            std::shuffle(strata.begin(), strata.end(), random);
+        }
+        for (int c = 0; c < cases; c++) {
+            double u = uniform(random);
+            samples[c * dimensions + d] = sweep.sampling == LATIN_HYPERCUBE ? (strata[c] + u) / cases : u;
+        }
+    }
+
+    for (int c = 0; c < cases; c++) {
+        for (int d = 0; d < dimensions; d++) {
+            const SweepParameter& parameter = sweep.parameters[d];
+            double& value = samples[c * dimensions + d];
+            if (parameter.logarithmic) {
+                value = std::exp(std::log(parameter.low) + value * (std::log(parameter.high) - std::log(parameter.low)));
+            }
+            else {
+                value = parameter.low + value * (parameter.high - parameter.low);
+            }
+        }
+    }
+    return samples;
+}
+
+bool RunSweep(const Sweep& sweep, ThreadPool* threadPool, std::ostream& output, std::string& error) {
+    const Scenario& scenario = sweep.scenario;
+    int dimensions = (int)sweep.parameters.size();
+    std::vector<double> samples = SampleSweep(sweep);
+
+    output << "case";
+    for (const SweepParameter& parameter : sweep.parameters) {
+        output << "," << parameter.name;
+    }
+    for (size_t i = 0; i < scenario.layout.components.size(); i++) {
+        if (scenario.layout.components[i].type == TANK_COMPONENT) {
+            output << "," << scenario.componentNames[i] << ".storedAmount";
+        }
+    }
+    for (size_t i = 0; i < scenario.layout.components.size(); i++) {
+        if (scenario.layout.components[i].type == ENGINE_COMPONENT) {
+            output << "," << scenario.componentNames[i] << ".deliveredMass";
+        }
+    }
+    output << ",peakPipePressure,wallTime" << std::endl;
+
+    //the cases are independent and coarse, so each runs on one thread and the pool's shared task counter
+    //hands them out as threads free up, which keeps every core busy however uneven the cases are
+    std::mutex outputMutex;
+    bool failed = false;
+    auto runCase = [&](int c) {
+        Scenario instance = scenario;
+        instance.checkpointPath.clear();
+        instance.telemetryPath.clear();
+        for (int d = 0; d < dimensions; d++) {
+            SetScenarioParameter(instance, sweep.parameters[d].name, (float)samples[c * dimensions + d]);
+        }
+        ScenarioResult result = RunScenario(instance, nullptr, nullptr);
+        if (!result.error.empty()) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            error = result.error;
+            failed = true;
+            return;
+        }
+
+        std::ostringstream line;
+        line << c;
+        for (int d = 0; d < dimensions; d++) {
+            line << "," << samples[c * dimensions + d];
+        }
+        for (float amount : result.finalState.tankStoredAmounts) {
+            line << "," << amount;
+        }
+        for (double mass : result.engineDeliveredMasses) {
+            line << "," << mass;
+        }
+        line << "," << result.peakPipePressure << "," << result.wallTime << "\n";
+
+        //flushed per case, a long sweep that is stopped keeps every case it finished
+        std::lock_guard<std::mutex> lock(outputMutex);
+        output << line.str() << std::flush;
+    };
+
+    if (threadPool) {
+        threadPool->ParallelFor(sweep.caseCount, runCase);
+    }
+    else {
+        for (int c = 0; c < sweep.caseCount; c++) {
+            runCase(c);
+        }
+    }
+    return !failed;
+}
@@ -0,0 +1,56 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "scenario.h"
+
+#endif //SWEEP_H
+
+enum SweepSampling {
+    LATIN_HYPERCUBE,    //every parameter's range is cut into one stratum per case and each stratum is used once
+    MONTE_CARLO         //independent uniform samples
+};
+
+struct SweepParameter {
+    std::string name;           //as in SetScenarioParameter
+    double low = 0.0;
+    double high = 1.0;
+    bool logarithmic = false;   //uniform in the logarithm, for ranges over orders of magnitude
+};
+
+//many cases of one scenario with some of its numbers drawn from ranges, loaded from a text file in the
+//scenario format ('#' comments, one statement per line):
+//
+//  scenario <path>                 relative to the sweep file
+//  cases <count>
+//  sampling latin|montecarlo
+//  seed <integer>
+//  vary <parameter> <low> <high> [log]
+struct Sweep {
+    Scenario scenario;
+    std::vector<SweepParameter> parameters;
+    int caseCount = 100;
+    SweepSampling sampling = LATIN_HYPERCUBE;
+    unsigned long long seed = 1;
+};
+
+bool LoadSweep(const std::string& path, Sweep& sweep, std::string& error);
+
+//the parameter values of every case, case major. the same seed always draws the same cases
+std::vector<double> SampleSweep(const Sweep& sweep);
+
+//runs every case single threaded, spread across the pool's threads, and streams one csv line per case to the
+//output as soon as it finishes (so in completion order, the first column is the case). a line holds the
+//sampled parameters, the final stored amount of every tank, the mass every engine took in, the peak pipe
+//pressure and the run's wall time. a scenario that restores a checkpoint forks every case from it, the cases
+//never write checkpoints or telemetry. false when a case could not run
+bool RunSweep(const Sweep& sweep, ThreadPool* threadPool, std::ostream& output, std::string& error);
@@ -0,0 +1,322 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "../core/mapped_file.h"
+
+struct TelemetryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t channelCount;
+    uint32_t reserved;
+};
+
+struct TelemetryChunkHeader {
+    uint32_t marker;
+    uint32_t frameCount;
+    uint64_t bodySize;      //the column sizes and the columns
+};
+
+static uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static uint64_t DoubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+//a byte count nibble per word, two to a byte, then the significant (low) bytes of every word
+template<typename Word>
+static void EncodeColumn(const Word* words, int count, std::vector<unsigned char>& output) {
+    size_t controls = output.size();
+    output.resize(controls + (count + 1) / 2, 0);
+    for (int i = 0; i < count; i++) {
+        Word word = words[i];
+        int bytes = 0;
+        for (Word rest = word; rest != 0; rest >>= 8) {
+            output.push_back((unsigned char)rest);
+            bytes++;
+        }
+        output[controls + i / 2] |= (unsigned char)(bytes << (4 * (i & 1)));
+    }
+}
+
+//false when the column does not hold count words in exactly its size
+template<typename Word>
+static bool DecodeColumn(const unsigned char* input, size_t size, int count, Word* words) {
+    size_t controls = (count + 1) / 2;
+    if (size < controls) {
+        return false;
+    }
+    size_t position = controls;
+    for (int i = 0; i < count; i++) {
+        int bytes = (input[i / 2] >> (4 * (i & 1))) & 15;
+        if (bytes > (int)sizeof(Word) || position + bytes > size) {
+            return false;
+        }
+        Word word = 0;
+        for (int b = 0; b < bytes; b++) {
+            word |= (Word)input[position + b] << (8 * b);
+        }
+        position += bytes;
+        words[i] = word;
+    }
+    return position == size;
+}
+
+bool TelemetryWriter::Open(const std::string& path, const std::vector<std::string>& channels, std::string& error) {
+    Close();
+
+    //the ring and the chunk are sized once, recording never allocates
+    m_channelCount = (int)channels.size();
+    size_t frameBytes = sizeof(double) + m_channelCount * sizeof(float);
+    m_capacity = 16;
+    while (m_capacity * 2 * frameBytes <= bufferBytes) {
+        m_capacity *= 2;
+    }
+    m_times.assign(m_capacity, 0.0);
+    m_frames.assign((size_t)m_capacity * m_channelCount, 0.0f);
+    m_chunkCapacity = (int)std::min<size_t>(std::max<size_t>(chunkBytes / frameBytes, 1), std::max(maxChunkFrames, 1));
+    m_chunkFrames = 0;
+    m_chunkTimes.assign(m_chunkCapacity, 0.0);
+    m_chunkValues.assign((size_t)m_chunkCapacity * m_channelCount, 0.0f);
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_droppedFrames.store(0, std::memory_order_relaxed);
+    m_recordedFrames.store(0, std::memory_order_relaxed);
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_failed = false;
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        error = "unable to write " + path;
+        return false;
+    }
+    TelemetryHeader header = {};
+    std::memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+    header.version = TELEMETRY_VERSION;
+    header.endianTag = TELEMETRY_ENDIAN_TAG;
+    header.channelCount = (uint32_t)m_channelCount;
+    m_file.write((const char*)&header, sizeof(header));
+    for (const std::string& channel : channels) {
+        uint32_t length = (uint32_t)channel.size();
+        m_file.write((const char*)&length, sizeof(length));
+        m_file.write(channel.data(), length);
+    }
+    m_file.flush();
+    if (!m_file) {
+        m_file.close();
+        error = "unable to write " + path;
+        return false;
+    }
+
+    m_thread = std::thread(&TelemetryWriter::WriterLoop, this);
+    return true;
+}
+
+bool TelemetryWriter::Close() {
+    if (m_thread.joinable()) {
+        m_stopping.store(true, std::memory_order_release);
+        m_thread.join();
+        m_file.close();
+    }
+    return !m_failed;
+}
+
+float* TelemetryWriter::BeginFrame(double time) {
+    unsigned int tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == m_capacity) {
+        m_droppedFrames.store(m_droppedFrames.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    unsigned int slot = tail & (m_capacity - 1);
+    m_times[slot] = time;
+    return m_frames.data() + (size_t)slot * m_channelCount;
+}
+
+void TelemetryWriter::CommitFrame() {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    m_recordedFrames.store(m_recordedFrames.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void TelemetryWriter::WriterLoop() {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point lastFlush = Clock::now();
+    while (true) {
+        //read before draining, so every frame committed before Close is drained on the last pass
+        bool stopping = m_stopping.load(std::memory_order_acquire);
+
+        unsigned int head = m_head.load(std::memory_order_relaxed);
+        unsigned int tail = m_tail.load(std::memory_order_acquire);
+        bool drained = head != tail;
+        for (; head != tail; head++) {
+            //transposed into the chunk's columns, and the slot handed back right away
+            unsigned int slot = head & (m_capacity - 1);
+            const float* frame = m_frames.data() + (size_t)slot * m_channelCount;
+            m_chunkTimes[m_chunkFrames] = m_times[slot];
+            for (int c = 0; c < m_channelCount; c++) {
+                m_chunkValues[(size_t)c * m_chunkCapacity + m_chunkFrames] = frame[c];
+            }
+            m_head.store(head + 1, std::memory_order_release);
+            if (++m_chunkFrames == m_chunkCapacity) {
+                WriteChunk();
+            }
+        }
+
+        Clock::time_point now = Clock::now();
+        if (stopping || std::chrono::duration<double>(now - lastFlush).count() >= flushInterval) {
+            WriteChunk();
+            m_file.flush();
+            m_failed = m_failed || !m_file;
+            lastFlush = now;
+        }
+        if (stopping) {
+            return;
+        }
+        if (!drained) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+void TelemetryWriter::WriteChunk() {
+    if (m_chunkFrames == 0) {
+        return;
+    }
+    m_encoded.clear();
+    m_columnSizes.assign(m_channelCount + 1, 0);
+
+    //times: the delta of the bit patterns, XORed with the delta before it, so a steady step encodes to nothing
+    std::vector<uint64_t> timeWords(m_chunkFrames);
+    uint64_t previousBits = 0, previousDelta = 0;
+    for (int f = 0; f < m_chunkFrames; f++) {
+        uint64_t bits = DoubleBits(m_chunkTimes[f]);
+        uint64_t delta = bits - previousBits;
+        timeWords[f] = delta ^ previousDelta;
+        previousBits = bits;
+        previousDelta = delta;
+    }
+    EncodeColumn(timeWords.data(), m_chunkFrames, m_encoded);
+    m_columnSizes[0] = (uint32_t)m_encoded.size();
+
+    std::vector<uint32_t> valueWords(m_chunkFrames);
+    for (int c = 0; c < m_channelCount; c++) {
+        const float* column = m_chunkValues.data() + (size_t)c * m_chunkCapacity;
+        uint32_t previous = 0;
+        for (int f = 0; f < m_chunkFrames; f++) {
+            uint32_t bits = FloatBits(column[f]);
+            valueWords[f] = bits ^ previous;
+            previous = bits;
+        }
+        size_t start = m_encoded.size();
+        EncodeColumn(valueWords.data(), m_chunkFrames, m_encoded);
+        m_columnSizes[c + 1] = (uint32_t)(m_encoded.size() - start);
+    }
+
+    TelemetryChunkHeader header = {};
+    header.marker = TELEMETRY_CHUNK_MARKER;
+    header.frameCount = (uint32_t)m_chunkFrames;
+    header.bodySize = m_columnSizes.size() * sizeof(uint32_t) + m_encoded.size();
+    m_file.write((const char*)&header, sizeof(header));
+    m_file.write((const char*)m_columnSizes.data(), m_columnSizes.size() * sizeof(uint32_t));
+    m_file.write((const char*)m_encoded.data(), m_encoded.size());
+    m_failed = m_failed || !m_file;
+    m_chunkFrames = 0;
+}
+
+bool LoadTelemetry(const std::string& path, TelemetryData& data, std::string& error) {
+    data = TelemetryData();
+    MappedFile file;
+    if (!file.OpenRead(path)) {
+        error = "unable to open " + path;
+        return false;
+    }
+    const unsigned char* bytes = file.GetData();
+    size_t size = file.GetSize();
+
+    TelemetryHeader header = {};
+    if (size >= sizeof(header)) {
+        std::memcpy(&header, bytes, sizeof(header));
+    }
+    if (std::memcmp(header.magic, TELEMETRY_MAGIC, sizeof(header.magic)) != 0) {
+        error = path + ": not a telemetry file";
+        return false;
+    }
+    if (header.endianTag != TELEMETRY_ENDIAN_TAG || header.version != TELEMETRY_VERSION) {
+        error = path + ": telemetry of another format version or byte order";
+        return false;
+    }
+
+    size_t position = sizeof(header);
+    for (uint32_t c = 0; c < header.channelCount; c++) {
+        uint32_t length = 0;
+        if (position + sizeof(length) <= size) {
+            std::memcpy(&length, bytes + position, sizeof(length));
+        }
+        if (position + sizeof(length) + length > size) {
+            error = path + ": truncated channel names";
+            return false;
+        }
+        data.channels.emplace_back((const char*)bytes + position + sizeof(length), length);
+        position += sizeof(length) + length;
+    }
+    data.values.resize(header.channelCount);
+
+    std::vector<uint32_t> columnSizes(header.channelCount + 1);
+    std::vector<uint64_t> timeWords;
+    std::vector<uint32_t> valueWords;
+    TelemetryChunkHeader chunk;
+    while (position + sizeof(chunk) <= size) {
+        std::memcpy(&chunk, bytes + position, sizeof(chunk));
+        position += sizeof(chunk);
+        size_t tableSize = columnSizes.size() * sizeof(uint32_t);
+        if (chunk.marker != TELEMETRY_CHUNK_MARKER || chunk.bodySize > size - position || chunk.bodySize < tableSize) {
+            break;
+        }
+        std::memcpy(columnSizes.data(), bytes + position, tableSize);
+        const unsigned char* column = bytes + position + tableSize;
+        const unsigned char* end = bytes + position + chunk.bodySize;
+        position += chunk.bodySize;
+
+        int count = (int)chunk.frameCount;
+        timeWords.resize(count);
+        valueWords.resize(count);
+        bool valid = columnSizes[0] <= (size_t)(end - column) && DecodeColumn(column, columnSizes[0], count, timeWords.data());
+        column += valid ? columnSizes[0] : 0;
+        uint64_t bits = 0, delta = 0;
+        for (int f = 0; valid && f < count; f++) {
+            delta ^= timeWords[f];
+            bits += delta;
+            double time;
+            std::memcpy(&time, &bits, sizeof(time));
+            data.times.push_back(time);
+        }
+        for (uint32_t c = 0; valid && c < header.channelCount; c++) {
+            valid = columnSizes[c + 1] <= (size_t)(end - column) && DecodeColumn(column, columnSizes[c + 1], count, valueWords.data());
+            column += valid ? columnSizes[c + 1] : 0;
+            uint32_t value = 0;
+            for (int f = 0; valid && f < count; f++) {
+                value ^= valueWords[f];
+                float decoded;
+                std::memcpy(&decoded, &value, sizeof(decoded));
+                data.values[c].push_back(decoded);
+            }
+        }
+        if (!valid) {
+            error = path + ": corrupt chunk at frame " + std::to_string(data.times.size());
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#endif //TELEMETRY_H
+
+//telemetry files are a header naming the channels, then self contained chunks of up to a few thousand frames
+//(a frame is the time and one value per channel). a chunk is stored by column, the times first and then every
+//channel, so a reader can skip to the channels it wants. the times are delta encoded (on their bit patterns,
+//which grow with the time, so the decoding is exact) and successive deltas XORed, the values are XORed with the
+//value before them. slowly changing series XOR to words with many leading zero bytes, and only the significant
+//bytes are stored, with a 4 bit byte count per value. a run that is stopped loses at most the chunk it was
+//writing, the ones before it are complete
+constexpr char TELEMETRY_MAGIC[8] = {'R', 'E', 'S', 'T', 'L', 'M', '\0', '\0'};
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr uint32_t TELEMETRY_ENDIAN_TAG = 0x01020304;
+constexpr uint32_t TELEMETRY_CHUNK_MARKER = 0x4b4e4843;
+
+//records frames on the simulation thread and writes them from a thread of its own. the two share a single
+//producer, single consumer ring of frames: recording a frame is filling a slot and one release store, the
+//simulation never waits on the disk. when the writer falls so far behind that the ring is full, frames are
+//dropped and counted instead
+class TelemetryWriter {
+    int m_channelCount = 0;
+    unsigned int m_capacity = 0;        //frames, a power of two
+    std::vector<double> m_times;
+    std::vector<float> m_frames;        //frame major, m_channelCount floats per frame
+
+    alignas(64) std::atomic<unsigned int> m_head = 0;   //next frame to write out, written by the writer thread
+    alignas(64) std::atomic<unsigned int> m_tail = 0;   //next free slot, written by the simulation thread
+    alignas(64) std::atomic<unsigned long long> m_droppedFrames = 0;
+    std::atomic<unsigned long long> m_recordedFrames = 0;
+
+    //writer thread
+    std::thread m_thread;
+    std::atomic<bool> m_stopping = false;
+    std::ofstream m_file;
+    bool m_failed = false;
+    int m_chunkCapacity = 0;
+    int m_chunkFrames = 0;
+    std::vector<double> m_chunkTimes;
+    std::vector<float> m_chunkValues;   //channel major, m_chunkCapacity floats per channel
+    std::vector<uint32_t> m_columnSizes;
+    std::vector<unsigned char> m_encoded;
+
+    void WriterLoop();
+    void WriteChunk();
+
+public:
+    //wall time between writes of the chunk so far, at least one chunk per interval reaches the disk
+    double flushInterval = 1.0;
+
+    //memory of the ring and of a chunk, the frame counts follow from the channel count
+    size_t bufferBytes = 64u << 20;
+    size_t chunkBytes = 8u << 20;
+    int maxChunkFrames = 4096;
+
+    TelemetryWriter() = default;
+    ~TelemetryWriter() { Close(); }
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    //creates the file and starts the writer thread
+    bool Open(const std::string& path, const std::vector<std::string>& channels, std::string& error);
+
+    //writes out everything recorded and stops the writer thread. false when a write failed
+    bool Close();
+
+    //simulation thread: the slot for the values of the next frame, nullptr when the ring is full (the frame
+    //is then dropped). CommitFrame hands the filled slot to the writer
+    float* BeginFrame(double time);
+    void CommitFrame();
+
+    bool IsOpen() const { return m_thread.joinable(); }
+    int GetChannelCount() const { return m_channelCount; }
+    unsigned long long GetRecordedFrames() const { return m_recordedFrames.load(std::memory_order_relaxed); }
+    unsigned long long GetDroppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+};
+
+//a telemetry file decoded into one column per channel
+struct TelemetryData {
+    std::vector<std::string> channels;
+    std::vector<double> times;
+    std::vector<std::vector<float>> values;     //per channel, one value per time
+};
+
+//reads every complete chunk, a partly written last chunk is ignored
+bool LoadTelemetry(const std::string& path, TelemetryData& data, std::string& error);
@@ -0,0 +1,454 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#include "validation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "glm/geometric.hpp"
+#include "scenario.h"
+
+template<typename Simulation>
+double ComputeL1DensityError(const Simulation& simulation, const ExactRiemannSolver& exact) {
+    int n = simulation.GetResolution();
+    double t = simulation.time;
+    double error = 0.0;
+    double x = 0.0;
+    for (int i = 0; i < n; i++) {
+        double size = simulation.sizes[i];
+        double center = x + 0.5 * size;
+        x += size;
+        if (i == 0 || i == n - 1) {
+            continue;
+        }
+        error += std::abs((double)simulation.density[i] - exact.Sample((center - 0.5) / t).density) * size;
+    }
+    return error;
+}
+
+template<typename Simulation>
+std::vector<ConvergenceSample> RunSodConvergence(const std::vector<int>& resolutions, Reconstruction reconstruction, TimeIntegration timeIntegration, double endTime) {
+    using Real = typename Simulation::Scalar;
+    ExactRiemannSolver exact({1.0, 0.0, 1.0}, {0.125, 0.0, 0.1}, 1.4);
+
+    std::vector<ConvergenceSample> samples;
+    for (int resolution : resolutions) {
+        auto start = std::chrono::steady_clock::now();
+
+        Simulation simulation(resolution);
+        simulation.SetReconstruction(reconstruction);
+        simulation.timeIntegration = timeIntegration;
+        while (simulation.time < (Real)endTime) {
+            simulation.maxTimeStep = (Real)endTime - simulation.time;
+            simulation.Step();
+        }
+
+        ConvergenceSample sample;
+        sample.resolution = resolution;
+        sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sample.l1Error = ComputeL1DensityError(simulation, exact);
+        if (!samples.empty()) {
+            const ConvergenceSample& previous = samples.back();
+            sample.order = std::log(previous.l1Error / sample.l1Error) / std::log((double)resolution / previous.resolution);
+        }
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+void PrintSodConvergenceReport(std::ostream& out, const std::vector<int>& resolutions) {
+    struct Scheme {
+        const char* name;
+        Reconstruction reconstruction;
+        TimeIntegration timeIntegration;
+    };
+    Scheme schemes[] = {
+        {"first order", PIECEWISE_CONSTANT, FORWARD_EULER},
+        {"MUSCL minmod + SSP-RK2", MUSCL_MINMOD, SSP_RK2},
+        {"MUSCL van Leer + SSP-RK2", MUSCL_VAN_LEER, SSP_RK2},
+        {"MUSCL MC + SSP-RK2", MUSCL_MC, SSP_RK2},
+    };
+
+    out << "sod shock tube, t = 0.2, L1 density error" << std::endl;
+    for (const Scheme& scheme : schemes) {
+        out << scheme.name << std::endl;
+        for (const ConvergenceSample& sample : RunSodConvergence<GasSimulation>(resolutions, scheme.reconstruction, scheme.timeIntegration)) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "  %6d regions  error %.4e  order %5.2f  %8.3f ms", sample.resolution, sample.l1Error, sample.order, sample.seconds * 1000.0);
+            out << line << std::endl;
+        }
+    }
+}
+
+bool CheckAdaptiveSod(std::ostream& out, const std::vector<int>& baseResolutions, int maxLevel, double endTime, double massTolerance) {
+    using Simulation = BasicAdaptiveGasSimulation<double, HLLFlux, ReflectiveBoundary>;
+    ExactRiemannSolver exact({1.0, 0.0, 1.0}, {0.125, 0.0, 0.1}, 1.4);
+
+    out << "adaptive sod shock tube, L1 density error at t = 0.2, mass drift to t = " << endTime << std::endl;
+    bool passed = true;
+    for (int baseResolution : baseResolutions) {
+        double uniformError = RunSodConvergence<GasSimulation>({baseResolution}, PIECEWISE_CONSTANT, FORWARD_EULER)[0].l1Error;
+        double previousError = uniformError;
+        for (int level = 0; level <= maxLevel; level++) {
+            Simulation simulation(baseResolution, level);
+            double initialMass = simulation.GetTotalMass();
+            double drift = 0.0;
+            double error = 0.0;
+            int finestLevel = 0;
+            for (double stopTime : {0.2, endTime}) {
+                while (simulation.time < stopTime) {
+                    simulation.maxTimeStep = stopTime - simulation.time;
+                    simulation.Step();
+                    drift = std::max(drift, std::abs(simulation.GetTotalMass() / initialMass - 1.0));
+                    finestLevel = std::max(finestLevel, simulation.GetFinestLevel());
+                }
+                if (stopTime == 0.2) {
+                    error = ComputeL1DensityError(simulation, exact);
+                }
+            }
+
+            //the float uniform scheme rounds differently, so the unrefined run only has to agree closely
+            bool accurate = level == 0 ? std::abs(error / uniformError - 1.0) <= 1e-3 : error < previousError;
+            bool conserved = drift <= massTolerance;
+            passed = passed && accurate && conserved && finestLevel == level;
+            previousError = error;
+
+            char line[200];
+            std::snprintf(line, sizeof(line), "  %4d base  level %d  %4d regions  error %.4e  uniform %.4e  mass drift %.1e%s", baseResolution, level,
+                          simulation.GetResolution(), error, uniformError, drift,
+                          !accurate ? "  INACCURATE" : !conserved ? "  NOT CONSERVED" : finestLevel != level ? "  NOT REFINED" : "");
+            out << line << std::endl;
+        }
+    }
+    return passed;
+}
+
+bool CheckEnsembleAgainstSimulations(std::ostream& out, int count, int resolution, int steps, ThreadPool* threadPool) {
+    out << "ensemble of " << count << " pipes against separate simulations, " << steps << " steps" << std::endl;
+    bool passed = true;
+    for (EnsembleTimeStep mode : {PER_LANE_TIME_STEP, SHARED_TIME_STEP}) {
+        GasEnsemble ensemble(count, resolution);
+        ensemble.timeStepMode = mode;
+        ensemble.SetThreadPool(threadPool);
+        std::vector<GasSimulation> simulations;
+        simulations.reserve(count);
+        for (int k = 0; k < count; k++) {
+            float length = 0.5f + 0.25f * (float)k;
+            ensemble.SetLength(k, length);
+            simulations.emplace_back(resolution);
+            for (int i = 0; i < resolution; i++) {
+                float density = i < resolution / 2 ? 1.0f : 0.125f + 0.01f * (float)k;
+                float pressure = i < resolution / 2 ? 1.0f + 0.1f * (float)k : 0.1f;
+                simulations[k].sizes[i] = length / (float)resolution;
+                simulations[k].SetState(i, density, 0.0f, pressure);
+                ensemble.SetState(k, i, density, 0.0f, pressure);
+            }
+        }
+
+        int differences = 0;
+        for (int step = 0; step < steps; step++) {
+            ensemble.Step();
+            for (int k = 0; k < count; k++) {
+                //the shared step is whatever the ensemble took, a lone simulation takes its own CFL step
+                if (mode == SHARED_TIME_STEP) {
+                    simulations[k].Step(ensemble.GetTimeStep(k));
+                }
+                else {
+                    simulations[k].Step();
+                }
+                const GasSimulation& simulation = simulations[k];
+                differences += ensemble.GetTime(k) != simulation.time;
+                for (int i = 0; i < resolution; i++) {
+                    differences += ensemble.GetDensity(k, i) != simulation.density[i] || ensemble.GetVelocity(k, i) != simulation.velocity[i] ||
+                                   ensemble.GetPressure(k, i) != simulation.pressure[i];
+                }
+            }
+        }
+        passed = passed && differences == 0;
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-8s time step  %d differences%s", mode == SHARED_TIME_STEP ? "shared" : "per lane", differences,
+                      differences != 0 ? "  FAILED" : "");
+        out << line << std::endl;
+    }
+    return passed;
+}
+
+bool CheckPlenumFlow(std::ostream& out, double tolerance) {
+    const double gamma = 1.4;
+    const double radius = 0.1;
+    const double area = M_PI * radius * radius;
+
+    out << "plenum to plenum flow against bernoulli" << std::endl;
+    bool passed = true;
+    for (double length : {2.0, 20.0}) {
+        for (double pressureDifference : {0.05, 0.2, 0.8}) {
+            //the gas expands from the upstream plenum (at unit temperature) to the downstream pressure
+            double upstreamPressure = 1.0 + pressureDifference;
+            double temperature = std::pow(1.0 / upstreamPressure, (gamma - 1.0) / gamma);
+            double velocity = std::sqrt(2.0 * gamma / (gamma - 1.0) * (1.0 - temperature));
+            double expected = velocity / temperature * area;
+
+            for (PipeFidelity fidelity : {RESOLVED_FIDELITY, LUMPED_FIDELITY}) {
+                PipeNetwork network;
+                int pipe = network.AddPipe((float)length, (float)area, (int)(length / 0.1) + 2);
+                int upstream = network.AddNode(INFINITY, (float)upstreamPressure, (float)upstreamPressure);
+                int downstream = network.AddNode(INFINITY, 1.0f, 1.0f);
+                network.Connect(pipe, PIPE_START, upstream);
+                network.Connect(pipe, PIPE_END, downstream);
+                network.Prepare();
+                network.SetFidelity(pipe, fidelity);
+
+                //long enough for the waves running up and down the longest pipe to die out
+                while (network.time < 2000.0f) {
+                    network.Step();
+                }
+                double flow = network.GetNode(downstream).massFlowRate;
+                double error = std::abs(flow / expected - 1.0);
+                passed = passed && error <= tolerance;
+
+                char line[160];
+                std::snprintf(line, sizeof(line), "  %5.1f long  dp %.2f  %-8s  flow %.5f  bernoulli %.5f  error %6.2f%%%s", length,
+                              pressureDifference, fidelity == RESOLVED_FIDELITY ? "resolved" : "lumped", flow, expected,
+                              100.0 * error, error > tolerance ? "  FAILED" : "");
+                out << line << std::endl;
+            }
+        }
+    }
+    return passed;
+}
+
+bool CheckPumpOutlet(std::ostream& out) {
+    //the connection points of the editor's ElectricPump and Tank, relative to the models
+    const glm::vec3 pumpPosition(-2.0f, 0.0f, 0.0f);
+    const std::vector<glm::vec3> pumpPoints = {{0.0f, 1.25f, 0.0f}, {0.0f, 0.0f, -1.15f}};
+    const glm::vec3 tankPoint(2.0f, -1.95f, 0.0f);
+
+    NetworkLayout layout;
+    ComponentLayout tank, pump, engine;
+    tank.outletPressure = 10.0f;
+    tank.volume = 10.0f;
+    tank.storedAmount = 10.0f;
+    pump.type = PUMP_COMPONENT;
+    pump.inletPressure = -1.0f;
+    pump.outletPressure = 4.0f;
+    engine.type = ENGINE_COMPONENT;
+    engine.inletPressure = -0.5f;
+    layout.components = {tank, pump, engine};
+
+    std::vector<std::vector<glm::vec3>> paths = {
+        {tankPoint, {0.0f, -1.95f, 0.0f}, pumpPosition + pumpPoints[0]},
+        {pumpPosition + pumpPoints[1], {-2.0f, 0.0f, -3.0f}, {0.0f, 0.0f, -3.0f}},
+    };
+    for (int i = 0; i < (int)paths.size(); i++) {
+        PipeLayout pipe;
+        pipe.length = 0.0f;
+        for (size_t j = 1; j < paths[i].size(); j++) {
+            pipe.length += glm::length(paths[i][j] - paths[i][j - 1]);
+        }
+        pipe.start = paths[i].front();
+        pipe.end = paths[i].back();
+        layout.pipes.push_back(pipe);
+        AddPathBends(i, paths[i], {}, layout.bends);
+    }
+
+    //the pump takes whichever pipe ends sit on its points, in the order they were connected
+    layout.ports.push_back({0, 0, PIPE_START, false});
+    int outlets = 0, outletPort = -1;
+    for (auto [pipe, end] : {std::pair<int, PipeEnd>(0, PIPE_END), std::pair<int, PipeEnd>(1, PIPE_START)}) {
+        glm::vec3 point = end == PIPE_START ? layout.pipes[pipe].start : layout.pipes[pipe].end;
+        bool outlet = FindConnectionPoint(pumpPoints, pumpPosition, point) == 1;
+        outlets += outlet;
+        outletPort = outlet ? (int)layout.ports.size() : outletPort;
+        layout.ports.push_back({1, pipe, end, outlet});
+    }
+    layout.ports.push_back({2, 1, PIPE_END, false});
+
+    NetworkSimulation simulation;
+    simulation.Compile(layout);
+    simulation.mode = STEADY_STATE;
+    simulation.Advance(0.0, 1);
+    SimulationSnapshot steady;
+    simulation.WriteSnapshot(steady);
+
+    //ports 1 and 2 are the pump's inlet and outlet side
+    double rise = steady.controlPointPressures[2] - steady.controlPointPressures[1];
+    double setRise = pump.outletPressure - pump.inletPressure;
+    bool passed = outlets == 1 && outletPort == 2 && rise >= 0.5 * setRise;
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "pump outlet at x = %g  %d outlet port%s  steady rise %.4f  set rise %.4f%s", pumpPosition.x, outlets,
+                  outlets == 1 ? "" : "s", rise, setRise, passed ? "" : "  FAILED");
+    out << line << std::endl;
+    return passed;
+}
+
+//advances a simulation of the scenario's layout from one time to another with only its set points, the checks
+//pick the modes themselves
+static void AdvanceSetPoints(NetworkSimulation& simulation, const Scenario& scenario, double time, double endTime) {
+    size_t nextEvent = 0;
+    while (nextEvent < scenario.events.size() && scenario.events[nextEvent].time < time) {
+        nextEvent++;
+    }
+    while (time < endTime) {
+        for (; nextEvent < scenario.events.size() && scenario.events[nextEvent].time <= time; nextEvent++) {
+            const ScenarioEvent& event = scenario.events[nextEvent];
+            if (event.type == SET_INLET_PRESSURE) {
+                simulation.SetInletPressure(event.component, event.value);
+            }
+            else if (event.type == SET_OUTLET_PRESSURE) {
+                simulation.SetOutletPressure(event.component, event.value);
+            }
+        }
+        double step = std::min(scenario.tickTime, endTime - time);
+        if (nextEvent < scenario.events.size()) {
+            step = std::min(step, scenario.events[nextEvent].time - time);
+        }
+        simulation.Advance(step, scenario.maxSubSteps);
+        time += step;
+    }
+}
+
+bool CheckSteadyAgainstTransient(std::ostream& out, const std::string& scenarioPath, double settlingTime, double tolerance) {
+    Scenario scenario;
+    std::string error;
+    if (!LoadScenario(scenarioPath, scenario, error)) {
+        out << error << std::endl;
+        return false;
+    }
+
+    NetworkSimulation simulation;
+    simulation.Compile(scenario.layout);
+    AdvanceSetPoints(simulation, scenario, 0.0, settlingTime);
+    SimulationSnapshot transient;
+    simulation.WriteSnapshot(transient);
+
+    simulation.mode = STEADY_STATE;
+    simulation.Advance(0.0, 1);
+    SimulationSnapshot steady;
+    simulation.WriteSnapshot(steady);
+
+    out << "steady state against " << settlingTime << " of transient, " << scenarioPath << std::endl;
+    bool passed = true;
+    for (size_t i = 0; i < transient.engineMassFlowRates.size(); i++) {
+        double expected = transient.engineMassFlowRates[i];
+        double flow = steady.engineMassFlowRates[i];
+        double error = std::abs(flow / expected - 1.0);
+        passed = passed && error <= tolerance;
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "  engine %zu  steady %.5f  transient %.5f  error %6.2f%%%s", i, flow, expected, 100.0 * error,
+                      error > tolerance ? "  FAILED" : "");
+        out << line << std::endl;
+    }
+    return passed;
+}
+
+bool CheckCarriedState(std::ostream& out, const std::string& scenarioPath, double time, double duration) {
+    Scenario scenario;
+    std::string error;
+    if (!LoadScenario(scenarioPath, scenario, error)) {
+        out << error << std::endl;
+        return false;
+    }
+
+    out << "state carried into a recompiled simulation at " << time << ", " << scenarioPath << std::endl;
+    std::vector<int> pipeSources, componentSources;
+    for (int i = 0; i < (int)scenario.layout.pipes.size(); i++) {
+        pipeSources.push_back(i);
+    }
+    for (int i = 0; i < (int)scenario.layout.components.size(); i++) {
+        componentSources.push_back(i);
+    }
+    bool passed = true;
+    for (PipeFidelity fidelity : {RESOLVED_FIDELITY, LUMPED_FIDELITY, ADAPTIVE_FIDELITY}) {
+        scenario.layout.fidelity = fidelity;
+        NetworkSimulation simulation, replaced;
+        simulation.Compile(scenario.layout);
+        replaced.Compile(scenario.layout);
+        AdvanceSetPoints(simulation, scenario, 0.0, time);
+        AdvanceSetPoints(replaced, scenario, 0.0, time);
+
+        //like the editor, the layout it is compiled from has the set points the components were moved to
+        NetworkLayout layout = scenario.layout;
+        for (const ScenarioEvent& event : scenario.events) {
+            if (event.time < time && event.type == SET_INLET_PRESSURE) {
+                layout.components[event.component].inletPressure = event.value;
+            }
+            else if (event.time < time && event.type == SET_OUTLET_PRESSURE) {
+                layout.components[event.component].outletPressure = event.value;
+            }
+        }
+        NetworkSimulation carried;
+        carried.Compile(layout);
+        carried.CarryState(replaced, pipeSources, componentSources);
+        AdvanceSetPoints(simulation, scenario, time, time + duration);
+        AdvanceSetPoints(carried, scenario, time, time + duration);
+        SimulationSnapshot expected, result;
+        simulation.WriteSnapshot(expected);
+        carried.WriteSnapshot(result);
+
+        bool same = expected.tankStoredAmounts == result.tankStoredAmounts && expected.engineMassFlowRates == result.engineMassFlowRates &&
+                    expected.controlPointPressures == result.controlPointPressures && expected.pipePressures == result.pipePressures &&
+                    expected.pipeMassFlowRates == result.pipeMassFlowRates && simulation.GetTime() == carried.GetTime();
+        passed = passed && same;
+
+        const char* names[] = {"resolved", "lumped", "adaptive"};
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-8s  engine flow %.6f  carried %.6f%s", names[fidelity], expected.engineMassFlowRates.empty() ? 0.0f : expected.engineMassFlowRates[0],
+                      result.engineMassFlowRates.empty() ? 0.0f : result.engineMassFlowRates[0], same ? "" : "  DIFFERS");
+        out << line << std::endl;
+    }
+    return passed;
+}
+
+bool CheckBlowdownAgainstTransient(std::ostream& out, const std::string& scenarioPath, double settlingTime, double duration, double tolerance) {
+    Scenario scenario;
+    std::string error;
+    if (!LoadScenario(scenarioPath, scenario, error)) {
+        out << error << std::endl;
+        return false;
+    }
+
+    //both start from the same settled transient state, the transient run is deterministic
+    NetworkSimulation transient, quasiSteady;
+    transient.Compile(scenario.layout);
+    quasiSteady.Compile(scenario.layout);
+    AdvanceSetPoints(transient, scenario, 0.0, settlingTime);
+    AdvanceSetPoints(quasiSteady, scenario, 0.0, settlingTime);
+    SimulationSnapshot initial, transientEnd, quasiSteadyEnd;
+    transient.WriteSnapshot(initial);
+
+    quasiSteady.mode = QUASI_STEADY;
+    AdvanceSetPoints(transient, scenario, settlingTime, settlingTime + duration);
+    AdvanceSetPoints(quasiSteady, scenario, settlingTime, settlingTime + duration);
+    transient.WriteSnapshot(transientEnd);
+    quasiSteady.WriteSnapshot(quasiSteadyEnd);
+    const IntegrationStatistics& statistics = quasiSteady.GetBlowdownStatistics();
+
+    char line[200];
+    std::snprintf(line, sizeof(line), "quasi steady blowdown against transient from %g to %g, %d steps (%d rejected, %d failed solves), %s", settlingTime,
+                  settlingTime + duration, statistics.acceptedSteps, statistics.rejectedSteps, statistics.failedEvaluations, scenarioPath.c_str());
+    out << line << std::endl;
+    bool passed = true;
+    for (size_t i = 0; i < initial.tankStoredAmounts.size(); i++) {
+        double expected = initial.tankStoredAmounts[i] - transientEnd.tankStoredAmounts[i];
+        double drawn = initial.tankStoredAmounts[i] - quasiSteadyEnd.tankStoredAmounts[i];
+        double error = std::abs(drawn / expected - 1.0);
+        passed = passed && error <= tolerance;
+
+        std::snprintf(line, sizeof(line), "  tank %zu  %.4f -> quasi steady %.4f  transient %.4f  drawn error %6.2f%%%s", i, initial.tankStoredAmounts[i],
+                      quasiSteadyEnd.tankStoredAmounts[i], transientEnd.tankStoredAmounts[i], 100.0 * error, error > tolerance ? "  FAILED" : "");
+        out << line << std::endl;
+    }
+    return passed;
+}
+
+template double ComputeL1DensityError(const GasSimulation&, const ExactRiemannSolver&);
+template double ComputeL1DensityError(const BasicGasSimulation<float, HLLFlux, TransmissiveBoundary>&, const ExactRiemannSolver&);
+template double ComputeL1DensityError(const BasicAdaptiveGasSimulation<double, HLLFlux, ReflectiveBoundary>&, const ExactRiemannSolver&);
+template std::vector<ConvergenceSample> RunSodConvergence<GasSimulation>(const std::vector<int>&, Reconstruction, TimeIntegration, double);
@@ -0,0 +1,85 @@
+//
+// Created by Osprey on 10/17/2026.
+//
+
+#pragma once
+
+#ifndef VALIDATION_H
+#define VALIDATION_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "adaptive_gas_simulation.h"
+#include "exact_riemann.h"
+#include "gas_ensemble.h"
+#include "gas_simulation.h"
+#include "network_simulation.h"
+#include "pipe_network.h"
+
+#endif //VALIDATION_H
+
+struct ConvergenceSample {
+    int resolution = 0;
+    double l1Error = 0.0;
+    double order = 0.0;     //observed order against the previous (coarser) sample
+    double seconds = 0.0;   //wall time of the run
+};
+
+//L1 density error of a simulation against an exact riemann solution with the discontinuity at x = 0.5.
+//the ghost regions at either end are not counted
+template<typename Simulation>
+double ComputeL1DensityError(const Simulation& simulation, const ExactRiemannSolver& exact);
+
+//runs the sod problem the GasSimulation constructor sets up to t = endTime at every resolution
+template<typename Simulation>
+std::vector<ConvergenceSample> RunSodConvergence(const std::vector<int>& resolutions, Reconstruction reconstruction, TimeIntegration timeIntegration, double endTime = 0.2);
+
+//error, observed order and cost of the first order scheme against every MUSCL/SSP-RK2 variant
+void PrintSodConvergenceReport(std::ostream& out, const std::vector<int>& resolutions = {50, 100, 200, 400, 800, 1600});
+
+//the adaptive simulation (adaptive_gas_simulation.h, in double) on the sod problem at every base resolution and
+//refinement level. at t = 0.2 the L1 density error without refinement has to match the uniform first order
+//scheme of the base resolution, and every further level has to lower it. the run then goes on to endTime, the
+//waves crossing the refinement boundaries and reflecting off the walls, and the total mass may not drift by
+//more than massTolerance (relative) at any step. prints a line per run, false when one does not hold
+bool CheckAdaptiveSod(std::ostream& out, const std::vector<int>& baseResolutions = {50, 100, 200}, int maxLevel = 3, double endTime = 1.0,
+                      double massTolerance = 1e-12);
+
+//a GasEnsemble of pipes of different lengths, each with its own shock tube (the last group of lanes only partly
+//filled), against one GasSimulation per pipe, in both time step modes: at every step the density, velocity and
+//pressure of every lane and its time have to match its lone simulation bit for bit. prints a line per mode,
+//false on any difference
+bool CheckEnsembleAgainstSimulations(std::ostream& out, int count = 13, int resolution = 40, int steps = 200, ThreadPool* threadPool = nullptr);
+
+//a frictionless pipe between two plenums (infinite nodes) at several pressure differences and lengths, resolved
+//and lumped, run until it settles. the flow has to be what bernoulli gives it, isentropic out of the upstream
+//plenum with the whole dynamic pressure lost in the downstream one, whatever the length. prints a line per
+//run, false when one is further off than the tolerance (relative)
+bool CheckPlenumFlow(std::ostream& out, double tolerance = 0.01);
+
+//a tank feeding an engine through a pump away from the origin, laid out like the editor's default scene: the
+//pump's ports are found from the world space pipe ends and its local connection points (FindConnectionPoint),
+//its second point is the outlet. exactly that end has to be marked, and in the steady state the outlet side has
+//to sit above the inlet side by at least half the pump's set rise. prints a line, false when it does not hold
+bool CheckPumpOutlet(std::ostream& out);
+
+//runs a scenario file transient with its events for the settling time, then solves the steady state of where it
+//ended up (the tanks and set points it has then). the engines have to take in what the transient feeds them,
+//which holds once the start up transient has died out and the tanks drain slowly. prints a line per engine,
+//false when one is further off than the tolerance (relative) or the scenario cannot be loaded
+bool CheckSteadyAgainstTransient(std::ostream& out, const std::string& scenarioPath, double settlingTime = 30.0, double tolerance = 0.02);
+
+//runs a scenario file transient with its set points for the time, then compiles its layout again and carries
+//the state over (NetworkSimulation::CarryState), with every pipe resolved, lumped and adaptive. run on for the
+//duration, the carried simulation has to take bit for bit the steps of the one that was never replaced. prints
+//a line per fidelity, false when one differs or the scenario cannot be loaded
+bool CheckCarriedState(std::ostream& out, const std::string& scenarioPath, double time = 1.5, double duration = 1.0);
+
+//runs a scenario file transient with its set points for the settling time, then on for the duration both
+//transient and quasi steady (the tanks blowing down through the steady network) from the state it settled in.
+//the mass drawn from each tank has to agree. prints a line per tank, false when one is further off than the
+//tolerance (relative) or the scenario cannot be loaded
+bool CheckBlowdownAgainstTransient(std::ostream& out, const std::string& scenarioPath, double settlingTime = 20.0, double duration = 40.0,
+                                   double tolerance = 0.02);